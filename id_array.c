@@ -0,0 +1,313 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "id_array.h"
+
+#define ID_ARRAY_INITIAL_CAPACITY 4
+/* If one array is this many times bigger than the other, the smaller one
+ * is binary searched in the bigger one instead of merging both. */
+#define ID_ARRAY_SEARCH_RATIO 16
+
+//-----------------------------------------------------------------------//
+//               ID ARRAY: STATIC FUNCTIONS DECLARATIONS                 //
+//-----------------------------------------------------------------------//
+
+static int idArrayLowerBound(const unsigned int* ids, int size,
+                             unsigned int id);
+
+static IdArrayResult idArrayGrow(IdArray array);
+
+//-----------------------------------------------------------------------//
+//                         ID ARRAY: STRUCT                              //
+//-----------------------------------------------------------------------//
+
+struct id_array_t{
+    unsigned int* ids; // Sorted in ascending order, no duplicates.
+    int size;
+    int capacity;
+};
+
+
+//-----------------------------------------------------------------------//
+//                        ID ARRAY: FUNCTIONS                            //
+//-----------------------------------------------------------------------//
+
+/** Rows: 13
+ ***** Function: idArrayCreate *****
+ * Description: Creates a new empty id array.
+ *
+ * @return
+ * A new id array or NULL in case of memory error.
+ */
+IdArray idArrayCreate(){
+    IdArray array = malloc(sizeof(*array));
+    if(!array){
+        return NULL;
+    }
+    array->ids = malloc(ID_ARRAY_INITIAL_CAPACITY*sizeof(unsigned int));
+    if(!array->ids){
+        free(array);
+        return NULL;
+    }
+    array->size = 0;
+    array->capacity = ID_ARRAY_INITIAL_CAPACITY;
+    return array;
+}
+
+/** Rows: 17
+ ***** Function: idArrayCopy *****
+ * Description: Creates a copy of the given id array.
+ *
+ * @param array - Id array to copy.
+ *
+ * @return
+ * A copy of the array or NULL in case of NULL argument or memory error.
+ */
+IdArray idArrayCopy(IdArray array){
+    if(!array){
+        return NULL;
+    }
+    IdArray copy = malloc(sizeof(*copy));
+    if(!copy){
+        return NULL;
+    }
+    copy->ids = malloc((size_t)array->capacity*sizeof(unsigned int));
+    if(!copy->ids){
+        free(copy);
+        return NULL;
+    }
+    memcpy(copy->ids,array->ids,(size_t)array->size*sizeof(unsigned int));
+    copy->size = array->size;
+    copy->capacity = array->capacity;
+    return copy;
+}
+
+/** Rows: 5
+ ***** Function: idArrayDestroy *****
+ * Description: Deallocates an id array.
+ *
+ * @param array - Id array to destroy.
+ */
+void idArrayDestroy(IdArray array){
+    if(!array){
+        return;
+    }
+    free(array->ids);
+    free(array);
+}
+
+/** Rows: 4
+ ***** Function: idArrayGetSize *****
+ * Description: Returns the number of ids in the array.
+ *
+ * @param array - Id array to check.
+ *
+ * @return
+ * Number of ids, or -1 if array is NULL.
+ */
+int idArrayGetSize(IdArray array){
+    if(!array){
+        return -1;
+    }
+    return array->size;
+}
+
+/** Rows: 3
+ ***** Function: idArrayGet *****
+ * Description: Returns the id in the given position. Ids are sorted in
+ * ascending order, so this can be used to go over the ids in order.
+ *
+ * @param array - Id array to get from.
+ * @param position - Position of the id, from 0 to size-1.
+ *
+ * @return
+ * The id in the given position.
+ */
+unsigned int idArrayGet(IdArray array, int position){
+    assert(array && position>=0 && position<array->size);
+    return array->ids[position];
+}
+
+/** Rows: 19
+ ***** Function: idArrayInsert *****
+ * Description: Inserts an id to its place in the array.
+ *
+ * @param array - Id array to insert to.
+ * @param id - Id to insert.
+ *
+ * @return
+ * ID_ARRAY_NULL_ARGUMENT - Array is NULL.
+ * ID_ARRAY_ALREADY_EXISTS - Id is already in the array.
+ * ID_ARRAY_OUT_OF_MEMORY - Failed to grow the array.
+ * ID_ARRAY_SUCCESS - Id inserted.
+ */
+IdArrayResult idArrayInsert(IdArray array, unsigned int id){
+    if(!array){
+        return ID_ARRAY_NULL_ARGUMENT;
+    }
+    int position = idArrayLowerBound(array->ids,array->size,id);
+    if(position<array->size && array->ids[position]==id){
+        return ID_ARRAY_ALREADY_EXISTS;
+    }
+    if(array->size==array->capacity){
+        if(idArrayGrow(array)!=ID_ARRAY_SUCCESS){
+            return ID_ARRAY_OUT_OF_MEMORY;
+        }
+    }
+    /* Making room for the new id. */
+    memmove(array->ids+position+1,array->ids+position,
+            (size_t)(array->size-position)*sizeof(unsigned int));
+    array->ids[position] = id;
+    array->size++;
+    return ID_ARRAY_SUCCESS;
+}
+
+/** Rows: 13
+ ***** Function: idArrayRemove *****
+ * Description: Removes an id from the array.
+ *
+ * @param array - Id array to remove from.
+ * @param id - Id to remove.
+ *
+ * @return
+ * ID_ARRAY_NULL_ARGUMENT - Array is NULL.
+ * ID_ARRAY_DOES_NOT_EXIST - Id is not in the array.
+ * ID_ARRAY_SUCCESS - Id removed.
+ */
+IdArrayResult idArrayRemove(IdArray array, unsigned int id){
+    if(!array){
+        return ID_ARRAY_NULL_ARGUMENT;
+    }
+    int position = idArrayLowerBound(array->ids,array->size,id);
+    if(position==array->size || array->ids[position]!=id){
+        return ID_ARRAY_DOES_NOT_EXIST;
+    }
+    memmove(array->ids+position,array->ids+position+1,
+            (size_t)(array->size-position-1)*sizeof(unsigned int));
+    array->size--;
+    return ID_ARRAY_SUCCESS;
+}
+
+/** Rows: 5
+ ***** Function: idArrayContains *****
+ * Description: Returns whether an id is in the array. Takes O(log n).
+ *
+ * @param array - Id array to search in.
+ * @param id - Id to search for.
+ *
+ * @return
+ * True - Id is in the array.
+ * False - Id is not in the array (or NULL argument).
+ */
+bool idArrayContains(IdArray array, unsigned int id){
+    if(!array){
+        return false;
+    }
+    int position = idArrayLowerBound(array->ids,array->size,id);
+    return position<array->size && array->ids[position]==id;
+}
+
+/** Rows: 35
+ ***** Function: idArrayIntersectionSize *****
+ * Description: Returns how many ids are in both arrays. If one array is
+ * much smaller than the other, its ids are binary searched in the bigger
+ * one. Otherwise both arrays are merged in one pass.
+ *
+ * @param array1 - First id array.
+ * @param array2 - Second id array.
+ *
+ * @return
+ * Number of common ids, or 0 if one of the arrays is NULL.
+ */
+int idArrayIntersectionSize(IdArray array1, IdArray array2){
+    if(!array1 || !array2){
+        return 0;
+    }
+    IdArray small = array1->size<=array2->size ? array1 : array2;
+    IdArray big = small==array1 ? array2 : array1;
+    int common = 0;
+    if(small->size*ID_ARRAY_SEARCH_RATIO < big->size){
+        /* Searching each id of the small array in the big one. The ids
+         * are sorted, so every search starts where the previous ended. */
+        int start = 0;
+        for(int i=0;i<small->size && start<big->size;i++){
+            start += idArrayLowerBound(big->ids+start,big->size-start,
+                                       small->ids[i]);
+            if(start<big->size && big->ids[start]==small->ids[i]){
+                common++;
+                start++;
+            }
+        }
+        return common;
+    }
+    /* Arrays of similar size - merging. */
+    int i = 0, j = 0;
+    while(i<small->size && j<big->size){
+        if(small->ids[i]<big->ids[j]){
+            i++;
+        } else if(small->ids[i]>big->ids[j]){
+            j++;
+        } else {
+            common++;
+            i++;
+            j++;
+        }
+    }
+    return common;
+}
+
+
+//-----------------------------------------------------------------------//
+//                      ID ARRAY: STATIC FUNCTIONS                       //
+//-----------------------------------------------------------------------//
+
+/** Rows: 11
+ ***** Static function: idArrayLowerBound *****
+ * Description: Binary search for the first position in a sorted array
+ * that holds an id which is not smaller than the given id.
+ *
+ * @param ids - Sorted array of ids.
+ * @param size - Number of ids in the array.
+ * @param id - Id to search for.
+ *
+ * @return
+ * Position of the id if it is in the array, else the position it should
+ * be inserted to (size if it is bigger than all the ids).
+ */
+static int idArrayLowerBound(const unsigned int* ids, int size,
+                             unsigned int id){
+    int low = 0;
+    int high = size;
+    while(low<high){
+        int middle = low+(high-low)/2;
+        if(ids[middle]<id){
+            low = middle+1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/** Rows: 9
+ ***** Static function: idArrayGrow *****
+ * Description: Doubles the capacity of the array.
+ *
+ * @param array - Id array to grow.
+ *
+ * @return
+ * ID_ARRAY_OUT_OF_MEMORY - Memory allocation failed, the array is left
+ * unchanged.
+ * ID_ARRAY_SUCCESS - Array grew.
+ */
+static IdArrayResult idArrayGrow(IdArray array){
+    int new_capacity = array->capacity*2;
+    unsigned int* new_ids = realloc(array->ids,
+                              (size_t)new_capacity*sizeof(unsigned int));
+    if(!new_ids){
+        return ID_ARRAY_OUT_OF_MEMORY;
+    }
+    array->ids = new_ids;
+    array->capacity = new_capacity;
+    return ID_ARRAY_SUCCESS;
+}
@@ -0,0 +1,140 @@
+#ifndef MTM_EX3_MTMFLIX_ID_ARRAY_H
+#define MTM_EX3_MTMFLIX_ID_ARRAY_H
+
+#include <stdbool.h>
+
+//-----------------------------------------------------------------------//
+//                   ID ARRAY: TYPEDEFS AND DEFINES                      //
+//-----------------------------------------------------------------------//
+
+/**
+ * Id array: a growable array of distinct ids kept in ascending order.
+ * Membership is checked with binary search and two arrays are intersected
+ * without any allocation, so it is used for sets of user ids that are
+ * read much more often than they are changed.
+ */
+
+typedef struct id_array_t* IdArray;
+
+typedef enum {
+    ID_ARRAY_SUCCESS,
+    ID_ARRAY_OUT_OF_MEMORY,
+    ID_ARRAY_NULL_ARGUMENT,
+    ID_ARRAY_ALREADY_EXISTS,
+    ID_ARRAY_DOES_NOT_EXIST
+} IdArrayResult;
+
+
+//-----------------------------------------------------------------------//
+//                   ID ARRAY: FUNCTIONS DECLARATIONS                    //
+//-----------------------------------------------------------------------//
+
+/**
+ ***** Function: idArrayCreate *****
+ * Description: Creates a new empty id array.
+ *
+ * @return
+ * A new id array or NULL in case of memory error.
+ */
+IdArray idArrayCreate();
+
+/**
+ ***** Function: idArrayCopy *****
+ * Description: Creates a copy of the given id array.
+ *
+ * @param array - Id array to copy.
+ *
+ * @return
+ * A copy of the array or NULL in case of NULL argument or memory error.
+ */
+IdArray idArrayCopy(IdArray array);
+
+/**
+ ***** Function: idArrayDestroy *****
+ * Description: Deallocates an id array.
+ *
+ * @param array - Id array to destroy.
+ */
+void idArrayDestroy(IdArray array);
+
+/**
+ ***** Function: idArrayGetSize *****
+ * Description: Returns the number of ids in the array.
+ *
+ * @param array - Id array to check.
+ *
+ * @return
+ * Number of ids, or -1 if array is NULL.
+ */
+int idArrayGetSize(IdArray array);
+
+/**
+ ***** Function: idArrayGet *****
+ * Description: Returns the id in the given position. Ids are sorted in
+ * ascending order, so this can be used to go over the ids in order.
+ *
+ * @param array - Id array to get from.
+ * @param position - Position of the id, from 0 to size-1.
+ *
+ * @return
+ * The id in the given position.
+ */
+unsigned int idArrayGet(IdArray array, int position);
+
+/**
+ ***** Function: idArrayInsert *****
+ * Description: Inserts an id to its place in the array.
+ *
+ * @param array - Id array to insert to.
+ * @param id - Id to insert.
+ *
+ * @return
+ * ID_ARRAY_NULL_ARGUMENT - Array is NULL.
+ * ID_ARRAY_ALREADY_EXISTS - Id is already in the array.
+ * ID_ARRAY_OUT_OF_MEMORY - Failed to grow the array.
+ * ID_ARRAY_SUCCESS - Id inserted.
+ */
+IdArrayResult idArrayInsert(IdArray array, unsigned int id);
+
+/**
+ ***** Function: idArrayRemove *****
+ * Description: Removes an id from the array.
+ *
+ * @param array - Id array to remove from.
+ * @param id - Id to remove.
+ *
+ * @return
+ * ID_ARRAY_NULL_ARGUMENT - Array is NULL.
+ * ID_ARRAY_DOES_NOT_EXIST - Id is not in the array.
+ * ID_ARRAY_SUCCESS - Id removed.
+ */
+IdArrayResult idArrayRemove(IdArray array, unsigned int id);
+
+/**
+ ***** Function: idArrayContains *****
+ * Description: Returns whether an id is in the array. Takes O(log n).
+ *
+ * @param array - Id array to search in.
+ * @param id - Id to search for.
+ *
+ * @return
+ * True - Id is in the array.
+ * False - Id is not in the array (or NULL argument).
+ */
+bool idArrayContains(IdArray array, unsigned int id);
+
+/**
+ ***** Function: idArrayIntersectionSize *****
+ * Description: Returns how many ids are in both arrays. If one array is
+ * much smaller than the other, its ids are binary searched in the bigger
+ * one. Otherwise both arrays are merged in one pass.
+ *
+ * @param array1 - First id array.
+ * @param array2 - Second id array.
+ *
+ * @return
+ * Number of common ids, or 0 if one of the arrays is NULL.
+ */
+int idArrayIntersectionSize(IdArray array1, IdArray array2);
+
+#endif //MTM_EX3_MTMFLIX_ID_ARRAY_H
@@ -0,0 +1,111 @@
+#include <stdlib.h>
+#include "id_index.h"
+
+#define ID_INDEX_INITIAL_CAPACITY 16
+
+//-----------------------------------------------------------------------//
+//                         ID INDEX: STRUCT                              //
+//-----------------------------------------------------------------------//
+
+struct id_index_t{
+    IdIndexElement* elements; // NULL marks an id that is not mapped.
+    unsigned int capacity;
+};
+
+
+//-----------------------------------------------------------------------//
+//                        ID INDEX: FUNCTIONS                            //
+//-----------------------------------------------------------------------//
+
+/** Rows: 13
+ ***** Function: idIndexCreate *****
+ * Description: Creates a new empty id index.
+ *
+ * @return
+ * A new id index or NULL in case of memory error.
+ */
+IdIndex idIndexCreate(){
+    IdIndex index = malloc(sizeof(*index));
+    if(!index){
+        return NULL;
+    }
+    index->elements = calloc(ID_INDEX_INITIAL_CAPACITY,
+                             sizeof(IdIndexElement));
+    if(!index->elements){
+        free(index);
+        return NULL;
+    }
+    index->capacity = ID_INDEX_INITIAL_CAPACITY;
+    return index;
+}
+
+/** Rows: 5
+ ***** Function: idIndexDestroy *****
+ * Description: Deallocates the index. The elements are not deallocated.
+ *
+ * @param index - Id index to destroy.
+ */
+void idIndexDestroy(IdIndex index){
+    if(!index){
+        return;
+    }
+    free(index->elements);
+    free(index);
+}
+
+/** Rows: 21
+ ***** Function: idIndexPut *****
+ * Description: Maps an id to an element, replacing the element it was
+ * mapped to before.
+ *
+ * @param index - Id index to put in.
+ * @param id - Id of the element.
+ * @param element - Element to map the id to. NULL removes the mapping.
+ *
+ * @return
+ * ID_INDEX_NULL_ARGUMENT - Index is NULL.
+ * ID_INDEX_OUT_OF_MEMORY - Failed to grow the index.
+ * ID_INDEX_SUCCESS - Id mapped.
+ */
+IdIndexResult idIndexPut(IdIndex index, unsigned int id,
+                         IdIndexElement element){
+    if(!index){
+        return ID_INDEX_NULL_ARGUMENT;
+    }
+    if(id>=index->capacity){
+        unsigned int new_capacity = index->capacity;
+        while(id>=new_capacity){
+            new_capacity *= 2;
+        }
+        IdIndexElement* new_elements = realloc(index->elements,
+                                new_capacity*sizeof(IdIndexElement));
+        if(!new_elements){
+            return ID_INDEX_OUT_OF_MEMORY;
+        }
+        /* The new ids are not mapped. */
+        for(unsigned int i=index->capacity;i<new_capacity;i++){
+            new_elements[i] = NULL;
+        }
+        index->elements = new_elements;
+        index->capacity = new_capacity;
+    }
+    index->elements[id] = element;
+    return ID_INDEX_SUCCESS;
+}
+
+/** Rows: 4
+ ***** Function: idIndexGet *****
+ * Description: Returns the element an id is mapped to. Takes O(1).
+ *
+ * @param index - Id index to search in.
+ * @param id - Id to search for.
+ *
+ * @return
+ * The element or NULL if the id is not mapped (or NULL argument).
+ */
+IdIndexElement idIndexGet(IdIndex index, unsigned int id){
+    if(!index || id>=index->capacity){
+        return NULL;
+    }
+    return index->elements[id];
+}
@@ -0,0 +1,77 @@
+#ifndef MTM_EX3_MTMFLIX_ID_INDEX_H
+#define MTM_EX3_MTMFLIX_ID_INDEX_H
+
+//-----------------------------------------------------------------------//
+//                   ID INDEX: TYPEDEFS AND DEFINES                      //
+//-----------------------------------------------------------------------//
+
+/**
+ * Id index: maps small integer ids to elements using a growable array, so
+ * a lookup is a single array access. Ids should be given densely (for
+ * example by a counter), since the array grows up to the biggest id.
+ *
+ * The index does not own its elements.
+ */
+
+typedef struct id_index_t* IdIndex;
+
+typedef void* IdIndexElement;
+
+typedef enum {
+    ID_INDEX_SUCCESS,
+    ID_INDEX_OUT_OF_MEMORY,
+    ID_INDEX_NULL_ARGUMENT
+} IdIndexResult;
+
+
+//-----------------------------------------------------------------------//
+//                   ID INDEX: FUNCTIONS DECLARATIONS                    //
+//-----------------------------------------------------------------------//
+
+/**
+ ***** Function: idIndexCreate *****
+ * Description: Creates a new empty id index.
+ *
+ * @return
+ * A new id index or NULL in case of memory error.
+ */
+IdIndex idIndexCreate();
+
+/**
+ ***** Function: idIndexDestroy *****
+ * Description: Deallocates the index. The elements are not deallocated.
+ *
+ * @param index - Id index to destroy.
+ */
+void idIndexDestroy(IdIndex index);
+
+/**
+ ***** Function: idIndexPut *****
+ * Description: Maps an id to an element, replacing the element it was
+ * mapped to before.
+ *
+ * @param index - Id index to put in.
+ * @param id - Id of the element.
+ * @param element - Element to map the id to. NULL removes the mapping.
+ *
+ * @return
+ * ID_INDEX_NULL_ARGUMENT - Index is NULL.
+ * ID_INDEX_OUT_OF_MEMORY - Failed to grow the index.
+ * ID_INDEX_SUCCESS - Id mapped.
+ */
+IdIndexResult idIndexPut(IdIndex index, unsigned int id,
+                         IdIndexElement element);
+
+/**
+ ***** Function: idIndexGet *****
+ * Description: Returns the element an id is mapped to. Takes O(1).
+ *
+ * @param index - Id index to search in.
+ * @param id - Id to search for.
+ *
+ * @return
+ * The element or NULL if the id is not mapped (or NULL argument).
+ */
+IdIndexElement idIndexGet(IdIndex index, unsigned int id);
+
+#endif //MTM_EX3_MTMFLIX_ID_INDEX_H
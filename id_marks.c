@@ -0,0 +1,111 @@
+#include <stdlib.h>
+#include <assert.h>
+#include "id_marks.h"
+
+//-----------------------------------------------------------------------//
+//                         ID MARKS: STRUCT                              //
+//-----------------------------------------------------------------------//
+
+struct id_marks_t{
+    unsigned int* rounds; // The last round each id was marked in.
+    unsigned int capacity;
+    unsigned int round; // Current round. 0 is never a round.
+};
+
+
+//-----------------------------------------------------------------------//
+//                        ID MARKS: FUNCTIONS                            //
+//-----------------------------------------------------------------------//
+
+/** Rows: 9
+ ***** Function: idMarksCreate *****
+ * Description: Creates new id marks with no marked ids.
+ *
+ * @return
+ * New id marks or NULL in case of memory error.
+ */
+IdMarks idMarksCreate(){
+    IdMarks marks = malloc(sizeof(*marks));
+    if(!marks){
+        return NULL;
+    }
+    marks->rounds = NULL;
+    marks->capacity = 0;
+    marks->round = 0;
+    return marks;
+}
+
+/** Rows: 5
+ ***** Function: idMarksDestroy *****
+ * Description: Deallocates id marks.
+ *
+ * @param marks - Id marks to destroy.
+ */
+void idMarksDestroy(IdMarks marks){
+    if(!marks){
+        return;
+    }
+    free(marks->rounds);
+    free(marks);
+}
+
+/** Rows: 25
+ ***** Function: idMarksStartRound *****
+ * Description: Starts a new round, in which no id is marked.
+ *
+ * @param marks - Id marks to start a round in.
+ * @param ids_count - The ids of the round are smaller than this number.
+ *
+ * @return
+ * ID_MARKS_NULL_ARGUMENT - Marks is NULL.
+ * ID_MARKS_OUT_OF_MEMORY - Failed to grow the array of the marks.
+ * ID_MARKS_SUCCESS - Round started.
+ */
+IdMarksResult idMarksStartRound(IdMarks marks, unsigned int ids_count){
+    if(!marks){
+        return ID_MARKS_NULL_ARGUMENT;
+    }
+    if(ids_count>marks->capacity){
+        unsigned int* new_rounds = realloc(marks->rounds,
+                                     ids_count*sizeof(unsigned int));
+        if(!new_rounds){
+            return ID_MARKS_OUT_OF_MEMORY;
+        }
+        /* The new ids were not marked in any round. */
+        for(unsigned int id=marks->capacity;id<ids_count;id++){
+            new_rounds[id] = 0;
+        }
+        marks->rounds = new_rounds;
+        marks->capacity = ids_count;
+    }
+    marks->round++;
+    if(marks->round==0){
+        /* The rounds wrapped around, old marks could be taken as marks of
+         * the new rounds. */
+        for(unsigned int id=0;id<marks->capacity;id++){
+            marks->rounds[id] = 0;
+        }
+        marks->round = 1;
+    }
+    return ID_MARKS_SUCCESS;
+}
+
+/** Rows: 6
+ ***** Function: idMarksMark *****
+ * Description: Marks an id in the current round.
+ *
+ * @param marks - Id marks to mark in.
+ * @param id - Id to mark. Must be smaller than the ids count of the round.
+ *
+ * @return
+ * True - The id was not marked in this round before.
+ * False - The id was already marked in this round.
+ */
+bool idMarksMark(IdMarks marks, unsigned int id){
+    assert(marks && id<marks->capacity);
+    if(marks->rounds[id]==marks->round){
+        return false;
+    }
+    marks->rounds[id] = marks->round;
+    return true;
+}
@@ -0,0 +1,77 @@
+#ifndef MTM_EX3_MTMFLIX_ID_MARKS_H
+#define MTM_EX3_MTMFLIX_ID_MARKS_H
+
+#include <stdbool.h>
+
+//-----------------------------------------------------------------------//
+//                   ID MARKS: TYPEDEFS AND DEFINES                      //
+//-----------------------------------------------------------------------//
+
+/**
+ * Id marks: remembers which ids were already visited in the current round.
+ * Every id has a slot in an array that holds the last round it was marked
+ * in, so marking an id takes O(1) and starting a new round does not clear
+ * the array.
+ *
+ * Different id marks can be used by different threads at the same time,
+ * since nothing is shared between them.
+ */
+
+typedef struct id_marks_t* IdMarks;
+
+typedef enum {
+    ID_MARKS_SUCCESS,
+    ID_MARKS_OUT_OF_MEMORY,
+    ID_MARKS_NULL_ARGUMENT
+} IdMarksResult;
+
+
+//-----------------------------------------------------------------------//
+//                   ID MARKS: FUNCTIONS DECLARATIONS                    //
+//-----------------------------------------------------------------------//
+
+/**
+ ***** Function: idMarksCreate *****
+ * Description: Creates new id marks with no marked ids.
+ *
+ * @return
+ * New id marks or NULL in case of memory error.
+ */
+IdMarks idMarksCreate();
+
+/**
+ ***** Function: idMarksDestroy *****
+ * Description: Deallocates id marks.
+ *
+ * @param marks - Id marks to destroy.
+ */
+void idMarksDestroy(IdMarks marks);
+
+/**
+ ***** Function: idMarksStartRound *****
+ * Description: Starts a new round, in which no id is marked.
+ *
+ * @param marks - Id marks to start a round in.
+ * @param ids_count - The ids of the round are smaller than this number.
+ *
+ * @return
+ * ID_MARKS_NULL_ARGUMENT - Marks is NULL.
+ * ID_MARKS_OUT_OF_MEMORY - Failed to grow the array of the marks.
+ * ID_MARKS_SUCCESS - Round started.
+ */
+IdMarksResult idMarksStartRound(IdMarks marks, unsigned int ids_count);
+
+/**
+ ***** Function: idMarksMark *****
+ * Description: Marks an id in the current round.
+ *
+ * @param marks - Id marks to mark in.
+ * @param id - Id to mark. Must be smaller than the ids count of the round.
+ *
+ * @return
+ * True - The id was not marked in this round before.
+ * False - The id was already marked in this round.
+ */
+bool idMarksMark(IdMarks marks, unsigned int id);
+
+#endif //MTM_EX3_MTMFLIX_ID_MARKS_H
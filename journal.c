@@ -0,0 +1,641 @@
+/* For fsync and fileno, like pthreads a POSIX dependency. */
+#define _POSIX_C_SOURCE 200112L
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <unistd.h>
+#include "journal.h"
+
+#define JOURNAL_MAGIC "MFJ1"
+#define JOURNAL_HEADER_SIZE 8 // The magic, then the generation.
+#define JOURNAL_MAX_NUMBER_SIZE 5 // Bytes of an encoded 32 bit number.
+#define JOURNAL_CHECKSUM_SIZE 4
+#define JOURNAL_INITIAL_SIZE 4096
+/* The smallest record: its size, the operation and the numbers of names
+ * and values, and the checksum. */
+#define JOURNAL_MIN_RECORD_SIZE (1+3+JOURNAL_CHECKSUM_SIZE)
+
+//-----------------------------------------------------------------------//
+//                JOURNAL: STATIC FUNCTIONS DECLARATIONS                 //
+//-----------------------------------------------------------------------//
+
+static bool journalReserve(Journal journal, size_t size);
+
+static unsigned char* encodeNumber(unsigned char* position, uint32_t number);
+
+static bool decodeNumber(const unsigned char** position,
+                         const unsigned char* end, uint32_t* number);
+
+static void encodeWord(unsigned char* position, uint32_t word);
+
+static uint32_t decodeWord(const unsigned char* position);
+
+static uint32_t getChecksum(const unsigned char* data, size_t size);
+
+static bool decodeRecord(const unsigned char* position,
+                         const unsigned char* end, JournalRecord* record);
+
+static JournalResult decodeRecords(const unsigned char* position,
+                                   const unsigned char* end,
+                                   JournalRecord* records, int* records_num);
+
+static bool isZeroed(const unsigned char* position, const unsigned char* end);
+
+static unsigned char* readWholeFile(FILE* file, size_t* size);
+
+//-----------------------------------------------------------------------//
+//                           JOURNAL: STRUCT                             //
+//-----------------------------------------------------------------------//
+
+struct journal_t{
+    FILE* file;
+    long committed; // Size of the file, up to the last commit.
+    unsigned char* buffer; // Encoded records that were not written yet.
+    size_t size; // Number of bytes in the buffer.
+    size_t prepared_size; // Size of the record prepared after them, or 0.
+    size_t allocated;
+    int pending; // Number of records in the buffer.
+    int commit_every; // The buffer is written when it has this many.
+    int records_num; // Records added since the journal was created.
+};
+
+
+//-----------------------------------------------------------------------//
+//                          JOURNAL: FUNCTIONS                           //
+//-----------------------------------------------------------------------//
+
+/** Rows: 30
+ ***** Function: journalCreate *****
+ * Description: Creates a new empty journal file, in place of the file
+ * that was at the given path.
+ *
+ * @param path - Path of the journal file.
+ * @param generation - Generation of the checkpoint the journal continues.
+ * @param commit_every - Number of records that are written together.
+ *
+ * @return
+ * A new journal or NULL in case of memory error, a file that could not be
+ * created, or commit_every smaller than 1.
+ */
+Journal journalCreate(const char* path, unsigned int generation,
+                      int commit_every){
+    if(!path || commit_every<1){
+        return NULL;
+    }
+    Journal journal = malloc(sizeof(*journal));
+    if(!journal){
+        return NULL;
+    }
+    journal->buffer = malloc(JOURNAL_INITIAL_SIZE);
+    journal->file = journal->buffer ? fopen(path,"wb") : NULL;
+    unsigned char header[JOURNAL_HEADER_SIZE];
+    memcpy(header,JOURNAL_MAGIC,4);
+    encodeWord(header+4,(uint32_t)generation);
+    if(!journal->file || fwrite(header,1,JOURNAL_HEADER_SIZE,
+                                journal->file)!=JOURNAL_HEADER_SIZE ||
+       fflush(journal->file)!=0 || fsync(fileno(journal->file))!=0){
+        if(journal->file){
+            fclose(journal->file);
+        }
+        free(journal->buffer);
+        free(journal);
+        return NULL;
+    }
+    journal->committed = JOURNAL_HEADER_SIZE;
+    journal->size = 0;
+    journal->prepared_size = 0;
+    journal->allocated = JOURNAL_INITIAL_SIZE;
+    journal->pending = 0;
+    journal->commit_every = commit_every;
+    journal->records_num = 0;
+    return journal;
+}
+
+/** Rows: 11
+ ***** Function: journalDestroy *****
+ * Description: Writes the records that were not committed yet, closes the
+ * journal file and deallocates the journal.
+ *
+ * @param journal - Journal to destroy.
+ *
+ * @return
+ * JOURNAL_WRITE_FAILED - Failed to write the records to the file.
+ * JOURNAL_SUCCESS - Journal destroyed, or it is NULL.
+ */
+JournalResult journalDestroy(Journal journal){
+    if(!journal){
+        return JOURNAL_SUCCESS;
+    }
+    JournalResult result = journalCommit(journal);
+    if(fclose(journal->file)!=0){
+        result = JOURNAL_WRITE_FAILED;
+    }
+    free(journal->buffer);
+    free(journal);
+    return result;
+}
+
+/** Rows: 8
+ ***** Function: journalAppend *****
+ * Description: Adds a record to the journal. The records are written to
+ * the file when enough of them were added since the last commit.
+ *
+ * @param journal - Journal to add to.
+ * @param record - Record to add.
+ *
+ * @return
+ * JOURNAL_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * JOURNAL_OUT_OF_MEMORY - Any memory error.
+ * JOURNAL_WRITE_FAILED - Failed to write the records to the file. The
+ * record was added, and is written by the next commit.
+ * JOURNAL_SUCCESS - Record added.
+ */
+JournalResult journalAppend(Journal journal, const JournalRecord* record){
+    JournalResult result = journalPrepare(journal,record);
+    if(result!=JOURNAL_SUCCESS){
+        return result;
+    }
+    return journalAppendPrepared(journal);
+}
+
+/** Rows: 43
+ ***** Function: journalPrepare *****
+ * Description: Encodes a record after the records of the journal, without
+ * adding it yet. A record is its size, then the operation, the number of
+ * names and the number of values (a byte each), the names with their
+ * sizes, the values, and the checksum of all but the size.
+ *
+ * @param journal - Journal to prepare the record in.
+ * @param record - Record to prepare.
+ *
+ * @return
+ * JOURNAL_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * JOURNAL_OUT_OF_MEMORY - Any memory error.
+ * JOURNAL_SUCCESS - Record prepared.
+ */
+JournalResult journalPrepare(Journal journal, const JournalRecord* record){
+    if(!journal || !record){
+        return JOURNAL_NULL_ARGUMENT;
+    }
+    assert(record->names_num<=JOURNAL_MAX_NAMES);
+    assert(record->values_num<=JOURNAL_MAX_VALUES);
+    size_t max_size = 3+JOURNAL_MAX_NUMBER_SIZE*(record->values_num+1)+
+                      JOURNAL_CHECKSUM_SIZE;
+    for(int i=0;i<record->names_num;i++){
+        max_size += JOURNAL_MAX_NUMBER_SIZE+strlen(record->names[i])+1;
+    }
+    if(!journalReserve(journal,max_size)){
+        return JOURNAL_OUT_OF_MEMORY;
+    }
+    /* The payload is encoded after room for its size, then moved to right
+     * after the size once it is known. */
+    unsigned char* start = journal->buffer+journal->size;
+    unsigned char* payload = start+JOURNAL_MAX_NUMBER_SIZE;
+    unsigned char* position = payload;
+    *position++ = (unsigned char)record->operation;
+    *position++ = (unsigned char)record->names_num;
+    *position++ = (unsigned char)record->values_num;
+    for(int i=0;i<record->names_num;i++){
+        size_t name_size = strlen(record->names[i])+1; // With the '\0'.
+        position = encodeNumber(position,(uint32_t)name_size);
+        memcpy(position,record->names[i],name_size);
+        position += name_size;
+    }
+    for(int i=0;i<record->values_num;i++){
+        /* Zigzag, so small negative numbers are small too. */
+        uint32_t value = (uint32_t)record->values[i];
+        position = encodeNumber(position,record->values[i]<0 ?
+                                         ~(value<<1) : value<<1);
+    }
+    size_t payload_size = (size_t)(position-payload);
+    unsigned char* payload_start = encodeNumber(start,(uint32_t)payload_size);
+    memmove(payload_start,payload,payload_size);
+    encodeWord(payload_start+payload_size,
+               getChecksum(payload_start,payload_size));
+    journal->prepared_size = (size_t)(payload_start+payload_size-start)+
+                             JOURNAL_CHECKSUM_SIZE;
+    return JOURNAL_SUCCESS;
+}
+
+/** Rows: 14
+ ***** Function: journalAppendPrepared *****
+ * Description: Adds the record that was prepared last to the journal. It
+ * needs no memory, so a change can be made between preparing its record
+ * and adding it. The records are written to the file when enough of them
+ * were added since the last commit.
+ *
+ * @param journal - Journal to add to. Has a prepared record.
+ *
+ * @return
+ * JOURNAL_NULL_ARGUMENT - Journal is NULL.
+ * JOURNAL_WRITE_FAILED - Failed to write the records to the file. The
+ * record was added, and is written by the next commit.
+ * JOURNAL_SUCCESS - Record added.
+ */
+JournalResult journalAppendPrepared(Journal journal){
+    if(!journal){
+        return JOURNAL_NULL_ARGUMENT;
+    }
+    assert(journal->prepared_size>0);
+    journal->size += journal->prepared_size;
+    journal->prepared_size = 0;
+    journal->pending++;
+    journal->records_num++;
+    if(journal->pending>=journal->commit_every){
+        return journalCommit(journal);
+    }
+    return JOURNAL_SUCCESS;
+}
+
+/** Rows: 19
+ ***** Function: journalCommit *****
+ * Description: Writes the records that were not committed yet to the
+ * journal file, and flushes it to the disk. The records are taken out of
+ * the journal only once they are on the disk. If writing them fails, the
+ * file is set back to its size after the last commit, so the next commit
+ * writes them again in place of what was partly written. A prepared
+ * record that was not added is dropped.
+ *
+ * @param journal - Journal to commit.
+ *
+ * @return
+ * JOURNAL_NULL_ARGUMENT - Journal is NULL.
+ * JOURNAL_WRITE_FAILED - Failed to write the records to the file.
+ * JOURNAL_SUCCESS - Records written.
+ */
+JournalResult journalCommit(Journal journal){
+    if(!journal){
+        return JOURNAL_NULL_ARGUMENT;
+    }
+    journal->prepared_size = 0;
+    if(journal->size==0){
+        return JOURNAL_SUCCESS;
+    }
+    if(fwrite(journal->buffer,1,journal->size,journal->file)!=journal->size ||
+       fflush(journal->file)!=0 || fsync(fileno(journal->file))!=0){
+        clearerr(journal->file);
+        fseek(journal->file,journal->committed,SEEK_SET);
+        return JOURNAL_WRITE_FAILED;
+    }
+    journal->committed += (long)journal->size;
+    journal->size = 0;
+    journal->pending = 0;
+    return JOURNAL_SUCCESS;
+}
+
+/** Rows: 4
+ ***** Function: journalGetRecordsNum *****
+ * Description: Returns the number of records that were added to a
+ * journal since it was created.
+ *
+ * @param journal - Journal to check.
+ *
+ * @return
+ * Number of records of the journal.
+ */
+int journalGetRecordsNum(Journal journal){
+    assert(journal);
+    return journal->records_num;
+}
+
+/** Rows: 40
+ ***** Function: journalReplay *****
+ * Description: Reads a journal file at once, decodes all the records in
+ * it, and gives them together to the given function, in the order they
+ * were added. A journal that does not exist, or belongs to another
+ * generation, has no records. A record that was only partly written when
+ * the program stopped ends the journal, but a damaged record before the
+ * end makes it not valid, and then no record is given. The records are
+ * decoded in place, so their names are only valid during the call.
+ *
+ * @param path - Path of the journal file.
+ * @param generation - Generation of the checkpoint the journal should
+ * continue.
+ * @param apply - Function that makes the changes of the records.
+ * @param context - Given to the function with the records.
+ *
+ * @return
+ * JOURNAL_NULL_ARGUMENT - Path or function is NULL.
+ * JOURNAL_OUT_OF_MEMORY - Any memory error.
+ * JOURNAL_BAD_FILE - The file is not a journal, or a record in it is not
+ * valid.
+ * Any other result of the function.
+ * JOURNAL_SUCCESS - All the records were replayed.
+ */
+JournalResult journalReplay(const char* path, unsigned int generation,
+                            applyJournalRecords apply, void* context){
+    if(!path || !apply){
+        return JOURNAL_NULL_ARGUMENT;
+    }
+    FILE* file = fopen(path,"rb");
+    if(!file){
+        /* No journal was written yet. */
+        return JOURNAL_SUCCESS;
+    }
+    size_t size = 0;
+    unsigned char* data = readWholeFile(file,&size);
+    bool read_failed = ferror(file)!=0;
+    fclose(file);
+    if(!data){
+        return read_failed ? JOURNAL_BAD_FILE : JOURNAL_OUT_OF_MEMORY;
+    }
+    JournalResult result = JOURNAL_SUCCESS;
+    if(size>=JOURNAL_HEADER_SIZE && memcmp(data,JOURNAL_MAGIC,4)!=0){
+        result = JOURNAL_BAD_FILE;
+    }
+    /* A journal without a whole header was never committed to. */
+    if(result!=JOURNAL_SUCCESS || size<JOURNAL_HEADER_SIZE ||
+       decodeWord(data+4)!=(uint32_t)generation){
+        free(data);
+        return result;
+    }
+    JournalRecord* records = malloc(sizeof(*records)*
+            ((size-JOURNAL_HEADER_SIZE)/JOURNAL_MIN_RECORD_SIZE+1));
+    int records_num = 0;
+    result = records ? decodeRecords(data+JOURNAL_HEADER_SIZE,data+size,
+                                     records,&records_num) :
+             JOURNAL_OUT_OF_MEMORY;
+    if(result==JOURNAL_SUCCESS){
+        result = apply(records,records_num,context);
+    }
+    free(records);
+    free(data);
+    return result;
+}
+
+
+//-----------------------------------------------------------------------//
+//                       JOURNAL: STATIC FUNCTIONS                       //
+//-----------------------------------------------------------------------//
+
+/** Rows: 16
+ ***** Static function: journalReserve *****
+ * Description: Makes sure the buffer of a journal has room for the given
+ * number of bytes more.
+ *
+ * @param journal - Journal to make room in.
+ * @param size - Number of bytes needed.
+ *
+ * @return
+ * True if there is room, false in case of memory error.
+ */
+static bool journalReserve(Journal journal, size_t size){
+    if(journal->allocated-journal->size>=size){
+        return true;
+    }
+    size_t allocated = journal->allocated;
+    while(allocated-journal->size<size){
+        allocated *= 2;
+    }
+    unsigned char* buffer = realloc(journal->buffer,allocated);
+    if(!buffer){
+        return false;
+    }
+    journal->buffer = buffer;
+    journal->allocated = allocated;
+    return true;
+}
+
+/** Rows: 7
+ ***** Static function: encodeNumber *****
+ * Description: Encodes a number in 7 bits a byte, the lowest first. The
+ * highest bit of every byte but the last is set.
+ *
+ * @param position - Where to encode. Should have room for
+ * JOURNAL_MAX_NUMBER_SIZE bytes.
+ * @param number - Number to encode.
+ *
+ * @return
+ * Position right after the encoded number.
+ */
+static unsigned char* encodeNumber(unsigned char* position, uint32_t number){
+    while(number>=0x80u){
+        *position++ = (unsigned char)((number&0x7Fu)|0x80u);
+        number >>= 7;
+    }
+    *position++ = (unsigned char)number;
+    return position;
+}
+
+/** Rows: 16
+ ***** Static function: decodeNumber *****
+ * Description: Decodes a number that was encoded by encodeNumber.
+ *
+ * @param position - Where the number starts. Updated to right after it.
+ * @param end - End of the data the number is in.
+ * @param number - Holds the number on success.
+ *
+ * @return
+ * True if a whole number was decoded, else false.
+ */
+static bool decodeNumber(const unsigned char** position,
+                         const unsigned char* end, uint32_t* number){
+    uint32_t decoded = 0;
+    for(int i=0;i<JOURNAL_MAX_NUMBER_SIZE && *position+i<end;i++){
+        unsigned char byte = (*position)[i];
+        decoded |= (uint32_t)(byte&0x7Fu)<<(7*i);
+        if(!(byte&0x80u)){
+            *position += i+1;
+            *number = decoded;
+            return true;
+        }
+    }
+    return false;
+}
+
+/** Rows: 6
+ ***** Static function: encodeWord *****
+ * Description: Encodes a 32 bit word in 4 bytes, the lowest first, so the
+ * journal does not depend on the byte order of the machine.
+ *
+ * @param position - Where to encode.
+ * @param word - Word to encode.
+ */
+static void encodeWord(unsigned char* position, uint32_t word){
+    for(int i=0;i<4;i++){
+        position[i] = (unsigned char)(word>>(8*i));
+    }
+}
+
+/** Rows: 7
+ ***** Static function: decodeWord *****
+ * Description: Decodes a word that was encoded by encodeWord.
+ *
+ * @param position - Where the word starts.
+ *
+ * @return
+ * The word.
+ */
+static uint32_t decodeWord(const unsigned char* position){
+    uint32_t word = 0;
+    for(int i=0;i<4;i++){
+        word |= (uint32_t)position[i]<<(8*i);
+    }
+    return word;
+}
+
+/** Rows: 7
+ ***** Static function: getChecksum *****
+ * Description: Returns the FNV-1a hash of the given data.
+ *
+ * @param data - Data to hash.
+ * @param size - Size of the data in bytes.
+ *
+ * @return
+ * The hash of the data.
+ */
+static uint32_t getChecksum(const unsigned char* data, size_t size){
+    uint32_t hash = 2166136261u;
+    for(size_t i=0;i<size;i++){
+        hash = (hash^data[i])*16777619u;
+    }
+    return hash;
+}
+
+/** Rows: 36
+ ***** Static function: decodeRecord *****
+ * Description: Decodes the payload of a record that was encoded by
+ * journalAppend. The names of the record point into the payload.
+ *
+ * @param position - Where the payload starts.
+ * @param end - Where the payload ends.
+ * @param record - Holds the record on success.
+ *
+ * @return
+ * True if the payload is a valid record, else false.
+ */
+static bool decodeRecord(const unsigned char* position,
+                         const unsigned char* end, JournalRecord* record){
+    if(end-position<3 || position[0]>=JOURNAL_OPERATIONS_NUM ||
+       position[1]>JOURNAL_MAX_NAMES || position[2]>JOURNAL_MAX_VALUES){
+        return false;
+    }
+    record->operation = (JournalOperation)position[0];
+    record->names_num = position[1];
+    record->values_num = position[2];
+    position += 3;
+    for(int i=0;i<record->names_num;i++){
+        uint32_t name_size = 0;
+        if(!decodeNumber(&position,end,&name_size) || name_size==0 ||
+           name_size>(size_t)(end-position) ||
+           memchr(position,'\0',name_size)!=position+name_size-1){
+            /* Every name ends with its only '\0'. */
+            return false;
+        }
+        record->names[i] = (const char*)position;
+        position += name_size;
+    }
+    for(int i=0;i<record->values_num;i++){
+        uint32_t value = 0;
+        if(!decodeNumber(&position,end,&value)){
+            return false;
+        }
+        record->values[i] = (value&1u) ? -(int)(value>>1)-1 :
+                            (int)(value>>1);
+    }
+    return position==end;
+}
+
+/** Rows: 29
+ ***** Static function: decodeRecords *****
+ * Description: Decodes all the records of a journal. The records end
+ * where a record does not fit in what is left of the file, or where a
+ * record is damaged and only zeros follow it: a commit that was not fully
+ * written ends this way. Any other damaged record is reported.
+ *
+ * @param position - Where the first record starts.
+ * @param end - End of the file.
+ * @param records - Holds the records. Has room for every record that fits
+ * in the file.
+ * @param records_num - Holds the number of records.
+ *
+ * @return
+ * JOURNAL_BAD_FILE - A record before the end of the journal is not valid.
+ * JOURNAL_SUCCESS - Records decoded.
+ */
+static JournalResult decodeRecords(const unsigned char* position,
+                                   const unsigned char* end,
+                                   JournalRecord* records, int* records_num){
+    *records_num = 0;
+    while(position<end){
+        uint32_t payload_size = 0;
+        if(!decodeNumber(&position,end,&payload_size)){
+            return end-position<JOURNAL_MAX_NUMBER_SIZE ? JOURNAL_SUCCESS :
+                   JOURNAL_BAD_FILE;
+        }
+        if((size_t)(end-position)<JOURNAL_CHECKSUM_SIZE ||
+           payload_size>(size_t)(end-position)-JOURNAL_CHECKSUM_SIZE){
+            /* The end of the last commit was not written. */
+            return JOURNAL_SUCCESS;
+        }
+        const unsigned char* next = position+payload_size+
+                                    JOURNAL_CHECKSUM_SIZE;
+        if(decodeWord(position+payload_size)!=
+           getChecksum(position,payload_size)){
+            return isZeroed(next,end) ? JOURNAL_SUCCESS : JOURNAL_BAD_FILE;
+        }
+        if(!decodeRecord(position,position+payload_size,
+                         &records[*records_num])){
+            return JOURNAL_BAD_FILE;
+        }
+        (*records_num)++;
+        position = next;
+    }
+    return JOURNAL_SUCCESS;
+}
+
+/** Rows: 7
+ ***** Static function: isZeroed *****
+ * Description: Checks if all the given bytes are zero.
+ *
+ * @param position - Where the bytes start.
+ * @param end - Where the bytes end.
+ *
+ * @return
+ * True if all the bytes are zero, or there are none, else false.
+ */
+static bool isZeroed(const unsigned char* position, const unsigned char* end){
+    while(position<end){
+        if(*position++!=0){
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Rows: 22
+ ***** Static function: readWholeFile *****
+ * Description: Reads a file from its current position to its end.
+ *
+ * @param file - File to read.
+ * @param size - Holds the number of bytes that were read.
+ *
+ * @return
+ * The content of the file, or NULL in case of memory error or a failure
+ * to read the file.
+ */
+static unsigned char* readWholeFile(FILE* file, size_t* size){
+    size_t allocated = JOURNAL_INITIAL_SIZE;
+    unsigned char* data = malloc(allocated);
+    *size = 0;
+    while(data){
+        *size += fread(data+*size,1,allocated-*size,file);
+        if(*size<allocated){
+            break;
+        }
+        unsigned char* bigger = realloc(data,allocated*2);
+        if(!bigger){
+            free(data);
+            return NULL;
+        }
+        data = bigger;
+        allocated *= 2;
+    }
+    if(data && ferror(file)){
+        free(data);
+        return NULL;
+    }
+    return data;
+}
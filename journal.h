@@ -0,0 +1,202 @@
+#ifndef MTM_EX3_MTMFLIX_JOURNAL_H
+#define MTM_EX3_MTMFLIX_JOURNAL_H
+
+#include <stdio.h>
+
+//-----------------------------------------------------------------------//
+//                    JOURNAL: TYPEDEFS AND DEFINES                      //
+//-----------------------------------------------------------------------//
+
+/**
+ * Journal: a file that every change of a mtmflix is appended to, so the
+ * changes can be made again after a crash. Every record is the operation
+ * and its arguments in a compact encoding (lengths and numbers take one
+ * byte when they are small), with a checksum. The records are collected
+ * in memory and written together (group commit), once for every given
+ * number of records or when the journal is committed, and are kept in
+ * memory until they are on the disk. A record can be prepared before the
+ * change it is about is made, and added after it, so a change that was
+ * made is never missing from the journal for lack of memory.
+ *
+ * The journal starts with the generation of the checkpoint it continues,
+ * so a journal that was already taken into a newer checkpoint is not
+ * replayed on top of it. A record that was only partly written when the
+ * program stopped ends the journal, and a damaged record before the end
+ * makes the journal not valid.
+ */
+
+#define JOURNAL_MAX_NAMES 2
+#define JOURNAL_MAX_VALUES 5
+
+typedef struct journal_t* Journal;
+
+typedef enum {
+    JOURNAL_ADD_USER,
+    JOURNAL_REMOVE_USER,
+    JOURNAL_ADD_SERIES,
+    JOURNAL_REMOVE_SERIES,
+    JOURNAL_SERIES_JOIN,
+    JOURNAL_SERIES_LEAVE,
+    JOURNAL_ADD_FRIEND,
+    JOURNAL_REMOVE_FRIEND,
+    JOURNAL_OPERATIONS_NUM
+} JournalOperation;
+
+/* A change and its arguments: the names of the users and series it is
+ * about, and its numbers. */
+typedef struct journal_record_t{
+    JournalOperation operation;
+    const char* names[JOURNAL_MAX_NAMES];
+    int names_num;
+    int values[JOURNAL_MAX_VALUES];
+    int values_num;
+} JournalRecord;
+
+typedef enum {
+    JOURNAL_SUCCESS,
+    JOURNAL_OUT_OF_MEMORY,
+    JOURNAL_WRITE_FAILED,
+    JOURNAL_BAD_FILE,
+    JOURNAL_NULL_ARGUMENT
+} JournalResult;
+
+/** Makes the changes of the replayed records. Gets the records, their
+ * number, and the context that was given to journalReplay. */
+typedef JournalResult(*applyJournalRecords)(const JournalRecord*, int,
+                                            void*);
+
+
+//-----------------------------------------------------------------------//
+//                   JOURNAL: FUNCTIONS DECLARATIONS                     //
+//-----------------------------------------------------------------------//
+
+/**
+ ***** Function: journalCreate *****
+ * Description: Creates a new empty journal file, in place of the file
+ * that was at the given path.
+ *
+ * @param path - Path of the journal file.
+ * @param generation - Generation of the checkpoint the journal continues.
+ * @param commit_every - Number of records that are written together.
+ *
+ * @return
+ * A new journal or NULL in case of memory error, a file that could not be
+ * created, or commit_every smaller than 1.
+ */
+Journal journalCreate(const char* path, unsigned int generation,
+                      int commit_every);
+
+/**
+ ***** Function: journalDestroy *****
+ * Description: Writes the records that were not committed yet, closes the
+ * journal file and deallocates the journal.
+ *
+ * @param journal - Journal to destroy.
+ *
+ * @return
+ * JOURNAL_WRITE_FAILED - Failed to write the records to the file.
+ * JOURNAL_SUCCESS - Journal destroyed, or it is NULL.
+ */
+JournalResult journalDestroy(Journal journal);
+
+/**
+ ***** Function: journalAppend *****
+ * Description: Adds a record to the journal. The records are written to
+ * the file when enough of them were added since the last commit.
+ *
+ * @param journal - Journal to add to.
+ * @param record - Record to add.
+ *
+ * @return
+ * JOURNAL_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * JOURNAL_OUT_OF_MEMORY - Any memory error.
+ * JOURNAL_WRITE_FAILED - Failed to write the records to the file. The
+ * record was added, and is written by the next commit.
+ * JOURNAL_SUCCESS - Record added.
+ */
+JournalResult journalAppend(Journal journal, const JournalRecord* record);
+
+/**
+ ***** Function: journalPrepare *****
+ * Description: Encodes a record after the records of the journal, without
+ * adding it yet. Preparing another record, or committing, drops it.
+ *
+ * @param journal - Journal to prepare the record in.
+ * @param record - Record to prepare.
+ *
+ * @return
+ * JOURNAL_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * JOURNAL_OUT_OF_MEMORY - Any memory error.
+ * JOURNAL_SUCCESS - Record prepared.
+ */
+JournalResult journalPrepare(Journal journal, const JournalRecord* record);
+
+/**
+ ***** Function: journalAppendPrepared *****
+ * Description: Adds the record that was prepared last to the journal. It
+ * needs no memory. The records are written to the file when enough of
+ * them were added since the last commit.
+ *
+ * @param journal - Journal to add to. Has a prepared record.
+ *
+ * @return
+ * JOURNAL_NULL_ARGUMENT - Journal is NULL.
+ * JOURNAL_WRITE_FAILED - Failed to write the records to the file. The
+ * record was added, and is written by the next commit.
+ * JOURNAL_SUCCESS - Record added.
+ */
+JournalResult journalAppendPrepared(Journal journal);
+
+/**
+ ***** Function: journalCommit *****
+ * Description: Writes the records that were not committed yet to the
+ * journal file, and flushes it to the disk. If it fails, the records stay
+ * in the journal and are written by the next commit.
+ *
+ * @param journal - Journal to commit.
+ *
+ * @return
+ * JOURNAL_NULL_ARGUMENT - Journal is NULL.
+ * JOURNAL_WRITE_FAILED - Failed to write the records to the file.
+ * JOURNAL_SUCCESS - Records written.
+ */
+JournalResult journalCommit(Journal journal);
+
+/**
+ ***** Function: journalGetRecordsNum *****
+ * Description: Returns the number of records that were added to a
+ * journal since it was created.
+ *
+ * @param journal - Journal to check.
+ *
+ * @return
+ * Number of records of the journal.
+ */
+int journalGetRecordsNum(Journal journal);
+
+/**
+ ***** Function: journalReplay *****
+ * Description: Reads a journal file at once, decodes all the records in
+ * it, and gives them together to the given function, in the order they
+ * were added. A journal that does not exist, or belongs to another
+ * generation, has no records. If a record is not valid, no record is
+ * given. The names of the records are only valid during the call.
+ *
+ * @param path - Path of the journal file.
+ * @param generation - Generation of the checkpoint the journal should
+ * continue.
+ * @param apply - Function that makes the changes of the records.
+ * @param context - Given to the function with the records.
+ *
+ * @return
+ * JOURNAL_NULL_ARGUMENT - Path or function is NULL.
+ * JOURNAL_OUT_OF_MEMORY - Any memory error.
+ * JOURNAL_BAD_FILE - The file is not a journal, or a record in it is not
+ * valid.
+ * Any other result of the function.
+ * JOURNAL_SUCCESS - All the records were replayed.
+ */
+JournalResult journalReplay(const char* path, unsigned int generation,
+                            applyJournalRecords apply, void* context);
+
+#endif //MTM_EX3_MTMFLIX_JOURNAL_H
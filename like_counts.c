@@ -0,0 +1,284 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "like_counts.h"
+
+#define LIKE_COUNTS_INITIAL_CAPACITY 16
+#define LIKE_COUNTS_NO_POSITION -1
+
+//-----------------------------------------------------------------------//
+//              LIKE COUNTS: STATIC FUNCTIONS DECLARATIONS               //
+//-----------------------------------------------------------------------//
+
+static LikeCountsResult likeCountsGrowPositions(LikeCounts counts,
+                                                unsigned int id);
+
+static LikeCountsResult likeCountsGrowEntries(LikeCounts counts);
+
+//-----------------------------------------------------------------------//
+//                        LIKE COUNTS: STRUCT                            //
+//-----------------------------------------------------------------------//
+
+typedef struct {
+    Series series;
+    int count;
+} LikeCountsEntry;
+
+struct like_counts_t{
+    LikeCountsEntry* entries; // The series with a positive count.
+    int size;
+    int capacity;
+    int* positions; // Position of every series id in entries, or -1.
+    unsigned int ids_capacity; // Number of ids positions has room for.
+};
+
+
+//-----------------------------------------------------------------------//
+//                       LIKE COUNTS: FUNCTIONS                          //
+//-----------------------------------------------------------------------//
+
+/** Rows: 22
+ ***** Function: likeCountsCreate *****
+ * Description: Creates new like counts, where no series is counted.
+ *
+ * @return
+ * New like counts or NULL in case of memory error.
+ */
+LikeCounts likeCountsCreate(){
+    LikeCounts counts = malloc(sizeof(*counts));
+    if(!counts){
+        return NULL;
+    }
+    counts->entries = malloc(LIKE_COUNTS_INITIAL_CAPACITY*
+                             sizeof(LikeCountsEntry));
+    counts->positions = malloc(LIKE_COUNTS_INITIAL_CAPACITY*sizeof(int));
+    if(!counts->entries || !counts->positions){
+        likeCountsDestroy(counts);
+        return NULL;
+    }
+    for(int id=0;id<LIKE_COUNTS_INITIAL_CAPACITY;id++){
+        counts->positions[id] = LIKE_COUNTS_NO_POSITION;
+    }
+    counts->size = 0;
+    counts->capacity = LIKE_COUNTS_INITIAL_CAPACITY;
+    counts->ids_capacity = LIKE_COUNTS_INITIAL_CAPACITY;
+    return counts;
+}
+
+/** Rows: 22
+ ***** Function: likeCountsCopy *****
+ * Description: Creates a copy of the given like counts.
+ *
+ * @param counts - Like counts to copy.
+ *
+ * @return
+ * A copy of the counts or NULL in case of NULL argument or memory error.
+ */
+LikeCounts likeCountsCopy(LikeCounts counts){
+    if(!counts){
+        return NULL;
+    }
+    LikeCounts copy = malloc(sizeof(*copy));
+    if(!copy){
+        return NULL;
+    }
+    copy->entries = malloc((size_t)counts->capacity*sizeof(LikeCountsEntry));
+    copy->positions = malloc(counts->ids_capacity*sizeof(int));
+    if(!copy->entries || !copy->positions){
+        likeCountsDestroy(copy);
+        return NULL;
+    }
+    memcpy(copy->entries,counts->entries,
+           (size_t)counts->size*sizeof(LikeCountsEntry));
+    memcpy(copy->positions,counts->positions,
+           counts->ids_capacity*sizeof(int));
+    copy->size = counts->size;
+    copy->capacity = counts->capacity;
+    copy->ids_capacity = counts->ids_capacity;
+    return copy;
+}
+
+/** Rows: 6
+ ***** Function: likeCountsDestroy *****
+ * Description: Deallocates like counts. The series are not destroyed.
+ *
+ * @param counts - Like counts to destroy.
+ */
+void likeCountsDestroy(LikeCounts counts){
+    if(!counts){
+        return;
+    }
+    free(counts->entries);
+    free(counts->positions);
+    free(counts);
+}
+
+/** Rows: 23
+ ***** Function: likeCountsIncrease *****
+ * Description: Adds one to the count of a series.
+ *
+ * @param counts - Like counts to change.
+ * @param series - Series whose count is increased.
+ *
+ * @return
+ * LIKE_COUNTS_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * LIKE_COUNTS_OUT_OF_MEMORY - Failed to grow the counts, nothing changed.
+ * LIKE_COUNTS_SUCCESS - Count increased.
+ */
+LikeCountsResult likeCountsIncrease(LikeCounts counts, Series series){
+    if(!counts || !series){
+        return LIKE_COUNTS_NULL_ARGUMENT;
+    }
+    unsigned int id = seriesGetId(series);
+    if(id>=counts->ids_capacity &&
+       likeCountsGrowPositions(counts,id)!=LIKE_COUNTS_SUCCESS){
+        return LIKE_COUNTS_OUT_OF_MEMORY;
+    }
+    int position = counts->positions[id];
+    if(position!=LIKE_COUNTS_NO_POSITION){
+        counts->entries[position].count++;
+        return LIKE_COUNTS_SUCCESS;
+    }
+    if(counts->size==counts->capacity &&
+       likeCountsGrowEntries(counts)!=LIKE_COUNTS_SUCCESS){
+        return LIKE_COUNTS_OUT_OF_MEMORY;
+    }
+    counts->entries[counts->size].series = series;
+    counts->entries[counts->size].count = 1;
+    counts->positions[id] = counts->size;
+    counts->size++;
+    return LIKE_COUNTS_SUCCESS;
+}
+
+/** Rows: 15
+ ***** Function: likeCountsDecrease *****
+ * Description: Takes one from the count of a series. A series whose count
+ * drops to 0 is removed. Never allocates memory.
+ *
+ * @param counts - Like counts to change.
+ * @param series - Series whose count is decreased. Its count must be
+ * positive.
+ */
+void likeCountsDecrease(LikeCounts counts, Series series){
+    assert(counts && series);
+    unsigned int id = seriesGetId(series);
+    assert(id<counts->ids_capacity);
+    int position = counts->positions[id];
+    assert(position!=LIKE_COUNTS_NO_POSITION);
+    counts->entries[position].count--;
+    if(counts->entries[position].count>0){
+        return;
+    }
+    /* The last series takes the place of the removed one. */
+    counts->size--;
+    LikeCountsEntry last = counts->entries[counts->size];
+    counts->entries[position] = last;
+    counts->positions[seriesGetId(last.series)] = position;
+    counts->positions[id] = LIKE_COUNTS_NO_POSITION;
+}
+
+/** Rows: 4
+ ***** Function: likeCountsGetSize *****
+ * Description: Returns the number of series with a positive count.
+ *
+ * @param counts - Like counts to check.
+ *
+ * @return
+ * Number of counted series, or -1 if counts is NULL.
+ */
+int likeCountsGetSize(LikeCounts counts){
+    if(!counts){
+        return -1;
+    }
+    return counts->size;
+}
+
+/** Rows: 2
+ ***** Function: likeCountsGetSeries *****
+ * Description: Returns the series in the given position.
+ *
+ * @param counts - Like counts to get from.
+ * @param position - Position of the series, from 0 to size-1.
+ *
+ * @return
+ * The series in the given position.
+ */
+Series likeCountsGetSeries(LikeCounts counts, int position){
+    assert(counts && position>=0 && position<counts->size);
+    return counts->entries[position].series;
+}
+
+/** Rows: 2
+ ***** Function: likeCountsGetCount *****
+ * Description: Returns the count of the series in the given position.
+ *
+ * @param counts - Like counts to get from.
+ * @param position - Position of the series, from 0 to size-1.
+ *
+ * @return
+ * The count of the series in the given position, always positive.
+ */
+int likeCountsGetCount(LikeCounts counts, int position){
+    assert(counts && position>=0 && position<counts->size);
+    return counts->entries[position].count;
+}
+
+
+//-----------------------------------------------------------------------//
+//                     LIKE COUNTS: STATIC FUNCTIONS                     //
+//-----------------------------------------------------------------------//
+
+/** Rows: 17
+ ***** Static function: likeCountsGrowPositions *****
+ * Description: Grows the positions array until it has a slot for the
+ * given id. The new slots hold no position.
+ *
+ * @param counts - Like counts to grow.
+ * @param id - Id that needs a slot.
+ *
+ * @return
+ * LIKE_COUNTS_OUT_OF_MEMORY - Memory allocation failed, the counts are
+ * left unchanged.
+ * LIKE_COUNTS_SUCCESS - Positions grew.
+ */
+static LikeCountsResult likeCountsGrowPositions(LikeCounts counts,
+                                                unsigned int id){
+    unsigned int new_capacity = counts->ids_capacity;
+    while(id>=new_capacity){
+        new_capacity *= 2;
+    }
+    int* new_positions = realloc(counts->positions,
+                                 new_capacity*sizeof(int));
+    if(!new_positions){
+        return LIKE_COUNTS_OUT_OF_MEMORY;
+    }
+    for(unsigned int i=counts->ids_capacity;i<new_capacity;i++){
+        new_positions[i] = LIKE_COUNTS_NO_POSITION;
+    }
+    counts->positions = new_positions;
+    counts->ids_capacity = new_capacity;
+    return LIKE_COUNTS_SUCCESS;
+}
+
+/** Rows: 10
+ ***** Static function: likeCountsGrowEntries *****
+ * Description: Doubles the capacity of the entries array.
+ *
+ * @param counts - Like counts to grow.
+ *
+ * @return
+ * LIKE_COUNTS_OUT_OF_MEMORY - Memory allocation failed, the counts are
+ * left unchanged.
+ * LIKE_COUNTS_SUCCESS - Entries grew.
+ */
+static LikeCountsResult likeCountsGrowEntries(LikeCounts counts){
+    int new_capacity = counts->capacity*2;
+    LikeCountsEntry* new_entries = realloc(counts->entries,
+                            (size_t)new_capacity*sizeof(LikeCountsEntry));
+    if(!new_entries){
+        return LIKE_COUNTS_OUT_OF_MEMORY;
+    }
+    counts->entries = new_entries;
+    counts->capacity = new_capacity;
+    return LIKE_COUNTS_SUCCESS;
+}
@@ -0,0 +1,125 @@
+#ifndef MTM_EX3_MTMFLIX_LIKE_COUNTS_H
+#define MTM_EX3_MTMFLIX_LIKE_COUNTS_H
+
+#include "series.h"
+
+//-----------------------------------------------------------------------//
+//                  LIKE COUNTS: TYPEDEFS AND DEFINES                    //
+//-----------------------------------------------------------------------//
+
+/**
+ * Like counts: counts, for every series, how many times it was liked.
+ * Used to keep how many friends of a user love each series, so the series
+ * do not have to be counted again for every recommendation.
+ *
+ * Only series with a positive count are kept, in an array that can be
+ * gone over by positions. Every series id also has a slot that holds the
+ * position of the series, so changing a count takes O(1). The positions
+ * of the series change when a series is removed.
+ *
+ * The series are not owned, a series must be removed (its count must drop
+ * to 0) before it is destroyed.
+ */
+
+typedef struct like_counts_t* LikeCounts;
+
+typedef enum {
+    LIKE_COUNTS_SUCCESS,
+    LIKE_COUNTS_OUT_OF_MEMORY,
+    LIKE_COUNTS_NULL_ARGUMENT
+} LikeCountsResult;
+
+
+//-----------------------------------------------------------------------//
+//                  LIKE COUNTS: FUNCTIONS DECLARATIONS                  //
+//-----------------------------------------------------------------------//
+
+/**
+ ***** Function: likeCountsCreate *****
+ * Description: Creates new like counts, where no series is counted.
+ *
+ * @return
+ * New like counts or NULL in case of memory error.
+ */
+LikeCounts likeCountsCreate();
+
+/**
+ ***** Function: likeCountsCopy *****
+ * Description: Creates a copy of the given like counts.
+ *
+ * @param counts - Like counts to copy.
+ *
+ * @return
+ * A copy of the counts or NULL in case of NULL argument or memory error.
+ */
+LikeCounts likeCountsCopy(LikeCounts counts);
+
+/**
+ ***** Function: likeCountsDestroy *****
+ * Description: Deallocates like counts. The series are not destroyed.
+ *
+ * @param counts - Like counts to destroy.
+ */
+void likeCountsDestroy(LikeCounts counts);
+
+/**
+ ***** Function: likeCountsIncrease *****
+ * Description: Adds one to the count of a series.
+ *
+ * @param counts - Like counts to change.
+ * @param series - Series whose count is increased.
+ *
+ * @return
+ * LIKE_COUNTS_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * LIKE_COUNTS_OUT_OF_MEMORY - Failed to grow the counts, nothing changed.
+ * LIKE_COUNTS_SUCCESS - Count increased.
+ */
+LikeCountsResult likeCountsIncrease(LikeCounts counts, Series series);
+
+/**
+ ***** Function: likeCountsDecrease *****
+ * Description: Takes one from the count of a series. A series whose count
+ * drops to 0 is removed. Never allocates memory.
+ *
+ * @param counts - Like counts to change.
+ * @param series - Series whose count is decreased. Its count must be
+ * positive.
+ */
+void likeCountsDecrease(LikeCounts counts, Series series);
+
+/**
+ ***** Function: likeCountsGetSize *****
+ * Description: Returns the number of series with a positive count.
+ *
+ * @param counts - Like counts to check.
+ *
+ * @return
+ * Number of counted series, or -1 if counts is NULL.
+ */
+int likeCountsGetSize(LikeCounts counts);
+
+/**
+ ***** Function: likeCountsGetSeries *****
+ * Description: Returns the series in the given position.
+ *
+ * @param counts - Like counts to get from.
+ * @param position - Position of the series, from 0 to size-1.
+ *
+ * @return
+ * The series in the given position.
+ */
+Series likeCountsGetSeries(LikeCounts counts, int position);
+
+/**
+ ***** Function: likeCountsGetCount *****
+ * Description: Returns the count of the series in the given position.
+ *
+ * @param counts - Like counts to get from.
+ * @param position - Position of the series, from 0 to size-1.
+ *
+ * @return
+ * The count of the series in the given position, always positive.
+ */
+int likeCountsGetCount(LikeCounts counts, int position);
+
+#endif //MTM_EX3_MTMFLIX_LIKE_COUNTS_H
@@ -1,18 +1,52 @@
+/* For fsync and fileno, like pthreads a POSIX dependency. */
+#define _POSIX_C_SOURCE 200112L
 #include <stdlib.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
 #include "mtmflix.h"
 #include "map.h"
 #include "series.h"
 #include "utilities.h"
 #include "user.h"
+#include "recommendation_cache.h"
+#include "series_columns.h"
+#include "report_writer.h"
+#include "snapshot.h"
+#include "journal.h"
 
 #define ILLEGAL_VALUE -1
+/* A thread that ranks fewer candidate series than this costs more than
+ * it saves. */
+#define MIN_CANDIDATES_PER_SCORING_THREAD 512
+/* Size of the buffer the reports are written through. */
+#define REPORT_BUFFER_SIZE (64*1024)
+/* Number of users a worker formats at a time in a parallel users report. */
+#define USERS_PER_REPORT_SHARD 256
+/* The details of a user are formatted as mtmPrintUser formats them. It
+ * writes them to a static buffer of USER_DETAILS_BUFFER_SIZE chars and
+ * keeps USER_DETAILS_FIXED_LENGTH of them for the text around the
+ * username: the separator (36), "The user " (9), " is " (4), the age (up
+ * to 11) and " years old\n" (11), with room to spare. So it fails for
+ * usernames longer than 20000-150 = 19850 chars, and the parallel report
+ * does too. */
+#define USER_DETAILS_SEPARATOR "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n"
+#define USER_DETAILS_BUFFER_SIZE 20000
+#define USER_DETAILS_FIXED_LENGTH 150
+#define MAX_USER_DETAILS_USERNAME_LENGTH \
+        (USER_DETAILS_BUFFER_SIZE-USER_DETAILS_FIXED_LENGTH)
+/* Suffixes of the files of a journaled mtmflix. Every checkpoint has its
+ * own journal, the suffix followed by the generation of the checkpoint. */
+#define JOURNAL_FILE_SUFFIX ".journal."
+#define MAX_GENERATION_LENGTH 10
+#define CHECKPOINT_FILE_SUFFIX ".checkpoint"
+#define CHECKPOINT_TEMPORARY_SUFFIX ".checkpoint.tmp"
 
 //-----------------------------------------------------------------------//
 //                MTMFLIX: STATIC FUNCTIONS DECLARATIONS                 //
 //-----------------------------------------------------------------------//
 
-static bool userCanWatchSeries(MtmFlix mtmflix, User user,
-                               Series series,SeriesResult* status);
+static bool userCanWatchSeries(User user, Series series);
 
 static bool nameIsValid(const char *name);
 
@@ -23,26 +57,167 @@ static MtmFlixResult userAndSeriesExist(MtmFlix mtmflix,
                                         const char *username,
                                         const char *seriesName);
 
-static User getUserByUsername(char* username,MtmFlixResult* result,
-                              Set users_set);
+static User getUserByUsername(MtmFlix mtmflix, const char* username,
+                              MtmFlixResult* result);
 
-static void rankSeriesAndAddToRankedSeriesSet(Set users_set,Set series_set,
-  User user,Series series, Genre genre, MtmFlixResult* function_status,
-                                                    Set ranked_series_set);
+typedef struct recommender_t* Recommender;
 
-static double doubleAbs (double number);
+typedef struct candidate_bound_t CandidateBound;
+
+typedef struct scoring_task_t ScoringTask;
+
+typedef struct recommendations_job_t* RecommendationsJob;
+
+typedef struct users_report_job_t* UsersReportJob;
+
+typedef struct report_shard_t ReportShard;
+
+static Recommender recommenderCreate();
+
+static void recommenderDestroy(Recommender recommender);
+
+static MtmFlixResult recommenderPrepare(Recommender recommender,
+                                        int series_num,
+                                        unsigned int ids_count);
+
+static MtmFlixResult recommendToUser(MtmFlix mtmflix, User user,
+                                     int count, int threadsNum,
+                                     FILE* outputStream);
+
+static MtmFlixResult writeSeriesDetails(ReportWriter writer, Series* series,
+                                        int series_num);
 
 static MtmFlixResult rankAllSeriesForUser(MtmFlix mtmflix,User user,
-                                  Set ranked_series_set,FILE* outputStream,
-                                   int count,Set series_set);
+                                  Recommender recommender,int capacity,
+                                  int threadsNum);
+
+static int collectCandidates(MtmFlix mtmflix, User user,
+                             Recommender recommender);
+
+static int collectFriendLikes(LikeCounts friend_likes,
+                              Recommender recommender);
+
+static void countFriendsLoved(User user, Series* candidates,
+                              int* friends_loved, int candidates_num);
+
+static void rankCandidates(MtmFlix mtmflix, User user, Series* candidates,
+                           unsigned int* ids, int* ranks,
+                           int candidates_num, RankedSeries ranked_series);
+
+static void rankCandidatesByBounds(ScoringTask* task);
+
+static void siftCandidateBoundDown(CandidateBound* bounds, int bounds_num,
+                                   int position);
+
+static void getGenreCounts(User user, int* genre_counts);
+
+static MtmFlixResult rankCandidatesInParallel(MtmFlix mtmflix, User user,
+                                              Recommender recommender,
+                                              int candidates_num,
+                                              int capacity, bool prune,
+                                              int threadsNum);
+
+static void* scoringWorker(void* task);
+
+static MtmFlixResult getUsersByUsernames(MtmFlix mtmflix,
+                                         const char** usernames,
+                                         int usersNum, User* users);
+
+static void* recommendationsWorker(void* job);
+
+static MtmFlixResult printJobRecommendations(RecommendationsJob job,
+                                             ReportWriter writer,
+                                             FILE* outputStream);
+
+static void* usersReportWorker(void* job);
+
+static MtmFlixResult formatReportShard(UsersReportJob job, int shard,
+                                       const char** friends_names,
+                                       ReportShard* formatted);
+
+static bool formatUserDetails(MtmFlix mtmflix, User user,
+                              const char** friends_names,
+                              ReportShard* formatted);
+
+static bool appendDetailsLine(ReportShard* shard, const char* title,
+                              const char* name);
+
+static bool appendToReportShard(ReportShard* shard, const char* text);
+
+static MtmFlixResult printReportShards(UsersReportJob job,
+                                       ReportWriter writer,
+                                       FILE* outputStream);
+
+static Snapshot createSnapshot(MtmFlix mtmflix,
+                               unsigned int* user_positions,
+                               unsigned int* series_positions);
+
+static void fillSnapshotSeries(MtmFlix mtmflix, Snapshot snapshot,
+                               size_t* names_end);
+
+static void fillSnapshotUsers(MtmFlix mtmflix, Snapshot snapshot,
+                              size_t names_end,
+                              const unsigned int* user_positions,
+                              const unsigned int* series_positions);
+
+static int compareSnapshotPositions(const void* position1,
+                                    const void* position2);
+
+static MtmFlixResult loadSnapshotSeries(MtmFlix mtmflix, Snapshot snapshot,
+                                        Series* series_by_position);
 
-static bool seriesShouldBeRecommended(Series series,User user,
-                                      MtmFlix mtmflix,
-                                      MtmFlixResult* result);
+static MtmFlixResult loadOneSnapshotSeries(MtmFlix mtmflix, const char* name,
+                                           const SnapshotSeries* record);
 
-static int rankSeries(Set users_set,User user,
-                      char* series_name,Series series,Set series_set,
-                      Genre genre,MtmFlixResult* function_status);
+static MtmFlixResult loadSnapshotUsers(MtmFlix mtmflix, Snapshot snapshot,
+                                       Series* series_by_position);
+
+static MtmFlixResult loadOneSnapshotUser(MtmFlix mtmflix, const char* name,
+                                         uint32_t age);
+
+static MtmFlixResult loadSnapshotFriends(MtmFlix mtmflix, Snapshot snapshot);
+
+static MtmFlixResult loadSnapshotFavorites(Snapshot snapshot, User user,
+                                           Series* series_by_position,
+                                           uint32_t start, uint32_t end);
+
+static MtmFlixResult prepareJournalChange(MtmFlix mtmflix,
+                                          JournalOperation operation,
+                                          const char* name1,
+                                          const char* name2,
+                                          const int* values, int values_num);
+
+static MtmFlixResult addJournalChange(MtmFlix mtmflix);
+
+static MtmFlixResult loadCheckpoint(const char* path, MtmFlix* mtmflix,
+                                    unsigned int* generation);
+
+static MtmFlixResult replayJournal(MtmFlix mtmflix, const char* path,
+                                   unsigned int generation);
+
+static JournalResult applyJournalChanges(const JournalRecord* records,
+                                         int records_num, void* context);
+
+static MtmFlixResult applyJournalChange(MtmFlix mtmflix,
+                                        const JournalRecord* record);
+
+static bool journalChangeIsValid(const JournalRecord* record);
+
+static MtmFlixResult writeCheckpoint(MtmFlix mtmflix);
+
+static MtmFlixResult saveCheckpoint(MtmFlix mtmflix,
+                                    const char* temporary_path,
+                                    const char* checkpoint_path,
+                                    unsigned int generation);
+
+static char* createFilePath(const char* path, const char* suffix);
+
+static char* createJournalFilePath(const char* path,
+                                   unsigned int generation);
+
+static OrderedArray getGenreSeries(MtmFlix mtmflix, Genre genre);
+
+static int getRecommendationsCapacity(MtmFlix mtmflix, int count);
 
 
 //-----------------------------------------------------------------------//
@@ -50,8 +225,112 @@ static int rankSeries(Set users_set,User user,
 //-----------------------------------------------------------------------//
 
 struct mtmFlix_t{
-    Set users;
-    Set series;
+    OrderedArray users; // Users sorted by username, for ordered iteration.
+    /* Series of each genre sorted by name. The genres are in the order
+     * of their positions, so going over them gives all the series sorted
+     * by genre and name. */
+    OrderedArray series[NUMBER_OF_GENRES];
+    NameIndex users_index; // Owns the users. Lookup by username.
+    NameIndex series_index; // Owns the series. Lookup by series name.
+    IdIndex users_by_id; // Users by id, for printing friends' names.
+    unsigned int next_user_id; // Id that will be given to the next user.
+    StringPool names; // Interned usernames and series names.
+    Slab users_slab; // Memory of the users.
+    Slab series_slab; // Memory of the series.
+    SeriesColumns series_columns; // Fields of the series by id, for ranking.
+    unsigned int next_series_id; // Id that will be given to the next series.
+    Recommender recommender; // Reused by every recommendation of one user.
+    /* Printed recommendations, NULL if they are not cached. Used only by
+     * the calls that print from one thread. */
+    RecommendationCache recommendations_cache;
+    /* Buffers what is printed. Used only by the thread that prints. */
+    ReportWriter report_writer;
+    /* Path the journal and checkpoint files start with, NULL if the
+     * changes are not journaled. */
+    char* journal_path;
+    Journal journal; // Of the last checkpoint, NULL until the first one.
+    unsigned int checkpoint_generation; // Generation of the last one.
+    int commit_every; // Number of changes written to the journal together.
+    int checkpoint_every; // Changes between checkpoints, 0 for never.
+    /* Number of changes in the journal when the next checkpoint is
+     * written. Put off after a checkpoint that failed. */
+    int next_checkpoint;
+    /* A commit of the journal failed, so no change is made until one
+     * succeeds. */
+    bool journal_failed;
+};
+
+/* What ranking the series for one user at a time needs. A thread that
+ * ranks series must have its own recommender, the mtmflix itself is only
+ * read while ranking. */
+struct recommender_t{
+    RankedSeries ranked_series; // Keeps the best series of the user.
+    IdMarks marked_series; // Ids of the series that are candidates.
+    /* The series that should be ranked for the user, their ids and
+     * their ranks. */
+    Series* candidates;
+    unsigned int* candidate_ids;
+    int* candidate_ranks;
+    CandidateBound* candidate_bounds; // A heap of the bounds, best first.
+    int candidates_allocated; // Number of series the arrays have room for.
+};
+
+/* An upper bound of the rank of a candidate series. */
+struct candidate_bound_t{
+    int bound;
+    int candidate; // Position of the series in the candidates.
+};
+
+/* A part of the candidate series of one user, ranked by one thread. */
+struct scoring_task_t{
+    MtmFlix mtmflix;
+    User user;
+    Series* candidates;
+    unsigned int* ids;
+    int* ranks;
+    CandidateBound* bounds; // Room for a bound of every candidate.
+    int candidates_num;
+    RankedSeries ranked_series; // Keeps the best series of this part.
+    bool prune; // Whether candidates are skipped by their bounds.
+    bool in_thread; // Whether a thread was created for this part.
+};
+
+/* The recommendations of one user, as made by a worker thread. */
+typedef struct user_recommendations_t{
+    Series* series; // The best series, best first.
+    int size;
+    MtmFlixResult result;
+    bool ranked; // Whether a worker finished with this user.
+} UserRecommendations;
+
+/* Recommendations for many users, shared by the worker threads. */
+struct recommendations_job_t{
+    MtmFlix mtmflix;
+    User* users;
+    int users_num;
+    int capacity; // Capacity of the ranked series of every user.
+    UserRecommendations* recommendations; // In the order of the users.
+    int next_user; // The next user that no worker took yet.
+    pthread_mutex_t lock; // Guards next_user and the recommendations.
+    pthread_cond_t user_ranked; // Signaled when a worker finished a user.
+};
+
+/* The details of a range of the sorted users, formatted by a worker. */
+struct report_shard_t{
+    char* text; // The details of the users, one after the other.
+    size_t length;
+    size_t allocated;
+    MtmFlixResult result;
+    bool formatted; // Whether a worker finished the shard.
+};
+
+struct users_report_job_t{
+    MtmFlix mtmflix;
+    ReportShard* shards; // In the order of the users.
+    int shards_num;
+    int next_shard; // The next shard that no worker took yet.
+    pthread_mutex_t lock; // Guards next_shard and the shards.
+    pthread_cond_t shard_formatted; // Signaled when a shard is formatted.
 };
 
 
@@ -59,7 +338,7 @@ struct mtmFlix_t{
 //                       MTMFLIX: FUNCTIONS                              //
 //-----------------------------------------------------------------------//
 
-/** Rows: 14
+/** Rows: 39
  ***** mtmFlixCreate *****
  * Description: Creates a new mtmFlix.
  *
@@ -73,25 +352,49 @@ MtmFlix mtmFlixCreate(){
         /* Failed to allocate memory. */
         return NULL;
     }
-    flix->series = setCreate(seriesCopySetElement,seriesDestroySetElement,
-            seriesCompareSetElements);
-    if(!flix->series){
-        /* Failed to allocate memory for the series set. */
-        free(flix);
+    /* The ordered arrays only hold references, the elements are owned by
+     * the indexes. */
+    bool series_created = true;
+    for(int position=0;position<NUMBER_OF_GENRES;position++){
+        flix->series[position] =
+                orderedArrayCreate(seriesCompareOrderedArrayElements);
+        series_created = series_created && flix->series[position];
+    }
+    flix->users = orderedArrayCreate(userCompareOrderedArrayElements);
+    flix->series_index = nameIndexCreate(seriesGetNameIndexKey,
+            seriesDestroyNameIndexElement);
+    flix->users_index = nameIndexCreate(userGetNameIndexKey,
+            userDestroyNameIndexElement);
+    flix->users_by_id = idIndexCreate();
+    flix->names = stringPoolCreate();
+    flix->users_slab = slabCreate(userGetAllocationSize());
+    flix->series_slab = slabCreate(seriesGetAllocationSize());
+    flix->series_columns = seriesColumnsCreate();
+    flix->recommender = recommenderCreate();
+    flix->recommendations_cache = NULL;
+    flix->report_writer = reportWriterCreate(REPORT_BUFFER_SIZE);
+    flix->journal_path = NULL;
+    flix->journal = NULL;
+    if(!series_created || !flix->users || !flix->series_index ||
+       !flix->users_index || !flix->users_by_id || !flix->names ||
+       !flix->users_slab || !flix->series_slab || !flix->series_columns ||
+       !flix->recommender || !flix->report_writer){
+        /* Failed to allocate memory for one of the containers. */
+        mtmFlixDestroy(flix);
         return NULL;
     }
-    flix->users = setCreate(userCopySetElement,userDestroySetElememnt,
-            userCompareSetElements);
-    if(!flix->users){
-        /* Failed to allocate memory for the users set. */
-        setDestroy(flix->series);
-        free(flix);
-    }
+    flix->next_user_id = 0;
+    flix->next_series_id = 0;
+    flix->checkpoint_generation = 0;
+    flix->commit_every = 1;
+    flix->checkpoint_every = 0;
+    flix->next_checkpoint = 0;
+    flix->journal_failed = false;
     /* New mtmflix successfully created. */
     return flix;
 }
 
-/** Rows: 5
+/** Rows: 15
  ***** Function: mtmFlixDestroy *****
  * Description: Frees all allocated memory of a given MtmFlix.
  *
@@ -101,12 +404,29 @@ void mtmFlixDestroy(MtmFlix mtmflix){
     if(!mtmflix){
         return;
     }
-    setDestroy(mtmflix->series);
-    setDestroy(mtmflix->users);
+    for(int position=0;position<NUMBER_OF_GENRES;position++){
+        orderedArrayDestroy(mtmflix->series[position]);
+    }
+    orderedArrayDestroy(mtmflix->users);
+    nameIndexDestroy(mtmflix->series_index);
+    nameIndexDestroy(mtmflix->users_index);
+    idIndexDestroy(mtmflix->users_by_id);
+    seriesColumnsDestroy(mtmflix->series_columns);
+    recommenderDestroy(mtmflix->recommender);
+    recommendationCacheDestroy(mtmflix->recommendations_cache);
+    reportWriterDestroy(mtmflix->report_writer);
+    /* Writes the changes that were not committed yet. */
+    journalDestroy(mtmflix->journal);
+    free(mtmflix->journal_path);
+    /* Destroyed after the indexes, which destroy the users and series. */
+    slabDestroy(mtmflix->users_slab);
+    slabDestroy(mtmflix->series_slab);
+    /* Destroyed last, the users and series release their names. */
+    stringPoolDestroy(mtmflix->names);
     free(mtmflix);
 }
 
-/** Rows: 21
+/** Rows: 41
  ***** Function: mtmFlixAddUser *****
  * Description: Adds a username to the MtmFlix if the user doesn't already
  * exist and the given age is legal.
@@ -130,45 +450,61 @@ MtmFlixResult mtmFlixAddUser(MtmFlix mtmflix,
         /* At least one of the arguments is NULL. */
         return MTMFLIX_NULL_ARGUMENT;
     }
-    /* In order to add a user to the users set and in order to check
-    * whether a user with that name already exist we need to use the
-    * userCompare function. Since the userCompare function has to get two
-    * users we need to create a temporary user. */
-    User temp_user = userCreate(username,age);
-    if(!temp_user){
-        /* Failed to allocate memory for the temporary user.  */
-        return MTMFLIX_OUT_OF_MEMORY;
-    }
-    if(setIsIn(mtmflix->users,temp_user)){
+    if(nameIndexContains(mtmflix->users_index,username)){
         /* User is already exist in the system. */
-        userDestroy(temp_user);
         return MTMFLIX_USERNAME_ALREADY_USED;
     }
     if(!nameIsValid(username)){
         /* Invalid username. Only numbers and letters are allowed. */
-        userDestroy(temp_user);
         return MTMFLIX_ILLEGAL_USERNAME;
     }
     if(age<MTM_MIN_AGE || age>MTM_MAX_AGE){
         /* User does not meet age requirements.  */
-        userDestroy(temp_user);
         return MTMFLIX_ILLEGAL_AGE;
     }
     /* If we got here then the user isn't in the system yet and he meets
      * all the requirements. Now we'll add him. */
-    SetResult result;
-    result = setAdd(mtmflix->users,temp_user);
-    if(result!=SET_SUCCESS){
-        /* Failed to add user to users set. */
-        userDestroy(temp_user);
+    MtmFlixResult result = prepareJournalChange(mtmflix,JOURNAL_ADD_USER,
+                                                username,NULL,&age,1);
+    if(result!=MTMFLIX_SUCCESS){
+        return result;
+    }
+    char* interned_username = stringPoolIntern(mtmflix->names,username);
+    if(!interned_username){
+        /* Failed to allocate memory for the username. */
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    User new_user = userCreate(mtmflix->users_slab,interned_username,age,
+                               mtmflix->next_user_id);
+    /* The user keeps its own reference to the name. */
+    stringPoolRelease(interned_username);
+    if(!new_user){
+        /* Failed to allocate memory for the user.  */
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    if(nameIndexInsert(mtmflix->users_index,new_user)!=NAME_INDEX_SUCCESS){
+        /* Failed to add user to users index. */
+        userDestroy(new_user);
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    if(orderedArrayInsert(mtmflix->users,new_user)!=ORDERED_ARRAY_SUCCESS){
+        /* Failed to add user to users array. The index destroys the user. */
+        nameIndexRemove(mtmflix->users_index,username);
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    if(idIndexPut(mtmflix->users_by_id,mtmflix->next_user_id,
+                  new_user)!=ID_INDEX_SUCCESS){
+        /* Failed to map the user's id. The index destroys the user. */
+        orderedArrayRemove(mtmflix->users,new_user);
+        nameIndexRemove(mtmflix->users_index,username);
         return MTMFLIX_OUT_OF_MEMORY;
     }
+    mtmflix->next_user_id++;
     /* If we got here then user added successfully to mtmflix. */
-    userDestroy(temp_user);
-    return MTMFLIX_SUCCESS;
+    return addJournalChange(mtmflix);
 }
 
-/** Rows: 13
+/** Rows: 21
  ***** Function: mtmFlixRemoveUser *****
  * Description: Removes a given user from the given MtmFlix.
  *
@@ -186,28 +522,28 @@ MtmFlixResult mtmFlixRemoveUser(MtmFlix mtmflix, const char* username){
         /* At least one of the arguments is NULL. */
         return MTMFLIX_NULL_ARGUMENT;
     }
-    /* Creates a dummy user for compariosn. */
-    User dummy_user = userCreate(username,MTM_MIN_AGE+1);
-    if(!dummy_user){
-        /* Failed to create dummy user. */
-        return MTMFLIX_OUT_OF_MEMORY;
-    }
-    if(!setIsIn(mtmflix->users,dummy_user)){
+    User user = userFindByName(mtmflix->users_index,username);
+    if(!user){
         /* User does not exist. */
-        userDestroy(dummy_user);
         return MTMFLIX_USER_DOES_NOT_EXIST;
     }
-    /* If we got here then the user exist in the users set and need to be
+    /* If we got here then the user exist in the mtmflix and need to be
      * removed.*/
-    setRemove(mtmflix->users,dummy_user); // Removes user from users set.
-    userDestroy(dummy_user);
-    /* Now we need to remove this username from every user's friendlist. */
-    SET_FOREACH(User,current_user,mtmflix->users){
-        /*Removing the username from each user's friend list  */
-        removeFromList(current_user, (char*)username,FRIENDS_LIST);
+    MtmFlixResult result = prepareJournalChange(mtmflix,JOURNAL_REMOVE_USER,
+                                                username,NULL,NULL,0);
+    if(result!=MTMFLIX_SUCCESS){
+        return result;
     }
+    /* The series he liked should not count him anymore. */
+    userUnlikeAllFavoriteSeries(user);
+    /* Only the users that have him as a friend need to be changed. */
+    userRemoveAllFriendships(user,mtmflix->users_by_id);
+    /* Never fails, the id is already mapped. */
+    idIndexPut(mtmflix->users_by_id,userGetId(user),NULL);
+    orderedArrayRemove(mtmflix->users,user); // Removes user from users.
+    nameIndexRemove(mtmflix->users_index,username); // Destroys the user.
     /* User removed successfully from mtmflix. */
-    return MTMFLIX_SUCCESS;
+    return addJournalChange(mtmflix);
 }
 
 /** Rows: 8
@@ -239,7 +575,7 @@ static bool nameIsValid(const char *name){
     return true;
 }
 
-/** Rows: 24
+/** Rows: 38
  ***** Function: mtmFlixAddSeries *****
  * Description: Adds a series to MtmFlix.
  *
@@ -273,43 +609,68 @@ MtmFlixResult mtmFlixAddSeries(MtmFlix mtmflix, const char* name,
         /* Given series name is not valid */
         return MTMFLIX_ILLEGAL_SERIES_NAME;
     }
-    Series temp_series = seriesCreate((char*)name,episodesNum,genre,ages,
-                                      episodesDuration);
-    if(!temp_series){
-        /* failed to allocate memory for the temporary series. */
-        return MTMFLIX_OUT_OF_MEMORY;
-    }
-    if(setIsIn(mtmflix->series,(SetElement)temp_series)){
+    if(nameIndexContains(mtmflix->series_index,name)){
         /* The series already exists */
-        seriesDestroy(temp_series);
         return MTMFLIX_SERIES_ALREADY_EXISTS;
     }
     if(episodesNum<1){
         /* Number of episodes is 0 or less. */
-        seriesDestroy(temp_series);
         return MTMFLIX_ILLEGAL_EPISODES_NUM;
     }
     if(episodesDuration<0 || episodesDuration==0){
         /* Episode average duration <= 0 . */
-        seriesDestroy(temp_series);
         return MTMFLIX_ILLEGAL_EPISODES_DURATION;
     }
 
     /* If we got here then the series doesn't exist yet and also meets all
      * the requirements. Now we'll add it. */
-    SetResult result;
-    result = setAdd(mtmflix->series,temp_series); // Adds series.
-    if(result!=SET_SUCCESS){
-        /* Adding series failed */
-        seriesDestroy(temp_series);
+    int values[5] = {episodesNum,genre,episodesDuration,
+                     ages ? ages[0] : 0,ages ? ages[1] : 0};
+    MtmFlixResult result = prepareJournalChange(mtmflix,JOURNAL_ADD_SERIES,
+                                                name,NULL,values,
+                                                ages ? 5 : 3);
+    if(result!=MTMFLIX_SUCCESS){
+        return result;
+    }
+    char* interned_name = stringPoolIntern(mtmflix->names,name);
+    if(!interned_name){
+        /* failed to allocate memory for the name. */
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    Series new_series = seriesCreate(mtmflix->series_slab,interned_name,
+                                     episodesNum,genre,ages,
+                                     episodesDuration,
+                                     mtmflix->next_series_id);
+    /* The series keeps its own reference to the name. */
+    stringPoolRelease(interned_name);
+    if(!new_series){
+        /* failed to allocate memory for the series. */
         return MTMFLIX_OUT_OF_MEMORY;
     }
+    if(seriesColumnsPut(mtmflix->series_columns,new_series)!=
+       SERIES_COLUMNS_SUCCESS){
+        /* Failed to grow the columns of the series. */
+        seriesDestroy(new_series);
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    if(nameIndexInsert(mtmflix->series_index,new_series)!=
+       NAME_INDEX_SUCCESS){
+        /* Adding series to the index failed */
+        seriesDestroy(new_series);
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    if(orderedArrayInsert(getGenreSeries(mtmflix,genre),new_series)!=
+       ORDERED_ARRAY_SUCCESS){
+        /* Adding series failed. The index destroys the series. */
+        nameIndexRemove(mtmflix->series_index,name);
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    mtmflix->next_series_id++;
     /* Series addded successfully. */
-    seriesDestroy(temp_series);
-    return MTMFLIX_SUCCESS;
+    return addJournalChange(mtmflix);
 }
 
-/** Rows: 13
+/** Rows: 25
  ***** Function: mtmFlixRemoveSeries *****
  * Description: Removes a given series from the given MtmFlix.
  *
@@ -327,31 +688,43 @@ MtmFlixResult mtmFlixRemoveSeries(MtmFlix mtmflix, const char* name){
         /* At least one of the given arguments is NULL. */
         return MTMFLIX_NULL_ARGUMENT;
     }
-    Series temp_series = seriesCreate((char*)name,1,DRAMA,NULL,1);
-    if(!temp_series){
-        /* Failed to allocate memory for temporary series. */
-        return MTMFLIX_OUT_OF_MEMORY;
-    }
-    if(!setIsIn(mtmflix->series,temp_series)){
+    Series series = seriesFindByName(mtmflix->series_index,name);
+    if(!series){
         /* Given series does not exist */
-        seriesDestroy(temp_series);
         return MTMFLIX_SERIES_DOES_NOT_EXIST;
     }
-    /* Series exist and should be removed. */
-    setRemove(mtmflix->series,temp_series); // Removes series from system.
-    seriesDestroy(temp_series);
-    SET_FOREACH(User,current_user,mtmflix->users){
-        /*Removing the series from each user's favorite series list  */
-        removeFromList(current_user,(char*)name,FAVORITE_SERIES_LIST);
+    MtmFlixResult result = prepareJournalChange(mtmflix,
+                                                JOURNAL_REMOVE_SERIES,name,
+                                                NULL,NULL,0);
+    if(result!=MTMFLIX_SUCCESS){
+        return result;
     }
+    /* Removing the series from the favorite series list of each user that
+     * likes it. This is done before the series is destroyed since the
+     * statistics of the lists need its genre and duration. Every removal
+     * takes the user's id out of the liked-by ids, so the last id is taken
+     * each time. */
+    IdArray liked_by = seriesGetLikedBy(series);
+    while(idArrayGetSize(liked_by)>0){
+        unsigned int id = idArrayGet(liked_by,idArrayGetSize(liked_by)-1);
+        User current_user=idIndexGet(mtmflix->users_by_id,id);
+        assert(current_user);
+        userRemoveFavoriteSeries(current_user,series);
+        userUpdateFollowers(current_user,series,false,mtmflix->users_by_id);
+    }
+    /* Series exist and should be removed. */
+    orderedArrayRemove(getGenreSeries(mtmflix,seriesGetGenre(series)),
+                       series); // Removes from system.
+    nameIndexRemove(mtmflix->series_index,name); // Destroys the series.
     /* Series removed successully. */
-    return MTMFLIX_SUCCESS;
+    return addJournalChange(mtmflix);
 }
 
-/** Rows: 29
+/** Rows: 25
  ***** Function: mtmFlixReportSeries *****
  * Description: Prints name and genre of series in MtmFlix to a file. Only
- * the 'seriesNum' first from each genre will be printed.
+ * the 'seriesNum' first from each genre will be printed (all of them if
+ * seriesNum is 0).
  *
  * @param mtmflix - MtmFlix to print the series from.
  * @param seriesNum - Number of series from a genre to be printed.
@@ -369,71 +742,39 @@ MtmFlixResult mtmFlixReportSeries(MtmFlix mtmflix, int seriesNum,
         /* At least one of the given arguments is NULL. */
         return MTMFLIX_NULL_ARGUMENT;
     }
-    if(setGetSize(mtmflix->series)==0){
+    if(nameIndexGetSize(mtmflix->series_index)==0){
         /* No series in mtmtflix. */
         return MTMFLIX_NO_SERIES;
     }
     assert(seriesNum>=0);
-    SeriesResult result;
-    if(seriesNum==0){
-        /*Should print all the series found in mtmflix*/
-        SET_FOREACH(SetElement,current_series,mtmflix->series){
-            result=printSeriesDetailsToFile(current_series,outputStream);
-            if(result!=SERIES_SUCCESS){
-                /*Print has failed becuase of memory
-                         * allocation error */
-                return MTMFLIX_OUT_OF_MEMORY;
-            }
+    ReportWriter writer=mtmflix->report_writer;
+    reportWriterStart(writer,outputStream);
+    MtmFlixResult result=MTMFLIX_SUCCESS;
+    /* Only the first seriesNum series of each genre are read, the rest of
+     * the genre is never visited. */
+    for(int position=0;position<NUMBER_OF_GENRES &&
+                       result==MTMFLIX_SUCCESS;position++){
+        OrderedArray genre_series=mtmflix->series[position];
+        int number_to_print=orderedArrayGetSize(genre_series);
+        if(seriesNum>0 && seriesNum<number_to_print){
+            number_to_print=seriesNum;
         }
-    }
-    else {
-        /*Sets the number of series from each genre should be printed */
-        int number_of_series_from_genre=seriesNum;
-        /*Sets the current genre to the first genre in the list */
-        Genre current_genre=seriesGetGenre((Series)setGetFirst
-                (mtmflix->series));
-        SET_FOREACH(SetElement,current_series,mtmflix->series){
-            /*Checks if the current series is still from the same genre*/
-            if(seriesGetGenre((Series)current_series)==current_genre){
-                /*Checks if the current series details should be printed */
-                if (number_of_series_from_genre>0){
-                    result=printSeriesDetailsToFile(current_series,
-                            outputStream);
-                    if(result!=SERIES_SUCCESS){
-                        /*Print has failed becuase of memory
-                         * allocation error */
-                        return MTMFLIX_OUT_OF_MEMORY;
-                    }
-                    number_of_series_from_genre--;
-                }
-                else {
-                    /*The current series is still from the same genre but
-                     * should not be printed */
-                    continue;
-                }
-            }
-            else{
-                /*If we reached here, the current series is from a
-                 * different genre,so we need to print it */
-                /*The current series details will be printed so we have to
-                 * print series from the same genre more seriesNum-1
-                 * times */
-                number_of_series_from_genre=seriesNum-1;
-                /*Setting the new genre to be the current genre */
-                current_genre=seriesGetGenre((Series)current_series);
-                result=printSeriesDetailsToFile(current_series,
-                        outputStream);
-                if(result!=SERIES_SUCCESS){
-                    /*Print has failed becuase of memory
-                         * allocation error */
-                    return MTMFLIX_OUT_OF_MEMORY;
-                }
+        for(int i=0;i<number_to_print && result==MTMFLIX_SUCCESS;i++){
+            Series current_series=orderedArrayGet(genre_series,i);
+            if(reportWriterWrite(writer,seriesGetDetails(current_series))!=
+               REPORT_WRITER_SUCCESS){
+                /*Print has failed becuase of memory allocation error */
+                result=MTMFLIX_OUT_OF_MEMORY;
             }
         }
     }
-    return MTMFLIX_SUCCESS;
+    /* The series that were printed before a failure are written too. */
+    if(reportWriterFlush(writer)!=REPORT_WRITER_SUCCESS){
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    return result;
 }
-/** Rows: 10
+/** Rows: 11
  ***** Function: mtmFlixReportUsers *****
  * Description: Prints all the details of all the users to a file.
  *
@@ -451,23 +792,336 @@ MtmFlixResult mtmFlixReportUsers(MtmFlix mtmflix, FILE* outputStream){
         /* At least one of the given arguments is NULL. */
         return MTMFLIX_NULL_ARGUMENT;
     }
-    if(setGetSize(mtmflix->users)==0){
+    if(orderedArrayGetSize(mtmflix->users)==0){
         /* No users in mtmtflix. */
         return MTMFLIX_NO_USERS;
     }
-    UserResult result;
-    SET_FOREACH(SetElement,current_user,mtmflix->users){
-        result= userPrintDetailsToFile(current_user, outputStream);
-        if(result!=USER_SUCCESS){
+    /* The lists of the names are emptied after every user, so they are
+     * created once for the whole report. */
+    List friends_names=listCreate(copyBorrowedName,destroyBorrowedName);
+    List series_names=listCreate(copyBorrowedName,destroyBorrowedName);
+    if(!friends_names || !series_names){
+        listDestroy(friends_names);
+        listDestroy(series_names);
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    ReportWriter writer=mtmflix->report_writer;
+    reportWriterStart(writer,outputStream);
+    MtmFlixResult result=MTMFLIX_SUCCESS;
+    for(int i=0;i<orderedArrayGetSize(mtmflix->users) &&
+                result==MTMFLIX_SUCCESS;i++){
+        User current_user=orderedArrayGet(mtmflix->users,i);
+        const char* user_details=userGetDetails(current_user,
+                                                mtmflix->users_by_id,
+                                                friends_names,series_names);
+        if(reportWriterWrite(writer,user_details)!=REPORT_WRITER_SUCCESS){
             /* Failed to print. */
-            return MTMFLIX_OUT_OF_MEMORY;
+            result=MTMFLIX_OUT_OF_MEMORY;
         }
     }
-    /* Users printed successfully. */
+    listDestroy(friends_names);
+    listDestroy(series_names);
+    /* The users that were printed before a failure are written too. */
+    if(reportWriterFlush(writer)!=REPORT_WRITER_SUCCESS){
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    return result;
+}
+
+/** Rows: 51
+ ***** Function: mtmFlixReportUsersParallel *****
+ * Description: Prints exactly what mtmFlixReportUsers prints, but the
+ * users are formatted by several threads. The sorted users are split to
+ * shards of USERS_PER_REPORT_SHARD users, every thread takes the next
+ * shard that was not taken yet and formats its users into a buffer of the
+ * shard. The calling thread prints the buffers in the order of the shards,
+ * as soon as each one is ready, so the output does not depend on the
+ * threads. The users are formatted exactly as mtmPrintUser formats them,
+ * but straight into the buffer of the shard, so the threads do not share
+ * the one buffer of the mtm library. If no thread could be created, the
+ * users are printed by mtmFlixReportUsers.
+ *
+ * Notice: The mtmflix is only read by the threads, so it must not be
+ * changed by any other thread until this function returns.
+ *
+ * @param mtmflix - The mtmflix to print the users of.
+ * @param threadsNum - Number of threads that format the users. With one
+ * thread nothing is done in parallel.
+ * @param outputStream - A file to print to.
+ *
+ * @return
+ * MTMFLIX_NULL_ARGUMENT - At least one of the given arguments is NULL.
+ * MTMFLIX_ILLEGAL_NUMBER - threadsNum is not positive.
+ * MTMFLIX_NO_USERS - No users in mtmtflix.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - Printing has succeeded.
+ */
+MtmFlixResult mtmFlixReportUsersParallel(MtmFlix mtmflix, int threadsNum,
+                                         FILE* outputStream){
+    if(!mtmflix || !outputStream){
+        return MTMFLIX_NULL_ARGUMENT;
+    }
+    if(threadsNum<1){
+        return MTMFLIX_ILLEGAL_NUMBER;
+    }
+    int shards_num = (orderedArrayGetSize(mtmflix->users)+
+                      USERS_PER_REPORT_SHARD-1)/USERS_PER_REPORT_SHARD;
+    if(threadsNum==1 || shards_num<2){
+        /* Nothing to split between threads. */
+        return mtmFlixReportUsers(mtmflix,outputStream);
+    }
+    if(threadsNum>shards_num){
+        threadsNum = shards_num;
+    }
+    struct users_report_job_t job = {mtmflix,NULL,shards_num,0};
+    job.shards = calloc(shards_num,sizeof(ReportShard));
+    pthread_t* threads = malloc(sizeof(pthread_t)*threadsNum);
+    if(!job.shards || !threads){
+        free(job.shards);
+        free(threads);
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    pthread_mutex_init(&job.lock,NULL);
+    pthread_cond_init(&job.shard_formatted,NULL);
+    int threads_created = 0;
+    while(threads_created<threadsNum &&
+          pthread_create(&threads[threads_created],NULL,usersReportWorker,
+                         &job)==0){
+        threads_created++;
+    }
+    /* Even if not all of the threads were created, the ones that were
+     * created format all the shards. Without threads, nothing was taken
+     * and the users are printed serially. */
+    MtmFlixResult result = threads_created>0 ?
+            printReportShards(&job,mtmflix->report_writer,outputStream) :
+            mtmFlixReportUsers(mtmflix,outputStream);
+    for(int i=0;i<threads_created;i++){
+        pthread_join(threads[i],NULL);
+    }
+    for(int i=0;i<shards_num;i++){
+        free(job.shards[i].text);
+    }
+    pthread_cond_destroy(&job.shard_formatted);
+    pthread_mutex_destroy(&job.lock);
+    free(job.shards);
+    free(threads);
+    return result;
+}
+
+/** Rows: 21
+ ***** Function: mtmFlixSaveSnapshot *****
+ * Description: Saves the series, the users, their friends and their
+ * favorite series to a file, in the binary format of a snapshot. Users
+ * and series are numbered by their order in mtmflix, so the snapshot does
+ * not depend on the ids of removed users and series. Only the data is
+ * saved, not settings like the hot users.
+ *
+ * @param mtmflix - The mtmflix to save.
+ * @param outputStream - A file to save to. Should be opened in binary
+ * mode.
+ *
+ * @return
+ * MTMFLIX_NULL_ARGUMENT - At least one of the given arguments is NULL.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error, or failure to write the file.
+ * MTMFLIX_SUCCESS - Snapshot saved.
+ */
+MtmFlixResult mtmFlixSaveSnapshot(MtmFlix mtmflix, FILE* outputStream){
+    if(!mtmflix || !outputStream){
+        return MTMFLIX_NULL_ARGUMENT;
+    }
+    /* Positions of the users and series in the snapshot, by their ids. */
+    unsigned int* user_positions = malloc(sizeof(unsigned int)*
+                                          (mtmflix->next_user_id+1));
+    unsigned int* series_positions = malloc(sizeof(unsigned int)*
+                                            (mtmflix->next_series_id+1));
+    Snapshot snapshot = NULL;
+    if(user_positions && series_positions){
+        snapshot = createSnapshot(mtmflix,user_positions,series_positions);
+    }
+    MtmFlixResult result = MTMFLIX_OUT_OF_MEMORY;
+    if(snapshot && snapshotWrite(snapshot,outputStream)==SNAPSHOT_SUCCESS){
+        result = MTMFLIX_SUCCESS;
+    }
+    snapshotDestroy(snapshot);
+    free(user_positions);
+    free(series_positions);
+    return result;
+}
+
+/** Rows: 24
+ ***** Function: mtmFlixLoadSnapshot *****
+ * Description: Creates a new mtmflix from a snapshot that was saved by
+ * mtmFlixSaveSnapshot. The whole snapshot is read (or mapped) at once, and
+ * the indexes are built straight from its records: every series and user
+ * gets its position as its id, and since they are kept sorted every
+ * sorted array is only appended to. The data is checked like the data of
+ * the functions that build a mtmflix, and the records must be sorted.
+ *
+ * @param inputStream - A file to load from. Should be opened in binary
+ * mode.
+ * @param mtmflix - Holds the new mtmflix on success.
+ *
+ * @return
+ * MTMFLIX_NULL_ARGUMENT - At least one of the given arguments is NULL.
+ * MTMFLIX_CANNOT_OPEN_FILE - The file is not a valid snapshot.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - Mtmflix loaded.
+ */
+MtmFlixResult mtmFlixLoadSnapshot(FILE* inputStream, MtmFlix* mtmflix){
+    if(!inputStream || !mtmflix){
+        return MTMFLIX_NULL_ARGUMENT;
+    }
+    Snapshot snapshot = NULL;
+    SnapshotResult read_result = snapshotRead(inputStream,&snapshot);
+    if(read_result!=SNAPSHOT_SUCCESS){
+        return read_result==SNAPSHOT_OUT_OF_MEMORY ? MTMFLIX_OUT_OF_MEMORY :
+               MTMFLIX_CANNOT_OPEN_FILE;
+    }
+    MtmFlix flix = mtmFlixCreate();
+    /* The series are found by their positions while the users are
+     * loaded. */
+    size_t series_num = snapshotGetSeriesNum(snapshot);
+    Series* series_by_position = malloc(sizeof(Series)*
+                                        (series_num>0 ? series_num : 1));
+    MtmFlixResult result = flix && series_by_position ?
+            loadSnapshotSeries(flix,snapshot,series_by_position) :
+            MTMFLIX_OUT_OF_MEMORY;
+    if(result==MTMFLIX_SUCCESS){
+        result = loadSnapshotUsers(flix,snapshot,series_by_position);
+    }
+    if(result==MTMFLIX_SUCCESS){
+        result = loadSnapshotFriends(flix,snapshot);
+    }
+    free(series_by_position);
+    snapshotDestroy(snapshot);
+    if(result!=MTMFLIX_SUCCESS){
+        mtmFlixDestroy(flix);
+        return result;
+    }
+    *mtmflix = flix;
     return MTMFLIX_SUCCESS;
 }
 
-/** Rows: 30
+/** Rows: 34
+ ***** Function: mtmFlixOpenJournaled *****
+ * Description: Creates a mtmflix that journals every change to files that
+ * start with the given path, and recovers what was journaled there
+ * before. The last checkpoint is loaded as a snapshot, the changes that
+ * were journaled after it are made again, and then a new checkpoint is
+ * written and the journal starts over.
+ * Every successful change (adding and removing users and series, joining
+ * and leaving series, adding and removing friends) is journaled. A change
+ * that there is no memory to journal is not made, and returns
+ * MTMFLIX_OUT_OF_MEMORY. A change that was made but could not be written
+ * to the journal returns MTMFLIX_CANNOT_OPEN_FILE. It stays in memory
+ * and is written by the next commit that succeeds, and until then every
+ * change first tries to commit again, and is not made if it cannot. A
+ * checkpoint that fails is tried again after checkpointEvery more
+ * changes.
+ *
+ * @param path - Path the journal and checkpoint files start with.
+ * @param commitEvery - Number of changes that are written to the journal
+ * file together. Changes that were not written yet are lost on a crash.
+ * @param checkpointEvery - Number of changes after which a checkpoint is
+ * written and the journal starts over. 0 for only on mtmFlixCheckpoint.
+ * @param mtmflix - Holds the new mtmflix on success.
+ *
+ * @return
+ * MTMFLIX_NULL_ARGUMENT - At least one of the given arguments is NULL.
+ * MTMFLIX_ILLEGAL_NUMBER - commitEvery is smaller than 1 or
+ * checkpointEvery is negative.
+ * MTMFLIX_CANNOT_OPEN_FILE - The checkpoint or the journal is not valid,
+ * or a file could not be written.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - Mtmflix recovered and journaled.
+ */
+MtmFlixResult mtmFlixOpenJournaled(const char* path, int commitEvery,
+                                   int checkpointEvery, MtmFlix* mtmflix){
+    if(!path || !mtmflix){
+        return MTMFLIX_NULL_ARGUMENT;
+    }
+    if(commitEvery<1 || checkpointEvery<0){
+        return MTMFLIX_ILLEGAL_NUMBER;
+    }
+    MtmFlix flix = NULL;
+    unsigned int generation = 0;
+    MtmFlixResult result = loadCheckpoint(path,&flix,&generation);
+    if(result!=MTMFLIX_SUCCESS){
+        return result;
+    }
+    result = replayJournal(flix,path,generation);
+    /* The path is set only now, so the replayed changes are not
+     * journaled again. They are taken into a new checkpoint instead. */
+    flix->journal_path = result==MTMFLIX_SUCCESS ?
+                         createFilePath(path,"") : NULL;
+    if(flix->journal_path){
+        flix->checkpoint_generation = generation;
+        flix->commit_every = commitEvery;
+        flix->checkpoint_every = checkpointEvery;
+        result = writeCheckpoint(flix);
+    } else if(result==MTMFLIX_SUCCESS){
+        result = MTMFLIX_OUT_OF_MEMORY;
+    }
+    if(result!=MTMFLIX_SUCCESS){
+        mtmFlixDestroy(flix);
+        return result;
+    }
+    *mtmflix = flix;
+    return MTMFLIX_SUCCESS;
+}
+
+/** Rows: 13
+ ***** Function: mtmFlixCommitJournal *****
+ * Description: Writes the changes that were journaled but not written yet
+ * to the journal file.
+ *
+ * @param mtmflix - The mtmflix to commit the journal of.
+ *
+ * @return
+ * MTMFLIX_NULL_ARGUMENT - mtmflix is NULL.
+ * MTMFLIX_OUT_OF_MEMORY - Failed to write the journal.
+ * MTMFLIX_SUCCESS - Changes written, or mtmflix is not journaled.
+ */
+MtmFlixResult mtmFlixCommitJournal(MtmFlix mtmflix){
+    if(!mtmflix){
+        return MTMFLIX_NULL_ARGUMENT;
+    }
+    if(!mtmflix->journal_path){
+        return MTMFLIX_SUCCESS;
+    }
+    if(journalCommit(mtmflix->journal)!=JOURNAL_SUCCESS){
+        mtmflix->journal_failed = true;
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    mtmflix->journal_failed = false;
+    return MTMFLIX_SUCCESS;
+}
+
+/** Rows: 9
+ ***** Function: mtmFlixCheckpoint *****
+ * Description: Writes a checkpoint of a journaled mtmflix and starts its
+ * journal over, so the changes journaled so far do not have to be made
+ * again on recovery.
+ *
+ * @param mtmflix - The mtmflix to checkpoint.
+ *
+ * @return
+ * MTMFLIX_NULL_ARGUMENT - mtmflix is NULL.
+ * MTMFLIX_CANNOT_OPEN_FILE - A file could not be written.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error, or failure to write a file.
+ * MTMFLIX_SUCCESS - Checkpoint written, or mtmflix is not journaled.
+ */
+MtmFlixResult mtmFlixCheckpoint(MtmFlix mtmflix){
+    if(!mtmflix){
+        return MTMFLIX_NULL_ARGUMENT;
+    }
+    if(!mtmflix->journal_path){
+        return MTMFLIX_SUCCESS;
+    }
+    return writeCheckpoint(mtmflix);
+}
+
+/** Rows: 35
  ***** Function: mtmFlixSeriesJoin *****
  * Description: Gets a username and a series name and put the series in
  * user's favorite-series-list.
@@ -496,59 +1150,37 @@ MtmFlixResult mtmFlixSeriesJoin(MtmFlix mtmflix, const char* username,
         return result;
     }
     /*If we got here both user and series exist in mtmflix */
-    User dummy_user = userCreate(username,MTM_MIN_AGE+1);
-    Series dummy_series = seriesCreate((char*)seriesName,1,HORROR,NULL,5);
-    if(!dummy_series || !dummy_user){
-        /* Memory allocation failed  */
-        userDestroy(dummy_user);
-        seriesDestroy(dummy_series);
-        return MTMFLIX_OUT_OF_MEMORY;
-    }
-    SeriesResult status;
-    if(!userCanWatchSeries(mtmflix, dummy_user, dummy_series,&status)){
-        /* User can't watch series because of age limitations or
-         * userCanWatchSeries had a memory fail. */
-        if(status!=SERIES_SUCCESS){
-            /* Memory fail: userCanWatchSeries memory fail. */
-            userDestroy(dummy_user);
-            seriesDestroy(dummy_series);
-            return MTMFLIX_OUT_OF_MEMORY;
-        }
+    User user = userFindByName(mtmflix->users_index,username);
+    Series series = seriesFindByName(mtmflix->series_index,seriesName);
+    if(!userCanWatchSeries(user,series)){
         /*If we got here user can't add the series because of age
           limitations */
-        userDestroy(dummy_user);
-        seriesDestroy(dummy_series);
         return MTMFLIX_USER_NOT_IN_THE_RIGHT_AGE;
     }
+    if(isInUsersFavoriteSeriesList(user,(char*)seriesGetName(series))){
+        /* Already in his list, nothing changes. */
+        return MTMFLIX_SUCCESS;
+    }
     /* If we got here then the user can add the series to his list.  */
-    seriesDestroy(dummy_series);
-    SET_FOREACH(SetElement,current_user,mtmflix->users){
-         if(userCompare(dummy_user,current_user)==0){
-             /* We found the user with the given name so we need to add the
-              * series to this user.*/
-             result = addNameToUsersList((User) current_user,
-                                         (char *) seriesName,
-                                         FAVORITE_SERIES_LIST);
-             if (result!=MTMFLIX_SUCCESS) {
-                 userDestroy(dummy_user);
-                 return MTMFLIX_OUT_OF_MEMORY;
-             }
-         }
-     }
-    /* If we got here we couldn't find the user in the users set.
-    * Shouldn't happen! */
-    userDestroy(dummy_user);
-    return MTMFLIX_SUCCESS;
+    result = prepareJournalChange(mtmflix,JOURNAL_SERIES_JOIN,username,
+                                  seriesName,NULL,0);
+    if(result!=MTMFLIX_SUCCESS){
+        return result;
+    }
+    result = userAddFavoriteSeries(user,series);
+    if (result!=MTMFLIX_SUCCESS) {
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    /* His followers rank his favorite series. */
+    userUpdateFollowers(user,series,true,mtmflix->users_by_id);
+    return addJournalChange(mtmflix);
 }
 
-/** Rows: 24
+/** Rows: 1
  ***** Static function : userCanWatchSeries *****
  * Description: Checks if a user can add a series to his favorite series
  * list by the series age limitations.
  *
- * Notice: Will not damage the iterator.
- *
- * @param mtmflix - The system of MtmFlix.
  * @param user - The user that want to add the show.
  * @param series - The show that the user wants to add.
  *
@@ -556,55 +1188,12 @@ MtmFlixResult mtmFlixSeriesJoin(MtmFlix mtmflix, const char* username,
  * True - If the series has no age limitations or the user's age is in
  * range of the age limitations of the series, else false.
  */
-static bool userCanWatchSeries(MtmFlix mtmflix, User user,
-                               Series series,SeriesResult* status) {
-    Set series_set_copy = setCopy(mtmflix->series);
-    if(!series_set_copy){
-        *status = SERIES_MEMORY_ALLOCATION_FAILED;
-        return false;
-    }
-    int series_max_age = -1;
-    int series_min_age = -1;
-    SET_FOREACH(SetElement, current_series, series_set_copy) {
-        if (seriesCompare(series,current_series) == 0) {
-            /* We found the series with the given name. */
-            if (seriesHasAgeRestrictions(current_series)) {
-                /* Series has age restrictions */
-                series_max_age = seriesGetMaxAge(current_series);
-                series_min_age = seriesGetMinAge(current_series);
-                break;
-            }
-            else {
-                /*The series has no age limitations and the user can add
-                  it*/
-                *status = SERIES_SUCCESS;
-                setDestroy(series_set_copy);
-                return true;
-            }
-        }
-    }
-    setDestroy(series_set_copy);
-    /*If we got here the series has age limitations and we need to check
-      if the user can add it to his favorite series list */
-    SET_FOREACH(SetElement,current_user,mtmflix->users) {
-        //todo:Check if equal age is allowed!
-        if (userCompare(user,current_user) == 0) {
-            /* We found the user with the given name.*/
-            if (series_max_age < userGetAge(current_user) ||
-                (series_min_age > userGetAge(current_user))) {
-                /* User's age is not in rage */
-                *status = SERIES_SUCCESS;
-                return false;
-            }
-        }
-    }
-    /*If we got here the user can add the series to his favorite series
-      list*/
-    *status = SERIES_SUCCESS;
-    return true;
+static bool userCanWatchSeries(User user, Series series) {
+    /* A series without age limitations allows every legal age. */
+    return seriesAllowsAge(series,userGetAge(user));
 }
 
-/** Rows: 16
+/** Rows: 21
  ***** Function: mtmFlixSeriesLeave *****
  * Description: Gets a mtmflix system, username and series name.
  * The function removes the series from the given user's favorite list.
@@ -632,26 +1221,27 @@ MtmFlixResult mtmFlixSeriesLeave(MtmFlix mtmflix, const char* username,
           mtmflix or in case of memory allocation error*/
         return result;
     }
-    User temp_user=userCreate(username,MTM_MIN_AGE);
-    if(!temp_user){
-        /*User creation failed because of memory allocation error */
-        return MTMFLIX_OUT_OF_MEMORY;
+    User user = getUserByUsername(mtmflix,username,&result);
+    Series series = seriesFindByName(mtmflix->series_index,seriesName);
+    /* Found the user with the given username. Now we'll remove the series
+     * from his list. */
+    if(!isInUsersFavoriteSeriesList(user,(char*)seriesGetName(series))){
+        /* Not in his list, nothing changes. */
+        return MTMFLIX_SUCCESS;
     }
-    SET_FOREACH(SetElement,user,mtmflix->users){
-        if(userCompare(temp_user,user)==0){
-            /* Found the user with the given username. Now we'll remove
-             * the series from his list. */
-            removeFromList((User)user,(char*)seriesName,
-                                                  FAVORITE_SERIES_LIST);
-            break;
-        }
+    result = prepareJournalChange(mtmflix,JOURNAL_SERIES_LEAVE,username,
+                                  seriesName,NULL,0);
+    if(result!=MTMFLIX_SUCCESS){
+        return result;
     }
+    userRemoveFavoriteSeries(user,series);
+    /* His followers rank his favorite series. */
+    userUpdateFollowers(user,series,false,mtmflix->users_by_id);
     /* Series successfully removed from user's favorite list. */
-    userDestroy(temp_user);
-    return MTMFLIX_SUCCESS;
+    return addJournalChange(mtmflix);
 }
 
-/** Rows: 20
+/** Rows: 26
  ***** Function: mtmFlixAddFriend *****
  * Description: Adds username2 to the friend list of username1.
  *
@@ -681,31 +1271,25 @@ MtmFlixResult mtmFlixAddFriend(MtmFlix mtmflix, const char* username1,
         return MTMFLIX_SUCCESS;
     }
     /*If we got here both users exist in mtmflix */
-    User dummy_user = userCreate(username1,MTM_MIN_AGE);
-    if(!dummy_user){
-        /* Memory allocation failed  */
-        return MTMFLIX_OUT_OF_MEMORY;
-    }
-    SET_FOREACH(SetElement,current_user,mtmflix->users){
-        if(userCompare(dummy_user,current_user)==0){
-            /* We found the user with the given name so we need to add
-             * username2 to this user's friend list.*/
-            result = addNameToUsersList((User) current_user,
-                                        (char *) username2,
-                                        FRIENDS_LIST);
-            if (result!=MTMFLIX_SUCCESS) {
-                /* Failed to add to usernames1's friend list. */
-                userDestroy(dummy_user);
-                return result;
-            }
-        }
+    User user1 = getUserByUsername(mtmflix,username1,&result);
+    User user2 = getUserByUsername(mtmflix,username2,&result);
+    /* We found the user with the given name so we need to add username2 to
+     * this user's friend list.*/
+    result = prepareJournalChange(mtmflix,JOURNAL_ADD_FRIEND,username1,
+                                  username2,NULL,0);
+    if(result!=MTMFLIX_SUCCESS){
+        return result;
+    }
+    result = userAddFriend(user1,user2);
+    if (result!=MTMFLIX_SUCCESS) {
+        /* Failed to add to usernames1's friend list. */
+        return result;
     }
     /* Username2 successfully added to username1's friend list. */
-    userDestroy(dummy_user);
-    return MTMFLIX_SUCCESS;
+    return addJournalChange(mtmflix);
 }
 
-/** Rows: 12
+/** Rows: 19
  ***** Function: mtmFlixRemoveFriend *****
  * Description: Removes username2 from the friend
  * list of username1.
@@ -733,19 +1317,19 @@ MtmFlixResult mtmFlixRemoveFriend(MtmFlix mtmflix, const char* username1,
         return result;
     }
     /* If we got here both users exist. */
-    User dummy_user1 = userCreate(username1,MTM_MIN_AGE+1);
-    SET_FOREACH(SetElement,current_user,mtmflix->users){
-        if(userCompare(dummy_user1,current_user)==0){
-            /* We found user1. */
-            removeFromList(current_user,(char*)username2,FRIENDS_LIST);
-        }
+    User user1 = getUserByUsername(mtmflix,username1,&result);
+    User user2 = getUserByUsername(mtmflix,username2,&result);
+    result = prepareJournalChange(mtmflix,JOURNAL_REMOVE_FRIEND,username1,
+                                  username2,NULL,0);
+    if(result!=MTMFLIX_SUCCESS){
+        return result;
     }
+    userRemoveFriend(user1,user2);
     /* Username2 sucessfully removed from username1's friend list. */
-    userDestroy(dummy_user1);
-    return MTMFLIX_SUCCESS;
+    return addJournalChange(mtmflix);
 }
 
-/** Rows: 25
+/** Rows: 3
  ***** Function: mtmFlixGetRecommendations *****
  * Description: Prints recommendations of series for the given user.
  * Recommendations will be printed into the given file.
@@ -763,93 +1347,309 @@ MtmFlixResult mtmFlixRemoveFriend(MtmFlix mtmflix, const char* username1,
  */
 MtmFlixResult mtmFlixGetRecommendations(MtmFlix mtmflix,
                     const char* username, int count, FILE* outputStream){
+    /* Ranking in one thread. */
+    return mtmFlixGetRecommendationsWithThreads(mtmflix,username,count,1,
+                                                outputStream);
+}
+
+/** Rows: 27
+ ***** Function: mtmFlixGetRecommendationsWithThreads *****
+ * Description: Prints exactly what mtmFlixGetRecommendations prints, but
+ * if the user has many candidate series (series loved by his friends),
+ * they are split between several threads. Each thread keeps the best
+ * series of its part, and the parts are merged at the end. Meant for
+ * users with a huge number of friends.
+ *
+ * Notice: The mtmflix is only read by the threads, so it must not be
+ * changed by any other thread until this function returns.
+ *
+ * @param mtmflix - Mtmflix we are working on.
+ * @param username - The username we want to print recommendations for.
+ * @param count - How many series to recommend from each genre.
+ * @param threadsNum - Maximal number of threads that rank the series,
+ * including the calling thread.
+ * @param outputStream - File to print to.
+ *
+ * @return
+ * MTMFLIX_SUCCESS - Successfully printed the recommendations.
+ * MTMFLIX_NULL_ARGUMENT - At least one of the given  arguments is NULL.
+ * MTMFLIX_USER_DOES_NOT_EXIST - User with given username doesn't exist.
+ * MTMFLIX_ILLEGAL_NUMBER - A negative numer was inserted, or threadsNum
+ * is not positive.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ */
+MtmFlixResult mtmFlixGetRecommendationsWithThreads(MtmFlix mtmflix,
+                    const char* username, int count, int threadsNum,
+                    FILE* outputStream){
     if(!mtmflix || !username || !outputStream){
         return MTMFLIX_NULL_ARGUMENT;
     }
     MtmFlixResult result;
-    User user = getUserByUsername((char*)username,&result,mtmflix->users);
+    User user = getUserByUsername(mtmflix,username,&result);
     if(result!=MTMFLIX_SUCCESS){
         /*We get here in case of memory allocation error or in case the
          * user with the given username doesn't exist */
         return result;
     }
-    if(count<0){
+    if(count<0 || threadsNum<1){
         return MTMFLIX_ILLEGAL_NUMBER;
     }
-
-    Set series_set_copy = setCopy(mtmflix->series);
-    if(!series_set_copy){
-        /* Memory allocation failed. */
+    result=recommendToUser(mtmflix,user,count,threadsNum,outputStream);
+    if(result!=MTMFLIX_SUCCESS) {
+        /* Failed to print. */
         return MTMFLIX_OUT_OF_MEMORY;
     }
+    /* Recommendations printed successfully.*/
+    return MTMFLIX_SUCCESS;
+}
 
-    Set ranked_series_set=setCreate(rankedSeriesCopySetElement,
-            rankedSeriesDestroySetElement, rankedSeriesCompareSetElement);
-    if(!ranked_series_set){
-        setDestroy(series_set_copy);
+/** Rows: 29
+ ***** Function: mtmFlixGetRecommendationsBatch *****
+ * Description: Prints recommendations of series for each of the given
+ * users, in the order of the users, exactly as mtmFlixGetRecommendations
+ * would print them one after the other. All the users are found before
+ * anything is printed, and the ranked series are prepared once for all
+ * of them.
+ *
+ * @param mtmflix - Mtmflix we are working on.
+ * @param usernames - Array of the usernames we want to print
+ * recommendations for.
+ * @param usersNum - Number of usernames in the array.
+ * @param count - How many series to recommend to each user.
+ * @param outputStream - File to print to.
+ *
+ * @return
+ * MTMFLIX_SUCCESS - Successfully printed the recommendations.
+ * MTMFLIX_NULL_ARGUMENT - At least one of the given arguments (or one of
+ * the usernames) is NULL.
+ * MTMFLIX_ILLEGAL_NUMBER - A negative numer was inserted.
+ * MTMFLIX_USER_DOES_NOT_EXIST - One of the users doesn't exist. Nothing is
+ * printed in this case.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ */
+MtmFlixResult mtmFlixGetRecommendationsBatch(MtmFlix mtmflix,
+                    const char** usernames, int usersNum, int count,
+                    FILE* outputStream){
+    if(!mtmflix || !usernames || !outputStream){
+        return MTMFLIX_NULL_ARGUMENT;
+    }
+    if(usersNum<0 || count<0){
+        return MTMFLIX_ILLEGAL_NUMBER;
+    }
+    User* users = malloc(sizeof(User)*(usersNum>0 ? usersNum : 1));
+    if(!users){
         return MTMFLIX_OUT_OF_MEMORY;
     }
-    /* rankAllSeriesForUser will rank the relevant series and print them
-     * to the given file. */
-    result=rankAllSeriesForUser(mtmflix,user,ranked_series_set,
-            outputStream,count,series_set_copy);
-            if(result!=MTMFLIX_SUCCESS) {
-                /* Failed to print. */
-                setDestroy(series_set_copy);
-                setDestroy(ranked_series_set);
-                return MTMFLIX_OUT_OF_MEMORY;
+    MtmFlixResult result = getUsersByUsernames(mtmflix,usernames,usersNum,
+                                               users);
+    /* The capacity is the same for all the users, so the ranked series
+     * grows at most once, in the first ranking. */
+    for(int i=0;i<usersNum && result==MTMFLIX_SUCCESS;i++){
+        result = recommendToUser(mtmflix,users[i],count,1,outputStream);
+    }
+    free(users);
+    return result;
+}
+
+/** Rows: 61
+ ***** Function: mtmFlixGetRecommendationsParallel *****
+ * Description: Prints exactly what mtmFlixGetRecommendationsBatch prints,
+ * but the series are ranked by several threads. Every thread takes the
+ * next user that was not taken yet, ranks the series for him with its own
+ * recommender and keeps the best series in a buffer of that user. The
+ * calling thread prints the buffers in the order of the users, as soon as
+ * each one is ready, so the output does not depend on the threads. If no
+ * thread could be created, the recommendations are printed by
+ * mtmFlixGetRecommendationsBatch.
+ *
+ * Notice: The mtmflix is only read by the threads, so it must not be
+ * changed by any other thread until this function returns.
+ *
+ * @param mtmflix - Mtmflix we are working on.
+ * @param usernames - Array of the usernames we want to print
+ * recommendations for.
+ * @param usersNum - Number of usernames in the array.
+ * @param count - How many series to recommend to each user.
+ * @param threadsNum - Number of threads that rank the series. With one
+ * thread nothing is done in parallel.
+ * @param outputStream - File to print to.
+ *
+ * @return
+ * MTMFLIX_SUCCESS - Successfully printed the recommendations.
+ * MTMFLIX_NULL_ARGUMENT - At least one of the given arguments (or one of
+ * the usernames) is NULL.
+ * MTMFLIX_ILLEGAL_NUMBER - A negative numer was inserted, or threadsNum
+ * is not positive.
+ * MTMFLIX_USER_DOES_NOT_EXIST - One of the users doesn't exist. Nothing is
+ * printed in this case.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ */
+MtmFlixResult mtmFlixGetRecommendationsParallel(MtmFlix mtmflix,
+                    const char** usernames, int usersNum, int count,
+                    int threadsNum, FILE* outputStream){
+    if(!mtmflix || !usernames || !outputStream){
+        return MTMFLIX_NULL_ARGUMENT;
+    }
+    if(usersNum<0 || count<0 || threadsNum<1){
+        return MTMFLIX_ILLEGAL_NUMBER;
+    }
+    if(threadsNum==1 || usersNum<2){
+        /* Nothing to split between threads. */
+        return mtmFlixGetRecommendationsBatch(mtmflix,usernames,usersNum,
+                                              count,outputStream);
+    }
+    if(threadsNum>usersNum){
+        threadsNum = usersNum;
+    }
+    struct recommendations_job_t job = {mtmflix,NULL,usersNum,
+            getRecommendationsCapacity(mtmflix,count),NULL,0};
+    job.users = malloc(sizeof(User)*usersNum);
+    job.recommendations = calloc(usersNum,sizeof(UserRecommendations));
+    pthread_t* threads = malloc(sizeof(pthread_t)*threadsNum);
+    MtmFlixResult result = MTMFLIX_OUT_OF_MEMORY;
+    if(job.users && job.recommendations && threads){
+        result = getUsersByUsernames(mtmflix,usernames,usersNum,job.users);
+    }
+    if(result!=MTMFLIX_SUCCESS){
+        free(job.users);
+        free(job.recommendations);
+        free(threads);
+        return result;
+    }
+    pthread_mutex_init(&job.lock,NULL);
+    pthread_cond_init(&job.user_ranked,NULL);
+    int threads_created = 0;
+    while(threads_created<threadsNum &&
+          pthread_create(&threads[threads_created],NULL,
+                         recommendationsWorker,&job)==0){
+        threads_created++;
+    }
+    /* Even if not all of the threads were created, the ones that were
+     * created rank all the users. Without threads, nothing was taken and
+     * the recommendations are printed serially. */
+    result = threads_created>0 ?
+             printJobRecommendations(&job,mtmflix->report_writer,
+                                     outputStream) :
+             mtmFlixGetRecommendationsBatch(mtmflix,usernames,usersNum,
+                                            count,outputStream);
+    for(int i=0;i<threads_created;i++){
+        pthread_join(threads[i],NULL);
+    }
+    for(int i=0;i<usersNum;i++){
+        free(job.recommendations[i].series);
+    }
+    pthread_cond_destroy(&job.user_ranked);
+    pthread_mutex_destroy(&job.lock);
+    free(job.users);
+    free(job.recommendations);
+    free(threads);
+    return result;
+}
+
+
+/** Rows: 15
+ ***** Function: mtmFlixSetRecommendationsCache *****
+ * Description: Turns the cache of printed recommendations on or off. A
+ * cached recommendation is printed again as long as nothing it depends on
+ * changed: the favorite series and the friends of the user, and the
+ * favorite series of his friends. Only mtmFlixGetRecommendations,
+ * mtmFlixGetRecommendationsWithThreads and mtmFlixGetRecommendationsBatch
+ * use the cache.
+ *
+ * @param mtmflix - Mtmflix we are working on.
+ * @param entriesNum - Number of recommendations the cache can keep, or 0
+ * to turn the cache off. Anything that was cached before is dropped.
+ *
+ * @return
+ * MTMFLIX_NULL_ARGUMENT - Mtmflix is NULL.
+ * MTMFLIX_ILLEGAL_NUMBER - EntriesNum is negative.
+ * MTMFLIX_OUT_OF_MEMORY - Failed to create the cache. The cache is off.
+ * MTMFLIX_SUCCESS - Cache set.
+ */
+MtmFlixResult mtmFlixSetRecommendationsCache(MtmFlix mtmflix,
+                                             int entriesNum){
+    if(!mtmflix){
+        return MTMFLIX_NULL_ARGUMENT;
+    }
+    if(entriesNum<0){
+        return MTMFLIX_ILLEGAL_NUMBER;
+    }
+    recommendationCacheDestroy(mtmflix->recommendations_cache);
+    mtmflix->recommendations_cache = NULL;
+    if(entriesNum==0){
+        return MTMFLIX_SUCCESS;
+    }
+    mtmflix->recommendations_cache = recommendationCacheCreate(entriesNum);
+    if(!mtmflix->recommendations_cache){
+        return MTMFLIX_OUT_OF_MEMORY;
     }
-    /* Recommendations printed successfully.*/
-    setDestroy(series_set_copy);
-    setDestroy(ranked_series_set);
     return MTMFLIX_SUCCESS;
 }
 
 
+/** Rows: 13
+ ***** Function: mtmFlixSetUserHot *****
+ * Description: Makes a user hot or not. A hot user keeps, for every series
+ * his friends love, how many of them love it. The counts are updated when
+ * his friends or their favorite series change, so his recommendations
+ * only finish the rank of each candidate with his current favorites.
+ * Meant for the most active users, since the counts take memory and make
+ * the changes of their friends slower.
+ *
+ * @param mtmflix - Mtmflix we are working on.
+ * @param username - The username of the user.
+ * @param hot - Whether the user should be hot.
+ *
+ * @return
+ * MTMFLIX_NULL_ARGUMENT - At least one of the given arguments is NULL.
+ * MTMFLIX_USER_DOES_NOT_EXIST - User with given username doesn't exist.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error. The user is not hot.
+ * MTMFLIX_SUCCESS - User changed.
+ */
+MtmFlixResult mtmFlixSetUserHot(MtmFlix mtmflix, const char* username,
+                                bool hot){
+    if(!mtmflix || !username){
+        return MTMFLIX_NULL_ARGUMENT;
+    }
+    MtmFlixResult result;
+    User user = getUserByUsername(mtmflix,username,&result);
+    if(result!=MTMFLIX_SUCCESS){
+        return result;
+    }
+    return userSetHot(user,hot,mtmflix->users_by_id);
+}
+
+
 //-----------------------------------------------------------------------//
 //                       MTMFLIX: STATIC FUNCTIONS                       //
 //-----------------------------------------------------------------------//
 
-/** Rows: 12
+/** Rows: 7
  ***** Static function: getUserByUsername *****
- * Description: Gets a name of user and a set of users.
- * Returns the user with that name in the given users set.
- *
- * Notice: This resets the iterator of given set.
+ * Description: Gets a name of user and returns the user with that name in
+ * the given mtmflix.
  *
+ * @param mtmflix - The mtmflix to look in.
  * @param username - Name of user we want to get.
  * @param result - Success/failure of the function.
- * @param users_set - Users set we are looking in.
  *
  * @return
- * MTMFLIX_OUT_OF_MEMORY - Any memory error.
  * MTMFLIX_SUCCESS - Sucess.
- * MTMFLIX_USER_DOES_NOT_EXIST - User does not exist in the given set.
- */
-static User getUserByUsername(char* username,MtmFlixResult* result,
-                              Set users_set){
-    /* Creating a temp user for comparison. */
-    User temp_user = userCreate(username,MTM_MIN_AGE+1);
-    if(!temp_user){
-        /* Couldn't create temp user. */
-        *result=MTMFLIX_OUT_OF_MEMORY;
+ * MTMFLIX_USER_DOES_NOT_EXIST - User does not exist in the mtmflix.
+ */
+static User getUserByUsername(MtmFlix mtmflix, const char* username,
+                              MtmFlixResult* result){
+    User user = userFindByName(mtmflix->users_index,username);
+    if(!user){
+        /* User with the given username does not exist. */
+        *result=MTMFLIX_USER_DOES_NOT_EXIST;
         return NULL;
     }
-    SET_FOREACH(SetElement,user,users_set){
-        if(userCompare(user,temp_user)==0){
-            /* We found the user with the given name. */
-            userDestroy(temp_user);
-            *result=MTMFLIX_SUCCESS;
-            return (User)user;
-        }
-    }
-    /* User with the given username does not exist in the given set. */
-    userDestroy(temp_user);
-    *result=MTMFLIX_USER_DOES_NOT_EXIST;
-    return NULL;
+    *result=MTMFLIX_SUCCESS;
+    return user;
 }
 
-/** Rows: 17
+/** Rows: 9
  ***** Static function: userAndSeriesExist *****
  * Description: Gets a mtmflix, a name of a user and a name of a series
  * and returns whether or not they exist in the given mtmflix.
@@ -860,7 +1660,6 @@ static User getUserByUsername(char* username,MtmFlixResult* result,
  * @param seriesName - A series name to check.
  *
  * @return
- * MTMFLIX_OUT_OF_MEMORY - Any memory error.
  * MTMFLIX_USER_DOES_NOT_EXIST - User doesn't exist in the mtmflix.
  * MTMFLIX_SERIES_DOES_NOT_EXIST - Series doesn't exist in
  * the mtmflix.
@@ -869,35 +1668,19 @@ static User getUserByUsername(char* username,MtmFlixResult* result,
 static MtmFlixResult userAndSeriesExist(MtmFlix mtmflix,
                                         const char *username,
                                         const char *seriesName){
-    User dummy_user = userCreate(username,MTM_MIN_AGE+1);
-    if(!dummy_user){
-        /* Memory allocation failed  */
-        return MTMFLIX_OUT_OF_MEMORY;
-    }
-    if(!setIsIn(mtmflix->users,(SetElement)dummy_user)){
+    if(!nameIndexContains(mtmflix->users_index,username)){
         /* User doesn't exist. */
-        userDestroy(dummy_user);
         return MTMFLIX_USER_DOES_NOT_EXIST;
     }
-    Series dummy_series = seriesCreate((char*)seriesName,1,HORROR,NULL,5);
-    if(!dummy_series){
-        /* Memory allocation failed  */
-        userDestroy(dummy_user);
-        return MTMFLIX_OUT_OF_MEMORY;
-    }
-    if(!setIsIn(mtmflix->series,(SetElement)dummy_series)){
+    if(!nameIndexContains(mtmflix->series_index,seriesName)){
         /* Series doesn't exist. */
-        userDestroy(dummy_user);
-        seriesDestroy(dummy_series);
         return MTMFLIX_SERIES_DOES_NOT_EXIST;
     }
     /* Both user and series exist. */
-    userDestroy(dummy_user);
-    seriesDestroy(dummy_series);
     return MTMFLIX_SUCCESS;
 }
 
-/** Rows: 15
+/** Rows: 6
  ***** Static function: usersExist *****
  * Description: Gets two usernames and checks if the users exist in
  * the mtmflix.
@@ -907,257 +1690,1814 @@ static MtmFlixResult userAndSeriesExist(MtmFlix mtmflix,
  * @param username2 - A username to check.
  *
  * @return
- * MTMFLIX_OUT_OF_MEMORY - Any memory error.
  * MTMFLIX_USER_DOES_NOT_EXIST - At least one users doesn't exist.
  * MTMFLIX_SUCCESS - Both of the users exist in the mtmflix.
  */
 static MtmFlixResult usersExist(MtmFlix mtmflix, const char* username1,
                                 const char* username2){
-    /* Creating temporary users for comparison. */
-    User dummy_user1 = userCreate(username1,MTM_MIN_AGE);
-    if(!dummy_user1){
-        return MTMFLIX_OUT_OF_MEMORY;;
-    }
-    User dummy_user2 = userCreate(username2,MTM_MIN_AGE);
-    if(!dummy_user2){
-        userDestroy(dummy_user1);
-        return MTMFLIX_OUT_OF_MEMORY;
-    }
-    if(!setIsIn(mtmflix->users,dummy_user1) ||
-       !setIsIn(mtmflix->users,dummy_user2)){
+    if(!nameIndexContains(mtmflix->users_index,username1) ||
+       !nameIndexContains(mtmflix->users_index,username2)){
         /* At least one user doesn't exist in the system. */
-        userDestroy(dummy_user1);
-        userDestroy(dummy_user2);
         return MTMFLIX_USER_DOES_NOT_EXIST;
-
     }
     /* Both users exist. */
-    userDestroy(dummy_user1);
-    userDestroy(dummy_user2);
     return MTMFLIX_SUCCESS;
 }
 
-/** rows: 27
- ***** Static function: rankSeriesAndAddToRankedSeriesSet *****
- * Description: Ranks the given series (single series) and inserts it to a
- * ranked series set.
- *
- * Notice: This resets the iterator of the series set and users set.
- *
- * @param users_set - Set of all the users in the mtmflix.
- * @param series_set - Set of all the series in the mtmflix.
- * @param user - User we want to rank according to.
- * @param series - Series we want to rank.
- * @param genre
- * @param function_status
- * @param ranked_series_set
- */
-static void rankSeriesAndAddToRankedSeriesSet(Set users_set,Set series_set,
-     User user,Series series, Genre genre, MtmFlixResult* function_status,
-                                                    Set ranked_series_set){
-    char* series_name = seriesGetName(series);
-    if(!series_name){
-        /* Failed to copy name. */
-        *function_status=MTMFLIX_OUT_OF_MEMORY;
-        return;
+/** Rows: 36
+ ***** Static function: recommendToUser *****
+ * Description: Prints the recommendations of a user with the recommender
+ * of the mtmflix. If they are in the cache they are printed from it and
+ * no series is ranked, else they are ranked and put in the cache.
+ *
+ * @param mtmflix - The mtmflix we are working in.
+ * @param user - User to recommend to.
+ * @param count - How many series to recommend.
+ * @param threadsNum - Maximal number of threads to rank with.
+ * @param outputStream - File to print to.
+ *
+ * @return
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - Recommendations printed.
+ */
+static MtmFlixResult recommendToUser(MtmFlix mtmflix, User user,
+                                     int count, int threadsNum,
+                                     FILE* outputStream){
+    RecommendationCache cache = mtmflix->recommendations_cache;
+    unsigned int id = userGetId(user);
+    unsigned int version = userGetRecommendationsVersion(user);
+    const char* text;
+    size_t length;
+    bool cached = cache && recommendationCacheFind(cache,id,count,version,
+                                                   &text,&length);
+    Recommender recommender = mtmflix->recommender;
+    if(!cached){
+        if(rankAllSeriesForUser(mtmflix,user,recommender,
+                                getRecommendationsCapacity(mtmflix,count),
+                                threadsNum)!=MTMFLIX_SUCCESS){
+            return MTMFLIX_OUT_OF_MEMORY;
+        }
+        /* The candidates were ranked already, so their array is reused for
+         * the best series. It has room for all the series. */
+        int series_num = rankedSeriesTakeSorted(recommender->ranked_series,
+                                                recommender->candidates);
+        if(!cache){
+            ReportWriter writer = mtmflix->report_writer;
+            reportWriterStart(writer,outputStream);
+            MtmFlixResult result = writeSeriesDetails(writer,
+                                                      recommender->candidates,
+                                                      series_num);
+            if(reportWriterFlush(writer)!=REPORT_WRITER_SUCCESS){
+                return MTMFLIX_OUT_OF_MEMORY;
+            }
+            return result;
+        }
+        if(recommendationCachePut(cache,id,count,version,
+                                  recommender->candidates,series_num)!=
+           RECOMMENDATION_CACHE_SUCCESS){
+            return MTMFLIX_OUT_OF_MEMORY;
+        }
+        recommendationCacheFind(cache,id,count,version,&text,&length);
     }
-    char* series_genre_string=getGenreNameByEnum(seriesGetGenre(series));
-    if(!series_genre_string){
-        free(series_name);
-        *function_status=MTMFLIX_OUT_OF_MEMORY;
-        return;
+    if(length>0 && fwrite(text,1,length,outputStream)!=length){
+        return MTMFLIX_OUT_OF_MEMORY;
     }
-    int rank=rankSeries(users_set,user,series_name,series,series_set,
-                        genre,function_status); // Ranking the series.
-    if(*function_status!=MTMFLIX_SUCCESS){
-        /* Failed to rank. */
-        free(series_name);
-        free(series_genre_string);
-        return;
+    return MTMFLIX_SUCCESS;
+}
+
+/** Rows: 8
+ ***** Static function: writeSeriesDetails *****
+ * Description: Adds the details of series to a report.
+ *
+ * @param writer - Report writer of the report.
+ * @param series - Array of the series, in the order they are printed.
+ * @param series_num - Number of series in the array.
+ *
+ * @return
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - All the series were added.
+ */
+static MtmFlixResult writeSeriesDetails(ReportWriter writer, Series* series,
+                                        int series_num){
+    for(int i=0;i<series_num;i++){
+        if(reportWriterWrite(writer,seriesGetDetails(series[i]))!=
+           REPORT_WRITER_SUCCESS){
+            return MTMFLIX_OUT_OF_MEMORY;
+        }
     }
-    /* Creating a ranked series and inserts it to the set
-     * of ranked series.*/
-    RankedSeries new_ranked_series = rankedSeriesCreate
-                                 (rank,series_name,series_genre_string);
-    free(series_name);
-    free(series_genre_string);
-    if(!new_ranked_series){
-        *function_status=MTMFLIX_OUT_OF_MEMORY;
-        return;
+    return MTMFLIX_SUCCESS;
+}
+
+/** Rows: 37
+ ***** Static function: rankAllSeriesForUser *****
+ * Description: Ranks all the relevant series for the given user, and
+ * keeps the best of them in the ranked series of the recommender. Only
+ * the series that are loved by at least one friend of the user, and whose
+ * genre is in his favorite list, are ranked. The mtmflix and the users are
+ * only read, so different threads may rank with different recommenders at
+ * the same time.
+ *
+ * @param mtmflix - The mtmflix we are working in.
+ * @param user - User that should rank according to.
+ * @param recommender - Recommender to rank with. Its ranked series is
+ * reset, and holds the best series when the function returns.
+ * @param capacity - How many series should be kept.
+ * @param threadsNum - Maximal number of threads to rank with. More threads
+ * are used only if there are enough candidate series for all of them, and
+ * never for hot users. When only some of the candidates are kept, every
+ * thread skips the candidates of its own part by their bounds.
+ *
+ * @return
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - All relevant series were ranked successfully.
+ */
+static MtmFlixResult rankAllSeriesForUser(MtmFlix mtmflix,User user,
+                                          Recommender recommender,
+                                          int capacity,int threadsNum){
+    if(rankedSeriesReset(recommender->ranked_series,capacity)!=
+       MTMFLIX_SUCCESS ||
+       recommenderPrepare(recommender,
+                          nameIndexGetSize(mtmflix->series_index),
+                          mtmflix->next_series_id)!=MTMFLIX_SUCCESS){
+        return MTMFLIX_OUT_OF_MEMORY;
     }
-    SetResult result = setAdd(ranked_series_set,new_ranked_series);
-    rankedSeriesDestroy(new_ranked_series); // Destroying copy.
-    if(result!=SET_SUCCESS){
-        *function_status=MTMFLIX_OUT_OF_MEMORY;
-        return;
+    LikeCounts friend_likes = userGetFriendLikes(user);
+    if(friend_likes){
+        /* A hot user keeps F of every candidate, only the rest of the
+         * rank is computed. */
+        int candidates_num = collectFriendLikes(friend_likes,recommender);
+        rankCandidates(mtmflix,user,recommender->candidates,
+                       recommender->candidate_ids,
+                       recommender->candidate_ranks,candidates_num,
+                       recommender->ranked_series);
+        return MTMFLIX_SUCCESS;
+    }
+    int candidates_num = collectCandidates(mtmflix,user,recommender);
+    /* When only some of the candidates are kept, most of them may be
+     * skipped without counting F. */
+    bool prune = capacity<candidates_num;
+    int threads_num = candidates_num/MIN_CANDIDATES_PER_SCORING_THREAD;
+    if(threads_num>threadsNum){
+        threads_num = threadsNum;
+    }
+    if(threads_num<2){
+        ScoringTask task = {mtmflix,user,recommender->candidates,
+                            recommender->candidate_ids,
+                            recommender->candidate_ranks,
+                            recommender->candidate_bounds,candidates_num,
+                            recommender->ranked_series,prune,false};
+        scoringWorker(&task);
+        return MTMFLIX_SUCCESS;
     }
+    return rankCandidatesInParallel(mtmflix,user,recommender,
+                                    candidates_num,capacity,prune,
+                                    threads_num);
 }
 
-/** rows: 3
- ***** Static function: doubleAbs *****
- * Description: Gets a number (double) and returns its distance from zero
- * AKA absolute value.
+/** Rows: 21
+ ***** Static function: collectCandidates *****
+ * Description: Puts the candidate series of the user, and their ids, in
+ * the candidates of the recommender. A series that no friend loves has
+ * F=0, so its rank is 0 and it is never recommended. Only the favorite
+ * series of the friends are candidates, and each of them is taken once
+ * thanks to the marks. Series with G=0 are not taken either, their rank
+ * is 0 too.
  *
- * @param number - Number we check.
+ * @param mtmflix - The mtmflix we are working in.
+ * @param user - User that the series are ranked for.
+ * @param recommender - Recommender prepared for the series of the mtmflix.
  *
  * @return
- * Distance of the number from zero.
+ * Number of candidate series.
  */
-static double doubleAbs (double number){
-    if(number<0){
-        return (-number);
+static int collectCandidates(MtmFlix mtmflix, User user,
+                             Recommender recommender){
+    int candidates_num = 0;
+    IdArray friend_ids = userGetFriendIds(user);
+    for(int i=0;i<idArrayGetSize(friend_ids);i++){
+        User friend=idIndexGet(mtmflix->users_by_id,
+                               idArrayGet(friend_ids,i));
+        assert(friend);
+        OrderedArray friend_series = userGetFavoriteSeries(friend);
+        for(int j=0;j<orderedArrayGetSize(friend_series);j++){
+            Series series = orderedArrayGet(friend_series,j);
+            unsigned int id = seriesGetId(series);
+            if(idMarksMark(recommender->marked_series,id) &&
+               userHowManySeriesWithGenre(user,seriesGetGenre(series))>0){
+                recommender->candidates[candidates_num] = series;
+                recommender->candidate_ids[candidates_num] = id;
+                candidates_num++;
+            }
+        }
     }
-    return number;
+    return candidates_num;
 }
 
-/** Rows: 19
- ***** Static function: rankSeries *****
- * Description: Ranks the given series according to the given user.
- *
- * @param users_set - Set of all users in the mtmflix.
- * @param user - User we want to rank the sereis according to.
- * @param series_name - Name of the series we want to rank. This will save
- * us the trouble of making another copy of the name of the series.
- * @param series - Series we want to rank.
- * @param series_set - Set of all the series in the mtmflix.
- * @param genre - Genre of the series we rank.
- * @param function_status - Will hold success/fail status of the function.
- *
- * @return
- * ILLEGAL_VALUE - In case of any error.
- * Else - The rank of the series.
- */
-static int rankSeries(Set users_set,User user,
-                      char* series_name,Series series,Set series_set,
-                      Genre genre,MtmFlixResult* function_status){
-    /* "G" - Checks how many series from user's favorite list has the same
-     * genre as the given series.*/
-    int same_genre = userHowManySeriesWithGenre(series_set,user,genre);
-    if(same_genre == ILLEGAL_VALUE){
-        /* Failed to check how many from the same genre. */
-        *function_status=MTMFLIX_OUT_OF_MEMORY;
-        return ILLEGAL_VALUE;
-    }
-    /* Creating a copy of the series set in order to not ruin the iterator
-     * for the caller function. */
-    Set series_set_copy = setCopy(series_set);
-    if(!series_set_copy){
-        return ILLEGAL_VALUE;
-    }
-    /* "L" - Checks the average episode duration of all of user's favorite
-     * series. */
-    double average_list_episode_duration=
-       userGetAverageEpisodeDuration(user,series_set_copy,function_status);
-    setDestroy(series_set_copy);
-    if(*function_status!=MTMFLIX_SUCCESS){
-        /* Failed to check average episode duration of all series in user's
-         * favorite series list. */
-        return ILLEGAL_VALUE;
-    }
-    /* "F" - Checks how many friends loved this series. */
-    int number_of_friends_loved_this_series=
-            howManyFriendsLovedThisSeries(users_set,user,series_name);
-    /* "CUR" - Checks current series episode duration. */
-    int current_series_episode_duration = seriesGetEpisodeDuration(series);
-    double rank=(same_genre*number_of_friends_loved_this_series);
-    rank/=(1+doubleAbs((double)current_series_episode_duration-
-                       (average_list_episode_duration)));
-    return (int)rank;
+/** Rows: 10
+ ***** Static function: collectFriendLikes *****
+ * Description: Puts the candidate series of a hot user, their ids and F
+ * in the candidates of the recommender. The candidates are the series his
+ * friends love, and F is already counted.
+ *
+ * @param friend_likes - How many friends of the user love each series.
+ * @param recommender - Recommender prepared for the series of the mtmflix.
+ *
+ * @return
+ * Number of candidate series.
+ */
+static int collectFriendLikes(LikeCounts friend_likes,
+                              Recommender recommender){
+    int candidates_num = likeCountsGetSize(friend_likes);
+    for(int i=0;i<candidates_num;i++){
+        Series series = likeCountsGetSeries(friend_likes,i);
+        recommender->candidates[i] = series;
+        recommender->candidate_ids[i] = seriesGetId(series);
+        recommender->candidate_ranks[i] = likeCountsGetCount(friend_likes,i);
+    }
+    return candidates_num;
+}
+
+/** Rows: 8
+ ***** Static function: countFriendsLoved *****
+ * Description: Counts F of candidate series: how many friends of the user
+ * loved each of them. The friends' ids are intersected with the ids of
+ * the users that liked the series.
+ *
+ * @param user - User that the series are ranked for.
+ * @param candidates - Array of the candidate series.
+ * @param friends_loved - Array to put F of every candidate in.
+ * @param candidates_num - Number of series in the arrays.
+ */
+static void countFriendsLoved(User user, Series* candidates,
+                              int* friends_loved, int candidates_num){
+    IdArray friend_ids = userGetFriendIds(user);
+    for(int i=0;i<candidates_num;i++){
+        friends_loved[i] = howManyFriendsLovedThisSeries(friend_ids,
+                                                         candidates[i]);
+    }
 }
 
 /** Rows: 18
- ***** Static function: seriesShouldBeRecommended *****
- * Description: Returns whether or not the given series should be ranked
- * for given user. The function checks if the user meet the age
- * requirements of the series, and if so, checks if the series is already
- * in his favorite list.
+ ***** Static function: rankCandidates *****
+ * Description: Ranks candidate series for the user and offers them to the
+ * given ranked series. The ranks are computed all together from the
+ * series columns, then the series that got a positive rank and are not
+ * already loved by the user are offered.
  *
- * @param series - Series we check.
- * @param user - User we check according to.
- * @param mtmflix - The mtmflix in which it all happens.
- * @param result - Will hold success/fail status of the function.
+ * @param mtmflix - The mtmflix we are working in.
+ * @param user - User that should rank according to.
+ * @param candidates - Array of the candidate series.
+ * @param ids - Array of the ids of the candidates.
+ * @param ranks - F of every candidate. Changed to its rank.
+ * @param candidates_num - Number of series in the arrays.
+ * @param ranked_series - Keeps the best ranked series.
+ */
+static void rankCandidates(MtmFlix mtmflix, User user, Series* candidates,
+                           unsigned int* ids, int* ranks,
+                           int candidates_num, RankedSeries ranked_series){
+    int genre_counts[NUMBER_OF_GENRES];
+    getGenreCounts(user,genre_counts);
+    seriesColumnsRank(mtmflix->series_columns,ids,ranks,candidates_num,
+                      genre_counts,userGetAverageEpisodeDuration(user),
+                      userGetAge(user));
+    for(int i=0;i<candidates_num;i++){
+        /* A series that is already in the user's favorite list shouldn't
+         * be recommended. */
+        if(ranks[i]>0 &&
+           !isInUsersFavoriteSeriesList(user,
+                                        (char*)seriesGetName(candidates[i]))){
+            rankedSeriesOffer(ranked_series,ranks[i],candidates[i]);
+        }
+    }
+}
+
+/** Rows: 49
+ ***** Static function: rankCandidatesByBounds *****
+ * Description: Ranks the candidate series of a scoring task in the order
+ * of an upper bound of their ranks, and stops as soon as the bound is
+ * lower than any rank the ranked series would still keep. No more than
+ * min(number of friends, number of users that loved the series) friends
+ * could have loved a series, so the bound is the rank with this F. It is
+ * as cheap as the rest of the rank, while the real F is an intersection.
+ * The bounds are not sorted: they are made a heap in linear time, and
+ * only the candidates that are ranked are taken out of it.
  *
- * @return
+ * @param task - The scoring task whose candidates are ranked. Keeps the
+ * best series in its ranked series.
  */
-static bool seriesShouldBeRecommended(Series series,User user,
-                                      MtmFlix mtmflix,
-                                      MtmFlixResult* result) {
-    char *series_name = seriesGetName(series); //todo: free series_name
-    if (!series_name) {
-        *result=MTMFLIX_OUT_OF_MEMORY;
-        return false;
+static void rankCandidatesByBounds(ScoringTask* task){
+    Series* candidates = task->candidates;
+    unsigned int* ids = task->ids;
+    int* ranks = task->ranks;
+    IdArray friend_ids = userGetFriendIds(task->user);
+    int friends_num = idArrayGetSize(friend_ids);
+    for(int i=0;i<task->candidates_num;i++){
+        int likers_num = idArrayGetSize(seriesGetLikedBy(candidates[i]));
+        ranks[i] = likers_num<friends_num ? likers_num : friends_num;
+    }
+    int genre_counts[NUMBER_OF_GENRES];
+    getGenreCounts(task->user,genre_counts);
+    double average_duration = userGetAverageEpisodeDuration(task->user);
+    int age = userGetAge(task->user);
+    SeriesColumns columns = task->mtmflix->series_columns;
+    /* The rank grows with F, so ranking with the biggest F possible gives
+     * a bound. Series that are not allowed for the user get 0. */
+    seriesColumnsRank(columns,ids,ranks,task->candidates_num,genre_counts,
+                      average_duration,age);
+    CandidateBound* bounds = task->bounds;
+    int bounds_num = 0;
+    for(int i=0;i<task->candidates_num;i++){
+        if(ranks[i]>0){
+            bounds[bounds_num] = (CandidateBound){ranks[i],i};
+            bounds_num++;
+        }
     }
-    SeriesResult status;
-    /* Checking age limitations of series vs user's age. */
-    bool user_can_watch=userCanWatchSeries(mtmflix, user, series,&status);
-    if(status!=SERIES_SUCCESS){
-        /* UserCanWatch failed. */
-        free(series_name);
-        *result = MTMFLIX_OUT_OF_MEMORY;
-        free(series_name);
-        return false;
+    for(int i=bounds_num/2-1;i>=0;i--){
+        siftCandidateBoundDown(bounds,bounds_num,i);
+    }
+    while(bounds_num>0 &&
+          bounds[0].bound>=rankedSeriesGetMinimalRank(task->ranked_series)){
+        /* Any other bound is not higher, so they could only be kept after
+         * this one was ranked. */
+        int candidate = bounds[0].candidate;
+        bounds_num--;
+        bounds[0] = bounds[bounds_num];
+        siftCandidateBoundDown(bounds,bounds_num,0);
+        int rank = howManyFriendsLovedThisSeries(friend_ids,
+                                                 candidates[candidate]);
+        seriesColumnsRank(columns,&ids[candidate],&rank,1,genre_counts,
+                          average_duration,age);
+        if(rank>0 &&
+           !isInUsersFavoriteSeriesList(task->user,
+                                (char*)seriesGetName(candidates[candidate]))){
+            rankedSeriesOffer(task->ranked_series,rank,candidates[candidate]);
+        }
     }
-    if ((isInUsersFavoriteSeriesList(user, series_name))||!user_can_watch){
-        /*If we get here the series is already in the user's favorite
-          series list or the user's age is not in the range of age
-          limitations of the series. This series shouldn't be
-          recommended*/
-        free(series_name);
-        *result=MTMFLIX_SUCCESS;
-        return false;
+}
+
+/** Rows: 16
+ ***** Static function: siftCandidateBoundDown *****
+ * Description: Moves a candidate bound down a heap of bounds, the highest
+ * bound on top, until it is not lower than any of its children.
+ *
+ * @param bounds - The heap of bounds.
+ * @param bounds_num - Number of bounds in the heap.
+ * @param position - Position of the bound to move.
+ */
+static void siftCandidateBoundDown(CandidateBound* bounds, int bounds_num,
+                                   int position){
+    CandidateBound bound = bounds[position];
+    while(2*position+1<bounds_num){
+        int child = 2*position+1;
+        if(child+1<bounds_num && bounds[child+1].bound>bounds[child].bound){
+            child++;
+        }
+        if(bounds[child].bound<=bound.bound){
+            break;
+        }
+        bounds[position] = bounds[child];
+        position = child;
     }
-    /* User meets age requirements and also doesn't have the series in his
-     * favorite list. This mean that the given series should be ranked. */
-    free(series_name);
-    *result=MTMFLIX_SUCCESS;
-    return true;
+    bounds[position] = bound;
 }
 
-/** Rows: 18
- ***** Static function: rankAllSeriesForUser *****
- * Description: Makes the ranking of all the relevant series for the given
- * user and prints it to the give file.
+/** Rows: 5
+ ***** Static function: getGenreCounts *****
+ * Description: Gets "G" of every genre: how many series of the genre the
+ * user loves. The counts are kept up to date by the user.
+ *
+ * @param user - User to count for.
+ * @param genre_counts - Array to put the counts in, indexed by genre.
+ */
+static void getGenreCounts(User user, int* genre_counts){
+    for(int genre=0;genre<NUMBER_OF_GENRES;genre++){
+        genre_counts[genre] = userHowManySeriesWithGenre(user,(Genre)genre);
+    }
+}
+
+/** Rows: 44
+ ***** Static function: rankCandidatesInParallel *****
+ * Description: Splits the candidate series of the recommender to parts,
+ * and ranks each part in its own thread with its own ranked series. The
+ * calling thread ranks the first part into the ranked series of the
+ * recommender, and merges the other parts into it at the end. A part that
+ * no thread could be created for is ranked by the calling thread. The best
+ * series of all are among the best series of the parts, so each part may
+ * skip its own candidates by their bounds.
  *
  * @param mtmflix - The mtmflix we are working in.
  * @param user - User that should rank according to.
- * @param ranked_series_set - Set of ranked series.
- * @param outputStream - File to print to the ranked series.
- * @param count - How many series to print from each genre.
- * @param series_set - a copy of all the series in the mtmflix. This is
- * in order to not ruin the iterator for the caller function.
+ * @param recommender - Recommender whose candidates are ranked.
+ * @param candidates_num - Number of candidates of the recommender.
+ * @param capacity - How many series should be kept.
+ * @param prune - Whether the candidates are skipped by their bounds.
+ * @param threadsNum - Number of parts to split the candidates to.
  *
  * @return
  * MTMFLIX_OUT_OF_MEMORY - Any memory error.
- * MTMFLIX_SUCCESS - All relevant series were ranked and printed
- * successfully.
+ * MTMFLIX_SUCCESS - All the candidates were ranked successfully.
  */
-static MtmFlixResult rankAllSeriesForUser(MtmFlix mtmflix,User user,
-       Set ranked_series_set,FILE* outputStream, int count,Set series_set){
-    MtmFlixResult result;
-    SET_FOREACH(SetElement,series,mtmflix->series){
-        if(!seriesShouldBeRecommended(series,user,mtmflix,&result)) {
-            if(result!=MTMFLIX_SUCCESS) {
-                return MTMFLIX_OUT_OF_MEMORY;
-            }
-            /* Series shouldn't be recommended. */
-            continue;
+static MtmFlixResult rankCandidatesInParallel(MtmFlix mtmflix, User user,
+                                              Recommender recommender,
+                                              int candidates_num,
+                                              int capacity, bool prune,
+                                              int threadsNum){
+    ScoringTask* tasks = malloc(sizeof(ScoringTask)*threadsNum);
+    pthread_t* threads = malloc(sizeof(pthread_t)*threadsNum);
+    if(!tasks || !threads){
+        free(tasks);
+        free(threads);
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    MtmFlixResult result = MTMFLIX_SUCCESS;
+    int tasks_num = 0;
+    while(tasks_num<threadsNum){
+        int start = (int)((long long)candidates_num*tasks_num/threadsNum);
+        int end = (int)((long long)candidates_num*(tasks_num+1)/threadsNum);
+        ScoringTask* task = &tasks[tasks_num];
+        *task = (ScoringTask){mtmflix,user,recommender->candidates+start,
+                              recommender->candidate_ids+start,
+                              recommender->candidate_ranks+start,
+                              recommender->candidate_bounds+start,end-start,
+                              tasks_num==0 ? recommender->ranked_series :
+                              rankedSeriesCreate(capacity),prune,false};
+        if(!task->ranked_series){
+            result = MTMFLIX_OUT_OF_MEMORY;
+            break;
         }
-        if(result!=MTMFLIX_SUCCESS) {
-            return MTMFLIX_OUT_OF_MEMORY;
+        task->in_thread = tasks_num>0 &&
+                pthread_create(&threads[tasks_num],NULL,scoringWorker,
+                               task)==0;
+        tasks_num++;
+    }
+    for(int i=0;i<tasks_num;i++){
+        if(!tasks[i].in_thread){
+            scoringWorker(&tasks[i]);
         }
-        /*If we got here the current series should be added to the set of
-         * recommended series */
-        rankSeriesAndAddToRankedSeriesSet(mtmflix->users,series_set,
-                                          user,series,
-                                          seriesGetGenre(series),
-                                          &result,ranked_series_set);
-        if(result!=MTMFLIX_SUCCESS){
-            return MTMFLIX_OUT_OF_MEMORY;
+    }
+    for(int i=0;i<tasks_num;i++){
+        if(tasks[i].in_thread){
+            pthread_join(threads[i],NULL);
+        }
+        if(i>0){
+            rankedSeriesMerge(recommender->ranked_series,
+                              tasks[i].ranked_series);
+            rankedSeriesDestroy(tasks[i].ranked_series);
         }
     }
-    rankedSeriesPrintToFile(count,ranked_series_set,outputStream,&result);
-    if(result!=MTMFLIX_SUCCESS){
-        return MTMFLIX_OUT_OF_MEMORY;
+    free(tasks);
+    free(threads);
+    return result;
+}
+
+/** Rows: 10
+ ***** Static function: scoringWorker *****
+ * Description: Counts F of the candidates of a scoring task and ranks
+ * them, or ranks them by their bounds if the task prunes. The function of
+ * the threads of rankCandidatesInParallel.
+ *
+ * @param task - The scoring task to rank.
+ *
+ * @return
+ * NULL.
+ */
+static void* scoringWorker(void* task){
+    ScoringTask* scoring_task = task;
+    if(scoring_task->prune){
+        rankCandidatesByBounds(scoring_task);
+        return NULL;
     }
-    return MTMFLIX_SUCCESS;
-}
\ No newline at end of file
+    countFriendsLoved(scoring_task->user,scoring_task->candidates,
+                      scoring_task->ranks,scoring_task->candidates_num);
+    rankCandidates(scoring_task->mtmflix,scoring_task->user,
+                   scoring_task->candidates,scoring_task->ids,
+                   scoring_task->ranks,scoring_task->candidates_num,
+                   scoring_task->ranked_series);
+    return NULL;
+}
+
+/** Rows: 35
+ ***** Static function: createSnapshot *****
+ * Description: Creates a snapshot of a mtmflix. The series get positions
+ * in the order of their genres and names, and the users in the order of
+ * their names.
+ *
+ * @param mtmflix - The mtmflix to take a snapshot of.
+ * @param user_positions - Array to put the position of every user in, by
+ * his id.
+ * @param series_positions - Array to put the position of every series in,
+ * by its id.
+ *
+ * @return
+ * The new snapshot or NULL in case of memory error.
+ */
+static Snapshot createSnapshot(MtmFlix mtmflix,
+                               unsigned int* user_positions,
+                               unsigned int* series_positions){
+    size_t names_size = 0;
+    size_t series_num = 0;
+    for(int position=0;position<NUMBER_OF_GENRES;position++){
+        OrderedArray genre_series = mtmflix->series[position];
+        for(int i=0;i<orderedArrayGetSize(genre_series);i++){
+            Series series = orderedArrayGet(genre_series,i);
+            names_size += strlen(seriesGetName(series))+1;
+            series_positions[seriesGetId(series)] = (unsigned int)series_num;
+            series_num++;
+        }
+    }
+    size_t friends_num = 0;
+    size_t favorites_num = 0;
+    int users_num = orderedArrayGetSize(mtmflix->users);
+    for(int i=0;i<users_num;i++){
+        User user = orderedArrayGet(mtmflix->users,i);
+        names_size += strlen(userGetUsername(user))+1;
+        friends_num += idArrayGetSize(userGetFriendIds(user));
+        favorites_num += orderedArrayGetSize(userGetFavoriteSeries(user));
+        user_positions[userGetId(user)] = (unsigned int)i;
+    }
+    Snapshot snapshot = snapshotCreate(series_num,(size_t)users_num,
+                                       names_size,friends_num,favorites_num);
+    if(!snapshot){
+        return NULL;
+    }
+    size_t names_end = 0;
+    fillSnapshotSeries(mtmflix,snapshot,&names_end);
+    fillSnapshotUsers(mtmflix,snapshot,names_end,user_positions,
+                      series_positions);
+    return snapshot;
+}
+
+/** Rows: 24
+ ***** Static function: fillSnapshotSeries *****
+ * Description: Fills the series records of a snapshot, and puts their
+ * names in the names table.
+ *
+ * @param mtmflix - The mtmflix the snapshot is taken of.
+ * @param snapshot - Snapshot created for the mtmflix.
+ * @param names_end - Where the names of the series start in the table.
+ * Updated to where they end.
+ */
+static void fillSnapshotSeries(MtmFlix mtmflix, Snapshot snapshot,
+                               size_t* names_end){
+    char* names = snapshotGetNames(snapshot);
+    SnapshotSeries* record = snapshotGetSeries(snapshot);
+    for(int position=0;position<NUMBER_OF_GENRES;position++){
+        OrderedArray genre_series = mtmflix->series[position];
+        for(int i=0;i<orderedArrayGetSize(genre_series);i++){
+            Series series = orderedArrayGet(genre_series,i);
+            const char* name = seriesGetName(series);
+            record->name = (uint32_t)*names_end;
+            record->genre = (uint32_t)seriesGetGenre(series);
+            record->episodes_num = (uint32_t)seriesGetEpisodesNum(series);
+            record->episodes_duration =
+                    (uint32_t)seriesGetEpisodeDuration(series);
+            record->has_age_limit = seriesHasAgeRestrictions(series) ? 1 : 0;
+            record->min_age = (uint32_t)seriesGetMinAge(series);
+            record->max_age = (uint32_t)seriesGetMaxAge(series);
+            record++;
+            strcpy(names+*names_end,name);
+            *names_end += strlen(name)+1;
+        }
+    }
+}
+
+/** Rows: 33
+ ***** Static function: fillSnapshotUsers *****
+ * Description: Fills the user records of a snapshot, puts their names in
+ * the names table, and their friends and favorite series in their
+ * sections. The friends of every user are sorted by their positions, and
+ * the favorite series are kept in the order of their names.
+ *
+ * @param mtmflix - The mtmflix the snapshot is taken of.
+ * @param snapshot - Snapshot created for the mtmflix.
+ * @param names_end - Where the names of the users start in the table.
+ * @param user_positions - Position of every user, by his id.
+ * @param series_positions - Position of every series, by its id.
+ */
+static void fillSnapshotUsers(MtmFlix mtmflix, Snapshot snapshot,
+                              size_t names_end,
+                              const unsigned int* user_positions,
+                              const unsigned int* series_positions){
+    char* names = snapshotGetNames(snapshot);
+    SnapshotUser* records = snapshotGetUsers(snapshot);
+    uint32_t* friends = snapshotGetFriends(snapshot);
+    uint32_t* favorites = snapshotGetFavorites(snapshot);
+    uint32_t friends_end = 0;
+    uint32_t favorites_end = 0;
+    for(int i=0;i<orderedArrayGetSize(mtmflix->users);i++){
+        User user = orderedArrayGet(mtmflix->users,i);
+        IdArray friend_ids = userGetFriendIds(user);
+        int friends_num = idArrayGetSize(friend_ids);
+        for(int j=0;j<friends_num;j++){
+            friends[friends_end+j] = user_positions[idArrayGet(friend_ids,j)];
+        }
+        qsort(friends+friends_end,(size_t)friends_num,sizeof(uint32_t),
+              compareSnapshotPositions);
+        friends_end += (uint32_t)friends_num;
+        OrderedArray favorite_series = userGetFavoriteSeries(user);
+        for(int j=0;j<orderedArrayGetSize(favorite_series);j++){
+            Series series = orderedArrayGet(favorite_series,j);
+            favorites[favorites_end] = series_positions[seriesGetId(series)];
+            favorites_end++;
+        }
+        const char* name = userGetUsername(user);
+        records[i].name = (uint32_t)names_end;
+        records[i].age = (uint32_t)userGetAge(user);
+        records[i].friends_end = friends_end;
+        records[i].favorites_end = favorites_end;
+        strcpy(names+names_end,name);
+        names_end += strlen(name)+1;
+    }
+}
+
+/** Rows: 8
+ ***** Static function: compareSnapshotPositions *****
+ * Description: Compares positions in a snapshot for qsort, the lowest
+ * first.
+ *
+ * @param position1 - A position to compare.
+ * @param position2 - A position to compare.
+ *
+ * @return
+ * A negative integer if position1 is lower, a positive integer if
+ * position2 is lower, else 0.
+ */
+static int compareSnapshotPositions(const void* position1,
+                                    const void* position2){
+    uint32_t first = *(const uint32_t*)position1;
+    uint32_t second = *(const uint32_t*)position2;
+    if(first!=second){
+        return first<second ? -1 : 1;
+    }
+    return 0;
+}
+
+/** Rows: 19
+ ***** Static function: loadSnapshotSeries *****
+ * Description: Builds the series of an empty mtmflix from the records of
+ * a snapshot, in the order they are kept in. Every series gets its
+ * position as its id, and is put in the columns, the index and the array
+ * of its genre. The records are sorted by genre and then by name, so the
+ * arrays of the genres are only appended to.
+ *
+ * @param mtmflix - The mtmflix to load to. Has no series.
+ * @param snapshot - Snapshot to load.
+ * @param series_by_position - Array to put every series in, at its
+ * position.
+ *
+ * @return
+ * MTMFLIX_CANNOT_OPEN_FILE - A series of the snapshot is not valid, or
+ * the series are not sorted.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - All the series were loaded.
+ */
+static MtmFlixResult loadSnapshotSeries(MtmFlix mtmflix, Snapshot snapshot,
+                                        Series* series_by_position){
+    assert(mtmflix->next_series_id==0);
+    char* names = snapshotGetNames(snapshot);
+    SnapshotSeries* records = snapshotGetSeries(snapshot);
+    for(size_t i=0;i<snapshotGetSeriesNum(snapshot);i++){
+        const char* name = names+records[i].name;
+        MtmFlixResult result = loadOneSnapshotSeries(mtmflix,name,
+                                                     &records[i]);
+        if(result!=MTMFLIX_SUCCESS){
+            return result;
+        }
+        /* The id of the series is its position. */
+        series_by_position[i] = seriesFindByName(mtmflix->series_index,name);
+        assert(seriesGetId(series_by_position[i])==i);
+        mtmflix->next_series_id++;
+    }
+    return MTMFLIX_SUCCESS;
+}
+
+/** Rows: 40
+ ***** Static function: loadOneSnapshotSeries *****
+ * Description: Builds a series from its record in a snapshot, with the
+ * next series id of the mtmflix, and puts it in the columns, the index and
+ * the array of its genre, after the series that were loaded before it.
+ *
+ * @param mtmflix - The mtmflix to load to.
+ * @param name - Name of the series, in the snapshot.
+ * @param record - Record of the series.
+ *
+ * @return
+ * MTMFLIX_CANNOT_OPEN_FILE - The series is not valid or not after the
+ * series before it.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - Series loaded.
+ */
+static MtmFlixResult loadOneSnapshotSeries(MtmFlix mtmflix, const char* name,
+                                           const SnapshotSeries* record){
+    if(record->genre>=NUMBER_OF_GENRES || !nameIsValid(name) ||
+       record->episodes_num<1 || record->episodes_num>INT_MAX ||
+       record->episodes_duration<1 || record->episodes_duration>INT_MAX ||
+       nameIndexContains(mtmflix->series_index,name)){
+        return MTMFLIX_CANNOT_OPEN_FILE;
+    }
+    char* interned_name = stringPoolIntern(mtmflix->names,name);
+    if(!interned_name){
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    int ages[2] = {(int)record->min_age,(int)record->max_age};
+    Series series = seriesCreate(mtmflix->series_slab,interned_name,
+                                 (int)record->episodes_num,
+                                 (Genre)record->genre,
+                                 record->has_age_limit ? ages : NULL,
+                                 (int)record->episodes_duration,
+                                 mtmflix->next_series_id);
+    /* The series keeps its own reference to the name. */
+    stringPoolRelease(interned_name);
+    if(!series){
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    if(seriesColumnsPut(mtmflix->series_columns,series)!=
+       SERIES_COLUMNS_SUCCESS ||
+       nameIndexInsert(mtmflix->series_index,series)!=NAME_INDEX_SUCCESS){
+        seriesDestroy(series);
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    OrderedArrayResult result = orderedArrayAppend(
+            getGenreSeries(mtmflix,(Genre)record->genre),series);
+    if(result!=ORDERED_ARRAY_SUCCESS){
+        /* The index destroys the series. */
+        nameIndexRemove(mtmflix->series_index,name);
+        return result==ORDERED_ARRAY_OUT_OF_ORDER ? MTMFLIX_CANNOT_OPEN_FILE :
+               MTMFLIX_OUT_OF_MEMORY;
+    }
+    return MTMFLIX_SUCCESS;
+}
+
+/** Rows: 27
+ ***** Static function: loadSnapshotUsers *****
+ * Description: Builds the users of a mtmflix that has only the series of
+ * a snapshot from the records of the snapshot, with their favorite series
+ * but without their friends. Every user gets his position as his id. The
+ * records are sorted by name, so the array of the users is only appended
+ * to. Nobody has friends yet, so no follower has to be updated.
+ *
+ * @param mtmflix - The mtmflix to load to. Has no users.
+ * @param snapshot - Snapshot to load.
+ * @param series_by_position - Every series of the mtmflix, at its
+ * position in the snapshot.
+ *
+ * @return
+ * MTMFLIX_CANNOT_OPEN_FILE - A user of the snapshot is not valid, or the
+ * users are not sorted.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - All the users were loaded.
+ */
+static MtmFlixResult loadSnapshotUsers(MtmFlix mtmflix, Snapshot snapshot,
+                                       Series* series_by_position){
+    assert(mtmflix->next_user_id==0);
+    char* names = snapshotGetNames(snapshot);
+    SnapshotUser* records = snapshotGetUsers(snapshot);
+    uint32_t favorites_start = 0;
+    for(size_t i=0;i<snapshotGetUsersNum(snapshot);i++){
+        MtmFlixResult result = loadOneSnapshotUser(mtmflix,
+                                                   names+records[i].name,
+                                                   records[i].age);
+        if(result!=MTMFLIX_SUCCESS){
+            return result;
+        }
+        /* The id of the user is his position. */
+        User user = idIndexGet(mtmflix->users_by_id,(unsigned int)i);
+        assert(user);
+        mtmflix->next_user_id++;
+        result = loadSnapshotFavorites(snapshot,user,series_by_position,
+                                       favorites_start,
+                                       records[i].favorites_end);
+        if(result!=MTMFLIX_SUCCESS){
+            return result;
+        }
+        favorites_start = records[i].favorites_end;
+    }
+    return MTMFLIX_SUCCESS;
+}
+
+/** Rows: 36
+ ***** Static function: loadOneSnapshotUser *****
+ * Description: Builds a user from his record in a snapshot, with the next
+ * user id of the mtmflix, and puts him in the index, the array of the
+ * users after the users that were loaded before him, and the index of the
+ * ids.
+ *
+ * @param mtmflix - The mtmflix to load to.
+ * @param name - Name of the user, in the snapshot.
+ * @param age - Age of the user.
+ *
+ * @return
+ * MTMFLIX_CANNOT_OPEN_FILE - The user is not valid or not after the user
+ * before him.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - User loaded.
+ */
+static MtmFlixResult loadOneSnapshotUser(MtmFlix mtmflix, const char* name,
+                                         uint32_t age){
+    if(!nameIsValid(name) || age<MTM_MIN_AGE || age>MTM_MAX_AGE ||
+       nameIndexContains(mtmflix->users_index,name)){
+        return MTMFLIX_CANNOT_OPEN_FILE;
+    }
+    char* interned_name = stringPoolIntern(mtmflix->names,name);
+    if(!interned_name){
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    User user = userCreate(mtmflix->users_slab,interned_name,(int)age,
+                           mtmflix->next_user_id);
+    /* The user keeps his own reference to the name. */
+    stringPoolRelease(interned_name);
+    if(!user){
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    if(nameIndexInsert(mtmflix->users_index,user)!=NAME_INDEX_SUCCESS){
+        userDestroy(user);
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    OrderedArrayResult result = orderedArrayAppend(mtmflix->users,user);
+    if(result!=ORDERED_ARRAY_SUCCESS){
+        /* The index destroys the user. */
+        nameIndexRemove(mtmflix->users_index,name);
+        return result==ORDERED_ARRAY_OUT_OF_ORDER ? MTMFLIX_CANNOT_OPEN_FILE :
+               MTMFLIX_OUT_OF_MEMORY;
+    }
+    if(idIndexPut(mtmflix->users_by_id,mtmflix->next_user_id,user)!=
+       ID_INDEX_SUCCESS){
+        orderedArrayRemove(mtmflix->users,user);
+        nameIndexRemove(mtmflix->users_index,name);
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    return MTMFLIX_SUCCESS;
+}
+
+/** Rows: 19
+ ***** Static function: loadSnapshotFavorites *****
+ * Description: Adds the favorite series of a user from a snapshot. They
+ * are kept sorted by name, like the favorite series of the user, so they
+ * are only appended and none of them is there twice.
+ *
+ * @param snapshot - Snapshot to load.
+ * @param user - The user, without favorite series and friends yet.
+ * @param series_by_position - Every series of the mtmflix, at its
+ * position in the snapshot.
+ * @param start - Where his favorite series start in the snapshot.
+ * @param end - Where his favorite series end in the snapshot.
+ *
+ * @return
+ * MTMFLIX_CANNOT_OPEN_FILE - A favorite series of the user is not valid,
+ * or the favorite series are not sorted.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - All the favorite series were added.
+ */
+static MtmFlixResult loadSnapshotFavorites(Snapshot snapshot, User user,
+                                           Series* series_by_position,
+                                           uint32_t start, uint32_t end){
+    uint32_t* favorites = snapshotGetFavorites(snapshot);
+    const char* previous_name = NULL;
+    for(uint32_t i=start;i<end;i++){
+        Series series = series_by_position[favorites[i]];
+        const char* name = seriesGetName(series);
+        if(!userCanWatchSeries(user,series) ||
+           (previous_name && strcmp(previous_name,name)>=0)){
+            return MTMFLIX_CANNOT_OPEN_FILE;
+        }
+        if(userAddFavoriteSeries(user,series)!=MTMFLIX_SUCCESS){
+            return MTMFLIX_OUT_OF_MEMORY;
+        }
+        previous_name = name;
+    }
+    return MTMFLIX_SUCCESS;
+}
+
+/** Rows: 20
+ ***** Static function: loadSnapshotFriends *****
+ * Description: Adds the friends of all the users from a snapshot, to a
+ * mtmflix that has all its users. The friends of every user are kept
+ * sorted by position, which is their id, so they are only appended.
+ *
+ * @param mtmflix - The mtmflix to load to.
+ * @param snapshot - Snapshot to load.
+ *
+ * @return
+ * MTMFLIX_CANNOT_OPEN_FILE - A user is his own friend, or the friends of a
+ * user are not sorted.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - All the friends were added.
+ */
+static MtmFlixResult loadSnapshotFriends(MtmFlix mtmflix, Snapshot snapshot){
+    SnapshotUser* records = snapshotGetUsers(snapshot);
+    uint32_t* friends = snapshotGetFriends(snapshot);
+    uint32_t friends_start = 0;
+    for(size_t i=0;i<snapshotGetUsersNum(snapshot);i++){
+        User user = idIndexGet(mtmflix->users_by_id,(unsigned int)i);
+        for(uint32_t j=friends_start;j<records[i].friends_end;j++){
+            if(friends[j]==i || (j>friends_start && friends[j]<=friends[j-1])){
+                /* A user is not his own friend, nor twice a friend. */
+                return MTMFLIX_CANNOT_OPEN_FILE;
+            }
+            if(userAddFriend(user,idIndexGet(mtmflix->users_by_id,
+                                             friends[j]))!=MTMFLIX_SUCCESS){
+                return MTMFLIX_OUT_OF_MEMORY;
+            }
+        }
+        friends_start = records[i].friends_end;
+    }
+    return MTMFLIX_SUCCESS;
+}
+
+/** Rows: 25
+ ***** Static function: prepareJournalChange *****
+ * Description: Prepares the journal record of a change before the change
+ * is made, if the mtmflix is journaled, so it can be journaled once it is
+ * made without failing.
+ *
+ * @param mtmflix - The mtmflix that is changed.
+ * @param operation - The change.
+ * @param name1 - Name of the user or series that is changed.
+ * @param name2 - Name of the second user or series, NULL if there is none.
+ * @param values - Numbers of the change.
+ * @param values_num - Number of the numbers.
+ *
+ * @return
+ * MTMFLIX_CANNOT_OPEN_FILE - A commit of the journal failed before, and
+ * committing it again failed too.
+ * MTMFLIX_OUT_OF_MEMORY - Failed to prepare the record.
+ * MTMFLIX_SUCCESS - Record prepared, or mtmflix is not journaled.
+ */
+static MtmFlixResult prepareJournalChange(MtmFlix mtmflix,
+                                          JournalOperation operation,
+                                          const char* name1,
+                                          const char* name2,
+                                          const int* values, int values_num){
+    if(!mtmflix->journal_path){
+        /* The changes of this mtmflix are not journaled. */
+        return MTMFLIX_SUCCESS;
+    }
+    if(mtmflix->journal_failed){
+        /* A change is made only if the changes before it can be kept. */
+        if(journalCommit(mtmflix->journal)!=JOURNAL_SUCCESS){
+            return MTMFLIX_CANNOT_OPEN_FILE;
+        }
+        mtmflix->journal_failed = false;
+    }
+    JournalRecord record = {operation,{name1,name2},name2 ? 2 : 1,{0},
+                            values_num};
+    for(int i=0;i<values_num;i++){
+        record.values[i] = values[i];
+    }
+    if(journalPrepare(mtmflix->journal,&record)!=JOURNAL_SUCCESS){
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    return MTMFLIX_SUCCESS;
+}
+
+/** Rows: 19
+ ***** Static function: addJournalChange *****
+ * Description: Journals a change that was made, with the record that was
+ * prepared for it, and writes a checkpoint when enough changes were
+ * journaled since the last one. If the journal cannot be written, the
+ * record stays in it and is written by the next commit that succeeds,
+ * and no other change is made until then. A checkpoint that cannot be
+ * written loses nothing, since the mtmflix keeps its old checkpoint and
+ * journal, and it is tried again only after checkpoint_every more
+ * changes.
+ *
+ * @param mtmflix - The mtmflix that was changed.
+ *
+ * @return
+ * MTMFLIX_CANNOT_OPEN_FILE - The change was made but the journal could not
+ * be written.
+ * MTMFLIX_SUCCESS - Change journaled, or mtmflix is not journaled.
+ */
+static MtmFlixResult addJournalChange(MtmFlix mtmflix){
+    if(!mtmflix->journal_path){
+        /* The changes of this mtmflix are not journaled. */
+        return MTMFLIX_SUCCESS;
+    }
+    if(journalAppendPrepared(mtmflix->journal)!=JOURNAL_SUCCESS){
+        mtmflix->journal_failed = true;
+        return MTMFLIX_CANNOT_OPEN_FILE;
+    }
+    int records_num = journalGetRecordsNum(mtmflix->journal);
+    if(mtmflix->checkpoint_every>0 &&
+       records_num>=mtmflix->next_checkpoint &&
+       writeCheckpoint(mtmflix)!=MTMFLIX_SUCCESS){
+        mtmflix->next_checkpoint = records_num+mtmflix->checkpoint_every;
+        if(mtmflix->journal_failed){
+            return MTMFLIX_CANNOT_OPEN_FILE;
+        }
+    }
+    return MTMFLIX_SUCCESS;
+}
+
+/** Rows: 22
+ ***** Static function: loadCheckpoint *****
+ * Description: Loads the checkpoint of a journaled mtmflix. A checkpoint
+ * is the generation of the journal that continues it, then a snapshot.
+ *
+ * @param path - Path the journal and checkpoint files start with.
+ * @param mtmflix - Holds the loaded mtmflix on success. An empty mtmflix
+ * if no checkpoint was written yet.
+ * @param generation - Holds the generation of the checkpoint, 0 if no
+ * checkpoint was written yet.
+ *
+ * @return
+ * MTMFLIX_CANNOT_OPEN_FILE - The checkpoint is not valid.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - Checkpoint loaded.
+ */
+static MtmFlixResult loadCheckpoint(const char* path, MtmFlix* mtmflix,
+                                    unsigned int* generation){
+    char* checkpoint_path = createFilePath(path,CHECKPOINT_FILE_SUFFIX);
+    if(!checkpoint_path){
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    FILE* checkpoint = fopen(checkpoint_path,"rb");
+    free(checkpoint_path);
+    if(!checkpoint){
+        *generation = 0;
+        *mtmflix = mtmFlixCreate();
+        return *mtmflix ? MTMFLIX_SUCCESS : MTMFLIX_OUT_OF_MEMORY;
+    }
+    uint32_t word = 0;
+    MtmFlixResult result = MTMFLIX_CANNOT_OPEN_FILE;
+    if(fread(&word,sizeof(word),1,checkpoint)==1){
+        result = mtmFlixLoadSnapshot(checkpoint,mtmflix);
+    }
+    fclose(checkpoint);
+    *generation = (unsigned int)word;
+    return result;
+}
+
+/** Rows: 18
+ ***** Static function: replayJournal *****
+ * Description: Makes the changes of the journal of a checkpoint again, in
+ * the order they were journaled.
+ *
+ * @param mtmflix - The mtmflix as it was at the checkpoint the journal
+ * continues.
+ * @param path - Path the journal and checkpoint files start with.
+ * @param generation - Generation of the checkpoint.
+ *
+ * @return
+ * MTMFLIX_CANNOT_OPEN_FILE - The journal is not valid.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - All the changes were made.
+ */
+static MtmFlixResult replayJournal(MtmFlix mtmflix, const char* path,
+                                   unsigned int generation){
+    char* journal_path = createJournalFilePath(path,generation);
+    if(!journal_path){
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    JournalResult result = journalReplay(journal_path,generation,
+                                         applyJournalChanges,mtmflix);
+    free(journal_path);
+    switch(result){
+        case JOURNAL_SUCCESS:
+            return MTMFLIX_SUCCESS;
+        case JOURNAL_OUT_OF_MEMORY:
+            return MTMFLIX_OUT_OF_MEMORY;
+        default:
+            return MTMFLIX_CANNOT_OPEN_FILE;
+    }
+}
+
+/** Rows: 15
+ ***** Static function: applyJournalChanges *****
+ * Description: Makes the journaled changes again, in their order. Every
+ * change succeeded when it was journaled, so it should succeed again on
+ * the same mtmflix. A change that does not is skipped, so the changes
+ * after it are still made.
+ *
+ * @param records - The journaled changes, all of them valid records.
+ * @param records_num - Number of the changes.
+ * @param context - The mtmflix to change.
+ *
+ * @return
+ * JOURNAL_BAD_FILE - A change is not valid.
+ * JOURNAL_OUT_OF_MEMORY - Any memory error.
+ * JOURNAL_SUCCESS - All the valid changes were made or skipped.
+ */
+static JournalResult applyJournalChanges(const JournalRecord* records,
+                                         int records_num, void* context){
+    MtmFlix mtmflix = context;
+    for(int i=0;i<records_num;i++){
+        if(!journalChangeIsValid(&records[i])){
+            return JOURNAL_BAD_FILE;
+        }
+    }
+    for(int i=0;i<records_num;i++){
+        if(applyJournalChange(mtmflix,&records[i])==MTMFLIX_OUT_OF_MEMORY){
+            return JOURNAL_OUT_OF_MEMORY;
+        }
+    }
+    return JOURNAL_SUCCESS;
+}
+
+/** Rows: 31
+ ***** Static function: applyJournalChange *****
+ * Description: Makes a journaled change again.
+ *
+ * @param mtmflix - The mtmflix to change.
+ * @param record - The journaled change. Valid.
+ *
+ * @return
+ * The result of the change.
+ */
+static MtmFlixResult applyJournalChange(MtmFlix mtmflix,
+                                        const JournalRecord* record){
+    const char* name1 = record->names[0];
+    const char* name2 = record->names[1];
+    const int* values = record->values;
+    switch(record->operation){
+        case JOURNAL_ADD_USER:
+            return mtmFlixAddUser(mtmflix,name1,values[0]);
+        case JOURNAL_REMOVE_USER:
+            return mtmFlixRemoveUser(mtmflix,name1);
+        case JOURNAL_ADD_SERIES:
+            if(record->values_num==5){
+                /* Only a series with age limits has the ages. */
+                int ages[2] = {values[3],values[4]};
+                return mtmFlixAddSeries(mtmflix,name1,values[0],
+                                        (Genre)values[1],ages,values[2]);
+            }
+            return mtmFlixAddSeries(mtmflix,name1,values[0],
+                                    (Genre)values[1],NULL,values[2]);
+        case JOURNAL_REMOVE_SERIES:
+            return mtmFlixRemoveSeries(mtmflix,name1);
+        case JOURNAL_SERIES_JOIN:
+            return mtmFlixSeriesJoin(mtmflix,name1,name2);
+        case JOURNAL_SERIES_LEAVE:
+            return mtmFlixSeriesLeave(mtmflix,name1,name2);
+        case JOURNAL_ADD_FRIEND:
+            return mtmFlixAddFriend(mtmflix,name1,name2);
+        default:
+            return mtmFlixRemoveFriend(mtmflix,name1,name2);
+    }
+}
+
+/** Rows: 13
+ ***** Static function: journalChangeIsValid *****
+ * Description: Checks that a journaled change has the names and numbers
+ * its operation needs.
+ *
+ * @param record - The journaled change.
+ *
+ * @return
+ * True if the change is valid, else false.
+ */
+static bool journalChangeIsValid(const JournalRecord* record){
+    /* The operations from joining a series on are about two names. */
+    int names_num = record->operation>=JOURNAL_SERIES_JOIN ? 2 : 1;
+    if(record->names_num!=names_num){
+        return false;
+    }
+    switch(record->operation){
+        case JOURNAL_ADD_USER:
+            return record->values_num==1;
+        case JOURNAL_ADD_SERIES:
+            /* Episodes, genre, duration, and the ages if it has them. */
+            return (record->values_num==3 || record->values_num==5) &&
+                   record->values[1]>=0 &&
+                   record->values[1]<NUMBER_OF_GENRES;
+        default:
+            return record->values_num==0;
+    }
+}
+
+/** Rows: 40
+ ***** Static function: writeCheckpoint *****
+ * Description: Writes a checkpoint of a journaled mtmflix and starts a new
+ * journal for it. The old journal is committed, and the new one is
+ * created next to it, so nothing changes if it cannot be. The checkpoint
+ * is written to a temporary file that replaces the old checkpoint only
+ * when it is complete, and only then the old journal is removed, so a
+ * crash at any point leaves a checkpoint and its journal, which recover
+ * all the committed changes. If anything fails, the mtmflix keeps its old
+ * checkpoint and journal.
+ *
+ * @param mtmflix - The mtmflix to checkpoint.
+ *
+ * @return
+ * MTMFLIX_CANNOT_OPEN_FILE - A file could not be written.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error, or failure to write a file.
+ * MTMFLIX_SUCCESS - Checkpoint written.
+ */
+static MtmFlixResult writeCheckpoint(MtmFlix mtmflix){
+    const char* path = mtmflix->journal_path;
+    unsigned int generation = mtmflix->checkpoint_generation;
+    char* checkpoint_path = createFilePath(path,CHECKPOINT_FILE_SUFFIX);
+    char* temporary_path = createFilePath(path,CHECKPOINT_TEMPORARY_SUFFIX);
+    char* old_journal_path = createJournalFilePath(path,generation);
+    char* journal_path = createJournalFilePath(path,generation+1);
+    MtmFlixResult result = MTMFLIX_OUT_OF_MEMORY;
+    Journal journal = NULL;
+    if(mtmflix->journal && journalCommit(mtmflix->journal)!=JOURNAL_SUCCESS){
+        mtmflix->journal_failed = true;
+        result = MTMFLIX_CANNOT_OPEN_FILE;
+    } else if(checkpoint_path && temporary_path && old_journal_path &&
+              journal_path){
+        journal = journalCreate(journal_path,generation+1,
+                                mtmflix->commit_every);
+        result = journal ? saveCheckpoint(mtmflix,temporary_path,
+                                          checkpoint_path,generation+1) :
+                 MTMFLIX_CANNOT_OPEN_FILE;
+    }
+    if(result==MTMFLIX_SUCCESS){
+        /* The old journal belongs to the checkpoint that was replaced. */
+        journalDestroy(mtmflix->journal);
+        remove(old_journal_path);
+        mtmflix->journal = journal;
+        mtmflix->checkpoint_generation++;
+        mtmflix->next_checkpoint = mtmflix->checkpoint_every;
+        mtmflix->journal_failed = false;
+    } else if(journal){
+        journalDestroy(journal);
+        remove(journal_path);
+    }
+    free(checkpoint_path);
+    free(temporary_path);
+    free(old_journal_path);
+    free(journal_path);
+    return result;
+}
+
+/** Rows: 32
+ ***** Static function: saveCheckpoint *****
+ * Description: Writes a checkpoint of a mtmflix to a temporary file, then
+ * puts it in place of the checkpoint file.
+ *
+ * @param mtmflix - The mtmflix to checkpoint.
+ * @param temporary_path - Path of the temporary file.
+ * @param checkpoint_path - Path of the checkpoint file.
+ * @param generation - Generation of the new checkpoint.
+ *
+ * @return
+ * MTMFLIX_CANNOT_OPEN_FILE - A file could not be opened or replaced.
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error, or failure to write the file.
+ * MTMFLIX_SUCCESS - Checkpoint written.
+ */
+static MtmFlixResult saveCheckpoint(MtmFlix mtmflix,
+                                    const char* temporary_path,
+                                    const char* checkpoint_path,
+                                    unsigned int generation){
+    FILE* checkpoint = fopen(temporary_path,"wb");
+    if(!checkpoint){
+        return MTMFLIX_CANNOT_OPEN_FILE;
+    }
+    uint32_t word = (uint32_t)generation;
+    MtmFlixResult result = MTMFLIX_OUT_OF_MEMORY;
+    if(fwrite(&word,sizeof(word),1,checkpoint)==1){
+        result = mtmFlixSaveSnapshot(mtmflix,checkpoint);
+    }
+    /* It must be on the disk before it replaces the old one. */
+    if(result==MTMFLIX_SUCCESS && (fflush(checkpoint)!=0 ||
+                                   fsync(fileno(checkpoint))!=0)){
+        result = MTMFLIX_OUT_OF_MEMORY;
+    }
+    if(fclose(checkpoint)!=0 && result==MTMFLIX_SUCCESS){
+        result = MTMFLIX_OUT_OF_MEMORY;
+    }
+    if(result==MTMFLIX_SUCCESS && rename(temporary_path,checkpoint_path)!=0){
+        /* Some systems do not rename over an existing file. */
+        remove(checkpoint_path);
+        if(rename(temporary_path,checkpoint_path)!=0){
+            result = MTMFLIX_CANNOT_OPEN_FILE;
+        }
+    }
+    if(result!=MTMFLIX_SUCCESS){
+        remove(temporary_path);
+    }
+    return result;
+}
+
+/** Rows: 9
+ ***** Static function: createFilePath *****
+ * Description: Creates the path of a file of a journaled mtmflix.
+ *
+ * @param path - Path the journal and checkpoint files start with.
+ * @param suffix - Suffix of the file.
+ *
+ * @return
+ * The new path, or NULL in case of memory error.
+ */
+static char* createFilePath(const char* path, const char* suffix){
+    size_t path_length = strlen(path);
+    char* file_path = malloc(path_length+strlen(suffix)+1);
+    if(!file_path){
+        return NULL;
+    }
+    strcpy(file_path,path);
+    strcpy(file_path+path_length,suffix);
+    return file_path;
+}
+
+/** Rows: 9
+ ***** Static function: createJournalFilePath *****
+ * Description: Creates the path of the journal of a checkpoint of a
+ * journaled mtmflix.
+ *
+ * @param path - Path the journal and checkpoint files start with.
+ * @param generation - Generation of the checkpoint.
+ *
+ * @return
+ * The new path, or NULL in case of memory error.
+ */
+static char* createJournalFilePath(const char* path,
+                                   unsigned int generation){
+    char* file_path = malloc(strlen(path)+strlen(JOURNAL_FILE_SUFFIX)+
+                             MAX_GENERATION_LENGTH+1);
+    if(!file_path){
+        return NULL;
+    }
+    sprintf(file_path,"%s%s%u",path,JOURNAL_FILE_SUFFIX,generation);
+    return file_path;
+}
+
+/** Rows: 1
+ ***** Static function: getGenreSeries *****
+ * Description: Returns the series of the given genre.
+ *
+ * @param mtmflix - The mtmflix we are working in.
+ * @param genre - Genre of the series.
+ *
+ * @return
+ * The series of the genre, sorted by name.
+ */
+static OrderedArray getGenreSeries(MtmFlix mtmflix, Genre genre){
+    return mtmflix->series[seriesGetGenrePosition(genre)];
+}
+
+/** Rows: 4
+ ***** Static function: getRecommendationsCapacity *****
+ * Description: Returns how many series should be kept while ranking the
+ * series for a recommendation. Only the best "count" series are kept, and
+ * if count is 0 all the series may be printed.
+ *
+ * @param mtmflix - The mtmflix we are working in.
+ * @param count - The number of series the user asked for.
+ *
+ * @return
+ * Capacity of the ranked series.
+ */
+static int getRecommendationsCapacity(MtmFlix mtmflix, int count){
+    if(count==0){
+        return nameIndexGetSize(mtmflix->series_index);
+    }
+    return count;
+}
+
+/** Rows: 17
+ ***** Static function: recommenderCreate *****
+ * Description: Creates a new recommender, with an empty ranked series.
+ *
+ * @return
+ * A new recommender or NULL in case of memory error.
+ */
+static Recommender recommenderCreate(){
+    Recommender recommender = malloc(sizeof(*recommender));
+    if(!recommender){
+        return NULL;
+    }
+    recommender->ranked_series = rankedSeriesCreate(0);
+    recommender->marked_series = idMarksCreate();
+    recommender->candidates = NULL;
+    recommender->candidate_ids = NULL;
+    recommender->candidate_ranks = NULL;
+    recommender->candidate_bounds = NULL;
+    recommender->candidates_allocated = 0;
+    if(!recommender->ranked_series || !recommender->marked_series){
+        recommenderDestroy(recommender);
+        return NULL;
+    }
+    return recommender;
+}
+
+/** Rows: 11
+ ***** Static function: recommenderDestroy *****
+ * Description: Deallocates a recommender.
+ *
+ * @param recommender - Recommender to destroy.
+ */
+static void recommenderDestroy(Recommender recommender){
+    if(!recommender){
+        return;
+    }
+    rankedSeriesDestroy(recommender->ranked_series);
+    idMarksDestroy(recommender->marked_series);
+    free(recommender->candidates);
+    free(recommender->candidate_ids);
+    free(recommender->candidate_ranks);
+    free(recommender->candidate_bounds);
+    free(recommender);
+}
+
+/** Rows: 37
+ ***** Static function: recommenderPrepare *****
+ * Description: Prepares a recommender for ranking the series of a user.
+ * The candidates arrays grow if the mtmflix has more series than before,
+ * and a new round of marks is started.
+ *
+ * @param recommender - Recommender to prepare.
+ * @param series_num - Number of series in the mtmflix.
+ * @param ids_count - The ids of the series are smaller than this number.
+ *
+ * @return
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - Recommender prepared.
+ */
+static MtmFlixResult recommenderPrepare(Recommender recommender,
+                                        int series_num,
+                                        unsigned int ids_count){
+    if(series_num>recommender->candidates_allocated ||
+       !recommender->candidate_bounds){
+        /* At least one series, so realloc never gets 0. */
+        int new_allocated = series_num>0 ? series_num : 1;
+        Series* new_candidates = realloc(recommender->candidates,
+                                         sizeof(Series)*new_allocated);
+        if(!new_candidates){
+            return MTMFLIX_OUT_OF_MEMORY;
+        }
+        recommender->candidates = new_candidates;
+        unsigned int* new_ids = realloc(recommender->candidate_ids,
+                                    sizeof(unsigned int)*new_allocated);
+        if(!new_ids){
+            return MTMFLIX_OUT_OF_MEMORY;
+        }
+        recommender->candidate_ids = new_ids;
+        int* new_ranks = realloc(recommender->candidate_ranks,
+                                 sizeof(int)*new_allocated);
+        if(!new_ranks){
+            return MTMFLIX_OUT_OF_MEMORY;
+        }
+        recommender->candidate_ranks = new_ranks;
+        CandidateBound* new_bounds = realloc(recommender->candidate_bounds,
+                                        sizeof(CandidateBound)*new_allocated);
+        if(!new_bounds){
+            return MTMFLIX_OUT_OF_MEMORY;
+        }
+        recommender->candidate_bounds = new_bounds;
+        /* Only after all the arrays grew they have room for this many. */
+        recommender->candidates_allocated = new_allocated;
+    }
+    if(idMarksStartRound(recommender->marked_series,ids_count)!=
+       ID_MARKS_SUCCESS){
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    return MTMFLIX_SUCCESS;
+}
+
+/** Rows: 11
+ ***** Static function: getUsersByUsernames *****
+ * Description: Finds the users with the given usernames.
+ *
+ * @param mtmflix - The mtmflix to look in.
+ * @param usernames - Array of the usernames of the users.
+ * @param usersNum - Number of usernames in the array.
+ * @param users - Array of usersNum users to fill.
+ *
+ * @return
+ * MTMFLIX_NULL_ARGUMENT - One of the usernames is NULL.
+ * MTMFLIX_USER_DOES_NOT_EXIST - One of the users does not exist.
+ * MTMFLIX_SUCCESS - All the users were found.
+ */
+static MtmFlixResult getUsersByUsernames(MtmFlix mtmflix,
+                                         const char** usernames,
+                                         int usersNum, User* users){
+    MtmFlixResult result = MTMFLIX_SUCCESS;
+    for(int i=0;i<usersNum && result==MTMFLIX_SUCCESS;i++){
+        result = usernames[i] ? MTMFLIX_SUCCESS : MTMFLIX_NULL_ARGUMENT;
+        if(result==MTMFLIX_SUCCESS){
+            users[i] = getUserByUsername(mtmflix,usernames[i],&result);
+        }
+    }
+    return result;
+}
+
+/** Rows: 39
+ ***** Static function: recommendationsWorker *****
+ * Description: The function of a worker thread. Takes the users of the
+ * job one by one, ranks the series for each of them and copies the best
+ * series to the recommendations of the user. Stops when no user is left.
+ *
+ * @param job - The recommendations job the thread works on.
+ *
+ * @return
+ * NULL.
+ */
+static void* recommendationsWorker(void* job){
+    RecommendationsJob recommendations_job = job;
+    Recommender recommender = recommenderCreate();
+    int capacity = recommendations_job->capacity;
+    Series* best_series = malloc(sizeof(Series)*(capacity>0 ? capacity : 1));
+    while(true){
+        pthread_mutex_lock(&recommendations_job->lock);
+        int user = recommendations_job->next_user;
+        if(user<recommendations_job->users_num){
+            recommendations_job->next_user++;
+        }
+        pthread_mutex_unlock(&recommendations_job->lock);
+        if(user>=recommendations_job->users_num){
+            break;
+        }
+        UserRecommendations recommendations = {NULL,0,
+                                               MTMFLIX_OUT_OF_MEMORY,true};
+        if(recommender && best_series){
+            recommendations.result = rankAllSeriesForUser(
+                    recommendations_job->mtmflix,
+                    recommendations_job->users[user],recommender,capacity,1);
+        }
+        if(recommendations.result==MTMFLIX_SUCCESS){
+            recommendations.size = rankedSeriesTakeSorted(
+                    recommender->ranked_series,best_series);
+            recommendations.series = malloc(sizeof(Series)*
+                    (recommendations.size>0 ? recommendations.size : 1));
+            if(!recommendations.series){
+                recommendations.result = MTMFLIX_OUT_OF_MEMORY;
+            } else {
+                memcpy(recommendations.series,best_series,
+                       sizeof(Series)*recommendations.size);
+            }
+        }
+        pthread_mutex_lock(&recommendations_job->lock);
+        recommendations_job->recommendations[user] = recommendations;
+        pthread_cond_broadcast(&recommendations_job->user_ranked);
+        pthread_mutex_unlock(&recommendations_job->lock);
+    }
+    free(best_series);
+    recommenderDestroy(recommender);
+    return NULL;
+}
+
+/** Rows: 31
+ ***** Static function: printJobRecommendations *****
+ * Description: Prints the recommendations of the users of the job in
+ * their order, waiting for the workers to finish each user. All the
+ * printing is done by the calling thread. On failure, the workers are
+ * told not to take more users.
+ *
+ * @param job - The recommendations job to print.
+ * @param writer - Report writer to print with.
+ * @param outputStream - File to print to.
+ *
+ * @return
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - All the recommendations were printed.
+ */
+static MtmFlixResult printJobRecommendations(RecommendationsJob job,
+                                             ReportWriter writer,
+                                             FILE* outputStream){
+    reportWriterStart(writer,outputStream);
+    MtmFlixResult result = MTMFLIX_SUCCESS;
+    for(int i=0;i<job->users_num && result==MTMFLIX_SUCCESS;i++){
+        pthread_mutex_lock(&job->lock);
+        while(!job->recommendations[i].ranked){
+            pthread_cond_wait(&job->user_ranked,&job->lock);
+        }
+        pthread_mutex_unlock(&job->lock);
+        /* A ranked user is not touched by the workers anymore. */
+        UserRecommendations* recommendations = &job->recommendations[i];
+        result = recommendations->result;
+        if(result==MTMFLIX_SUCCESS){
+            result = writeSeriesDetails(writer,recommendations->series,
+                                        recommendations->size);
+        }
+    }
+    if(reportWriterFlush(writer)!=REPORT_WRITER_SUCCESS){
+        result = MTMFLIX_OUT_OF_MEMORY;
+    }
+    if(result!=MTMFLIX_SUCCESS){
+        /* No more users should be ranked. */
+        pthread_mutex_lock(&job->lock);
+        job->next_user = job->users_num;
+        pthread_mutex_unlock(&job->lock);
+    }
+    return result;
+}
+
+/** Rows: 26
+ ***** Static function: usersReportWorker *****
+ * Description: The function of a worker thread of a parallel users
+ * report. Takes the shards of the job one by one and formats the users of
+ * each of them. Stops when no shard is left.
+ *
+ * @param job - The users report job the thread works on.
+ *
+ * @return
+ * NULL.
+ */
+static void* usersReportWorker(void* job){
+    UsersReportJob report_job = job;
+    /* No user has more friends than there are users. */
+    const char** friends_names = malloc(sizeof(*friends_names)*
+                        orderedArrayGetSize(report_job->mtmflix->users));
+    while(true){
+        pthread_mutex_lock(&report_job->lock);
+        int shard = report_job->next_shard;
+        if(shard<report_job->shards_num){
+            report_job->next_shard++;
+        }
+        pthread_mutex_unlock(&report_job->lock);
+        if(shard>=report_job->shards_num){
+            break;
+        }
+        ReportShard formatted = {NULL,0,0,MTMFLIX_OUT_OF_MEMORY,true};
+        if(friends_names){
+            formatted.result = formatReportShard(report_job,shard,
+                                                 friends_names,&formatted);
+        }
+        pthread_mutex_lock(&report_job->lock);
+        report_job->shards[shard] = formatted;
+        pthread_cond_broadcast(&report_job->shard_formatted);
+        pthread_mutex_unlock(&report_job->lock);
+    }
+    free(friends_names);
+    return NULL;
+}
+
+/** Rows: 16
+ ***** Static function: formatReportShard *****
+ * Description: Formats the details of the users of a shard, in their
+ * order, into the text of the shard.
+ *
+ * @param job - The users report job of the shard.
+ * @param shard - Index of the shard.
+ * @param friends_names - Array of the worker, with room for the names of
+ * the friends of any user.
+ * @param formatted - The shard to format into. Holds the users that were
+ * formatted before a failure.
+ *
+ * @return
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - All the users of the shard were formatted.
+ */
+static MtmFlixResult formatReportShard(UsersReportJob job, int shard,
+                                       const char** friends_names,
+                                       ReportShard* formatted){
+    OrderedArray users = job->mtmflix->users;
+    int end = (shard+1)*USERS_PER_REPORT_SHARD;
+    if(end>orderedArrayGetSize(users)){
+        end = orderedArrayGetSize(users);
+    }
+    for(int i=shard*USERS_PER_REPORT_SHARD;i<end;i++){
+        if(!formatUserDetails(job->mtmflix,orderedArrayGet(users,i),
+                              friends_names,formatted)){
+            return MTMFLIX_OUT_OF_MEMORY;
+        }
+    }
+    return MTMFLIX_SUCCESS;
+}
+
+/** Rows: 30
+ ***** Static function: formatUserDetails *****
+ * Description: Appends the details of a user to the text of a shard,
+ * exactly as mtmPrintUser formats them: a separator, the username and
+ * age, the names of the friends sorted with strcmp and the names of the
+ * favorite series, which are already sorted by name.
+ *
+ * @param mtmflix - The mtmflix of the user.
+ * @param user - The user to format.
+ * @param friends_names - Array with room for the names of his friends.
+ * @param formatted - The shard to append to.
+ *
+ * @return
+ * True - Details appended.
+ * False - The username is too long for mtmPrintUser, or memory allocation
+ * failed.
+ */
+static bool formatUserDetails(MtmFlix mtmflix, User user,
+                              const char** friends_names,
+                              ReportShard* formatted){
+    const char* username = userGetUsername(user);
+    if(strlen(username)>MAX_USER_DETAILS_USERNAME_LENGTH){
+        return false;
+    }
+    char age[3*sizeof(int)+2];
+    sprintf(age,"%d",userGetAge(user));
+    if(!appendToReportShard(formatted,USER_DETAILS_SEPARATOR "The user ") ||
+       !appendToReportShard(formatted,username) ||
+       !appendToReportShard(formatted," is ") ||
+       !appendToReportShard(formatted,age) ||
+       !appendToReportShard(formatted," years old\n")){
+        return false;
+    }
+    int friends_num = userGetSortedFriendsNames(user,mtmflix->users_by_id,
+                                                friends_names);
+    for(int i=0;i<friends_num;i++){
+        if(!appendDetailsLine(formatted,"Friend: ",friends_names[i])){
+            return false;
+        }
+    }
+    OrderedArray favorites = userGetFavoriteSeries(user);
+    for(int i=0;i<orderedArrayGetSize(favorites);i++){
+        Series series = orderedArrayGet(favorites,i);
+        if(!appendDetailsLine(formatted,"Series: ",seriesGetName(series))){
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Rows: 4
+ ***** Static function: appendDetailsLine *****
+ * Description: Appends a line of the details of a user to the text of a
+ * shard: a title and a name.
+ *
+ * @param shard - Shard to append to.
+ * @param title - Title of the line.
+ * @param name - Name to put after the title.
+ *
+ * @return
+ * True - Line appended.
+ * False - Memory allocation failed.
+ */
+static bool appendDetailsLine(ReportShard* shard, const char* title,
+                              const char* name){
+    return appendToReportShard(shard,title) &&
+           appendToReportShard(shard,name) &&
+           appendToReportShard(shard,"\n");
+}
+
+/** Rows: 18
+ ***** Static function: appendToReportShard *****
+ * Description: Appends text to the text of a shard. The text is doubled
+ * when it has no room, and always ends with '\0'.
+ *
+ * @param shard - Shard to append to.
+ * @param text - Text to append. NULL is taken as the failed result of
+ * creating the text.
+ *
+ * @return
+ * True - Text appended.
+ * False - Text is NULL or memory allocation failed.
+ */
+static bool appendToReportShard(ReportShard* shard, const char* text){
+    if(!text){
+        return false;
+    }
+    size_t length = strlen(text);
+    if(shard->length+length+1>shard->allocated){
+        size_t new_allocated = shard->allocated>0 ? shard->allocated*2 : 256;
+        while(new_allocated<shard->length+length+1){
+            new_allocated *= 2;
+        }
+        char* new_text = realloc(shard->text,new_allocated);
+        if(!new_text){
+            return false;
+        }
+        shard->text = new_text;
+        shard->allocated = new_allocated;
+    }
+    memcpy(shard->text+shard->length,text,length+1);
+    shard->length += length;
+    return true;
+}
+
+/** Rows: 31
+ ***** Static function: printReportShards *****
+ * Description: Prints the shards of the job in their order, waiting for
+ * the workers to finish each shard. The text of a shard is freed once it
+ * is printed. The users a shard formatted before a failure are printed
+ * too, like the serial report does. On failure, the workers are told not
+ * to take more shards.
+ *
+ * @param job - The users report job to print.
+ * @param writer - Report writer to print with.
+ * @param outputStream - File to print to.
+ *
+ * @return
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ * MTMFLIX_SUCCESS - All the users were printed.
+ */
+static MtmFlixResult printReportShards(UsersReportJob job,
+                                       ReportWriter writer,
+                                       FILE* outputStream){
+    reportWriterStart(writer,outputStream);
+    MtmFlixResult result = MTMFLIX_SUCCESS;
+    for(int i=0;i<job->shards_num && result==MTMFLIX_SUCCESS;i++){
+        pthread_mutex_lock(&job->lock);
+        while(!job->shards[i].formatted){
+            pthread_cond_wait(&job->shard_formatted,&job->lock);
+        }
+        pthread_mutex_unlock(&job->lock);
+        /* A formatted shard is not touched by the workers anymore. */
+        ReportShard* shard = &job->shards[i];
+        result = shard->result;
+        if(shard->text &&
+           reportWriterWrite(writer,shard->text)!=REPORT_WRITER_SUCCESS){
+            result = MTMFLIX_OUT_OF_MEMORY;
+        }
+        free(shard->text);
+        shard->text = NULL;
+    }
+    if(reportWriterFlush(writer)!=REPORT_WRITER_SUCCESS){
+        result = MTMFLIX_OUT_OF_MEMORY;
+    }
+    if(result!=MTMFLIX_SUCCESS){
+        /* No more shards should be formatted. */
+        pthread_mutex_lock(&job->lock);
+        job->next_shard = job->shards_num;
+        pthread_mutex_unlock(&job->lock);
+    }
+    return result;
+}
@@ -38,8 +38,19 @@ MtmFlixResult mtmFlixRemoveUser(MtmFlix mtmflix, const char* username);
 MtmFlixResult mtmFlixAddFriend(MtmFlix mtmflix, const char* username1, const char* username2);
 MtmFlixResult mtmFlixRemoveFriend(MtmFlix mtmflix, const char* username1, const char* username2);
 MtmFlixResult mtmFlixGetRecommendations(MtmFlix mtmflix, const char* username, int count, FILE* outputStream);
+MtmFlixResult mtmFlixGetRecommendationsWithThreads(MtmFlix mtmflix, const char* username, int count, int threadsNum, FILE* outputStream);
+MtmFlixResult mtmFlixGetRecommendationsBatch(MtmFlix mtmflix, const char** usernames, int usersNum, int count, FILE* outputStream);
+MtmFlixResult mtmFlixGetRecommendationsParallel(MtmFlix mtmflix, const char** usernames, int usersNum, int count, int threadsNum, FILE* outputStream);
+MtmFlixResult mtmFlixSetRecommendationsCache(MtmFlix mtmflix, int entriesNum);
+MtmFlixResult mtmFlixSetUserHot(MtmFlix mtmflix, const char* username, bool hot);
 
 MtmFlixResult mtmFlixReportSeries(MtmFlix mtmflix, int seriesNum, FILE* outputStream);
 MtmFlixResult mtmFlixReportUsers(MtmFlix mtmflix, FILE* outputStream);
+MtmFlixResult mtmFlixReportUsersParallel(MtmFlix mtmflix, int threadsNum, FILE* outputStream);
+MtmFlixResult mtmFlixSaveSnapshot(MtmFlix mtmflix, FILE* outputStream);
+MtmFlixResult mtmFlixLoadSnapshot(FILE* inputStream, MtmFlix* mtmflix);
+MtmFlixResult mtmFlixOpenJournaled(const char* path, int commitEvery, int checkpointEvery, MtmFlix* mtmflix);
+MtmFlixResult mtmFlixCommitJournal(MtmFlix mtmflix);
+MtmFlixResult mtmFlixCheckpoint(MtmFlix mtmflix);
 
 #endif /* MTMFLIX_H_ */
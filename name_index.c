@@ -0,0 +1,316 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "name_index.h"
+
+#define NAME_INDEX_INITIAL_CAPACITY 16
+/* The index grows when it is more than 70% full. */
+#define NAME_INDEX_MAX_LOAD_NUMERATOR 7
+#define NAME_INDEX_MAX_LOAD_DENOMINATOR 10
+
+//-----------------------------------------------------------------------//
+//              NAME INDEX: STATIC FUNCTIONS DECLARATIONS                //
+//-----------------------------------------------------------------------//
+
+static unsigned int nameIndexHash(const char* name);
+
+static int nameIndexFindSlot(NameIndex index, const char* name,
+                             unsigned int hash);
+
+static NameIndexResult nameIndexGrow(NameIndex index);
+
+//-----------------------------------------------------------------------//
+//                        NAME INDEX: STRUCT                             //
+//-----------------------------------------------------------------------//
+
+typedef struct {
+    unsigned int hash;
+    NameIndexElement element; // NULL marks an empty slot.
+} NameIndexSlot;
+
+struct name_index_t{
+    NameIndexSlot* slots;
+    int capacity; // Always a power of 2.
+    int size;
+    getNameIndexKey getKey;
+    freeNameIndexElement freeElement;
+};
+
+
+//-----------------------------------------------------------------------//
+//                       NAME INDEX: FUNCTIONS                           //
+//-----------------------------------------------------------------------//
+
+/** Rows: 17
+ ***** Function: nameIndexCreate *****
+ * Description: Creates a new empty name index.
+ *
+ * @param getKey - Function that returns the name of an element.
+ * @param freeElement - Function that deallocates an element.
+ *
+ * @return
+ * A new name index or NULL in case of NULL argument or memory error.
+ */
+NameIndex nameIndexCreate(getNameIndexKey getKey,
+                          freeNameIndexElement freeElement){
+    if(!getKey || !freeElement){
+        return NULL;
+    }
+    NameIndex index = malloc(sizeof(*index));
+    if(!index){
+        return NULL;
+    }
+    index->slots = calloc(NAME_INDEX_INITIAL_CAPACITY,sizeof(NameIndexSlot));
+    if(!index->slots){
+        free(index);
+        return NULL;
+    }
+    index->capacity = NAME_INDEX_INITIAL_CAPACITY;
+    index->size = 0;
+    index->getKey = getKey;
+    index->freeElement = freeElement;
+    return index;
+}
+
+/** Rows: 10
+ ***** Function: nameIndexDestroy *****
+ * Description: Deallocates the index and all the elements in it.
+ *
+ * @param index - Index to destroy.
+ */
+void nameIndexDestroy(NameIndex index){
+    if(!index){
+        return;
+    }
+    for(int i=0;i<index->capacity;i++){
+        if(index->slots[i].element){
+            index->freeElement(index->slots[i].element);
+        }
+    }
+    free(index->slots);
+    free(index);
+}
+
+/** Rows: 4
+ ***** Function: nameIndexGetSize *****
+ * Description: Returns the number of elements in the index.
+ *
+ * @param index - Index to check.
+ *
+ * @return
+ * Number of elements, or -1 if index is NULL.
+ */
+int nameIndexGetSize(NameIndex index){
+    if(!index){
+        return -1;
+    }
+    return index->size;
+}
+
+/** Rows: 22
+ ***** Function: nameIndexInsert *****
+ * Description: Inserts an element to the index. On success the index
+ * takes ownership of the element.
+ *
+ * @param index - Index to insert to.
+ * @param element - Element to insert.
+ *
+ * @return
+ * NAME_INDEX_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * NAME_INDEX_ALREADY_EXISTS - An element with the same name is indexed.
+ * NAME_INDEX_OUT_OF_MEMORY - Failed to grow the index.
+ * NAME_INDEX_SUCCESS - Element inserted.
+ */
+NameIndexResult nameIndexInsert(NameIndex index, NameIndexElement element){
+    if(!index || !element){
+        return NAME_INDEX_NULL_ARGUMENT;
+    }
+    const char* name = index->getKey(element);
+    unsigned int hash = nameIndexHash(name);
+    int slot = nameIndexFindSlot(index,name,hash);
+    if(index->slots[slot].element){
+        /* Name is already in the index. */
+        return NAME_INDEX_ALREADY_EXISTS;
+    }
+    if((index->size+1)*NAME_INDEX_MAX_LOAD_DENOMINATOR >
+       index->capacity*NAME_INDEX_MAX_LOAD_NUMERATOR){
+        if(nameIndexGrow(index)!=NAME_INDEX_SUCCESS){
+            return NAME_INDEX_OUT_OF_MEMORY;
+        }
+        /* Slots were rehashed, looking for the free slot again. */
+        slot = nameIndexFindSlot(index,name,hash);
+    }
+    index->slots[slot].hash = hash;
+    index->slots[slot].element = element;
+    index->size++;
+    return NAME_INDEX_SUCCESS;
+}
+
+/** Rows: 6
+ ***** Function: nameIndexFind *****
+ * Description: Returns the element with the given name. Does not allocate
+ * and does not change the index, so it can be called while iterating any
+ * other container.
+ *
+ * @param index - Index to search in.
+ * @param name - Name to search for.
+ *
+ * @return
+ * The element with the given name, or NULL if there is no such element.
+ */
+NameIndexElement nameIndexFind(NameIndex index, const char* name){
+    if(!index || !name){
+        return NULL;
+    }
+    int slot = nameIndexFindSlot(index,name,nameIndexHash(name));
+    /* An empty slot holds NULL. */
+    return index->slots[slot].element;
+}
+
+/** Rows: 1
+ ***** Function: nameIndexContains *****
+ * Description: Returns whether an element with the given name is indexed.
+ *
+ * @param index - Index to search in.
+ * @param name - Name to search for.
+ *
+ * @return
+ * True - Name is in the index.
+ * False - Name is not in the index (or NULL argument).
+ */
+bool nameIndexContains(NameIndex index, const char* name){
+    return nameIndexFind(index,name)!=NULL;
+}
+
+/** Rows: 30
+ ***** Function: nameIndexRemove *****
+ * Description: Removes the element with the given name from the index and
+ * deallocates it.
+ *
+ * Notice: The name may belong to the removed element itself, it is not
+ * used after the element is freed.
+ *
+ * @param index - Index to remove from.
+ * @param name - Name of the element to remove.
+ *
+ * @return
+ * NAME_INDEX_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * NAME_INDEX_DOES_NOT_EXIST - No element with this name.
+ * NAME_INDEX_SUCCESS - Element removed.
+ */
+NameIndexResult nameIndexRemove(NameIndex index, const char* name){
+    if(!index || !name){
+        return NAME_INDEX_NULL_ARGUMENT;
+    }
+    int mask = index->capacity-1;
+    int hole = nameIndexFindSlot(index,name,nameIndexHash(name));
+    NameIndexElement removed = index->slots[hole].element;
+    if(!removed){
+        return NAME_INDEX_DOES_NOT_EXIST;
+    }
+    /* Backward shift deletion: every element after the hole that is not
+     * in its home slot is moved back, so probe sequences never break and
+     * no tombstones are needed. */
+    int current = (hole+1)&mask;
+    while(index->slots[current].element){
+        int home = (int)(index->slots[current].hash&(unsigned int)mask);
+        /* The element can fill the hole if the hole is between its home
+         * slot and its current slot (cyclically). */
+        if(((current-home)&mask) >= ((current-hole)&mask)){
+            index->slots[hole] = index->slots[current];
+            hole = current;
+        }
+        current = (current+1)&mask;
+    }
+    index->slots[hole].element = NULL;
+    index->size--;
+    index->freeElement(removed);
+    return NAME_INDEX_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------//
+//                     NAME INDEX: STATIC FUNCTIONS                      //
+//-----------------------------------------------------------------------//
+
+/** Rows: 6
+ ***** Static function: nameIndexHash *****
+ * Description: FNV-1a hash of a string.
+ *
+ * @param name - String to hash.
+ *
+ * @return
+ * Hash value of the string.
+ */
+static unsigned int nameIndexHash(const char* name){
+    unsigned int hash = 2166136261u;
+    while(*name){
+        hash ^= (unsigned char)*name;
+        hash *= 16777619u;
+        name++;
+    }
+    return hash;
+}
+
+/** Rows: 11
+ ***** Static function: nameIndexFindSlot *****
+ * Description: Returns the slot that holds the given name, or the empty
+ * slot where the name should be inserted if it is not in the index.
+ *
+ * @param index - Index to search in.
+ * @param name - Name to search for.
+ * @param hash - Hash of the name.
+ *
+ * @return
+ * Position of the slot.
+ */
+static int nameIndexFindSlot(NameIndex index, const char* name,
+                             unsigned int hash){
+    int mask = index->capacity-1;
+    int slot = (int)(hash&(unsigned int)mask);
+    /* The index is never full, so an empty slot will always be found. */
+    while(index->slots[slot].element){
+        if(index->slots[slot].hash==hash &&
+           strcmp(index->getKey(index->slots[slot].element),name)==0){
+            return slot;
+        }
+        slot = (slot+1)&mask;
+    }
+    return slot;
+}
+
+/** Rows: 18
+ ***** Static function: nameIndexGrow *****
+ * Description: Doubles the capacity of the index and rehashes all the
+ * elements into the new slots.
+ *
+ * @param index - Index to grow.
+ *
+ * @return
+ * NAME_INDEX_OUT_OF_MEMORY - Memory allocation failed, the index is left
+ * unchanged.
+ * NAME_INDEX_SUCCESS - Index grew.
+ */
+static NameIndexResult nameIndexGrow(NameIndex index){
+    int new_capacity = index->capacity*2;
+    NameIndexSlot* new_slots = calloc((size_t)new_capacity,
+                                      sizeof(NameIndexSlot));
+    if(!new_slots){
+        return NAME_INDEX_OUT_OF_MEMORY;
+    }
+    int mask = new_capacity-1;
+    for(int i=0;i<index->capacity;i++){
+        if(!index->slots[i].element){
+            continue;
+        }
+        int slot = (int)(index->slots[i].hash&(unsigned int)mask);
+        while(new_slots[slot].element){
+            slot = (slot+1)&mask;
+        }
+        new_slots[slot] = index->slots[i];
+    }
+    free(index->slots);
+    index->slots = new_slots;
+    index->capacity = new_capacity;
+    return NAME_INDEX_SUCCESS;
+}
@@ -0,0 +1,137 @@
+#ifndef MTM_EX3_MTMFLIX_NAME_INDEX_H
+#define MTM_EX3_MTMFLIX_NAME_INDEX_H
+
+#include <stdbool.h>
+
+//-----------------------------------------------------------------------//
+//                  NAME INDEX: TYPEDEFS AND DEFINES                     //
+//-----------------------------------------------------------------------//
+
+/**
+ * Name index: an open-addressing (linear probing) hash table that maps a
+ * name to the element that carries it. The name itself is not copied - it
+ * is taken from the element using the given key function, so it must stay
+ * valid as long as the element is in the index.
+ *
+ * The index owns its elements: they are deallocated with the given free
+ * function when they are removed from the index or when the index is
+ * destroyed.
+ */
+
+typedef struct name_index_t* NameIndex;
+
+typedef void* NameIndexElement;
+
+/** Returns the name an element is indexed by. */
+typedef const char*(*getNameIndexKey)(NameIndexElement);
+
+/** Deallocates an element of the index. */
+typedef void(*freeNameIndexElement)(NameIndexElement);
+
+typedef enum {
+    NAME_INDEX_SUCCESS,
+    NAME_INDEX_OUT_OF_MEMORY,
+    NAME_INDEX_NULL_ARGUMENT,
+    NAME_INDEX_ALREADY_EXISTS,
+    NAME_INDEX_DOES_NOT_EXIST
+} NameIndexResult;
+
+
+//-----------------------------------------------------------------------//
+//                  NAME INDEX: FUNCTIONS DECLARATIONS                   //
+//-----------------------------------------------------------------------//
+
+/**
+ ***** Function: nameIndexCreate *****
+ * Description: Creates a new empty name index.
+ *
+ * @param getKey - Function that returns the name of an element.
+ * @param freeElement - Function that deallocates an element.
+ *
+ * @return
+ * A new name index or NULL in case of NULL argument or memory error.
+ */
+NameIndex nameIndexCreate(getNameIndexKey getKey,
+                          freeNameIndexElement freeElement);
+
+/**
+ ***** Function: nameIndexDestroy *****
+ * Description: Deallocates the index and all the elements in it.
+ *
+ * @param index - Index to destroy.
+ */
+void nameIndexDestroy(NameIndex index);
+
+/**
+ ***** Function: nameIndexGetSize *****
+ * Description: Returns the number of elements in the index.
+ *
+ * @param index - Index to check.
+ *
+ * @return
+ * Number of elements, or -1 if index is NULL.
+ */
+int nameIndexGetSize(NameIndex index);
+
+/**
+ ***** Function: nameIndexInsert *****
+ * Description: Inserts an element to the index. On success the index
+ * takes ownership of the element.
+ *
+ * @param index - Index to insert to.
+ * @param element - Element to insert.
+ *
+ * @return
+ * NAME_INDEX_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * NAME_INDEX_ALREADY_EXISTS - An element with the same name is indexed.
+ * NAME_INDEX_OUT_OF_MEMORY - Failed to grow the index.
+ * NAME_INDEX_SUCCESS - Element inserted.
+ */
+NameIndexResult nameIndexInsert(NameIndex index, NameIndexElement element);
+
+/**
+ ***** Function: nameIndexFind *****
+ * Description: Returns the element with the given name. Does not allocate
+ * and does not change the index, so it can be called while iterating any
+ * other container.
+ *
+ * @param index - Index to search in.
+ * @param name - Name to search for.
+ *
+ * @return
+ * The element with the given name, or NULL if there is no such element.
+ */
+NameIndexElement nameIndexFind(NameIndex index, const char* name);
+
+/**
+ ***** Function: nameIndexContains *****
+ * Description: Returns whether an element with the given name is indexed.
+ *
+ * @param index - Index to search in.
+ * @param name - Name to search for.
+ *
+ * @return
+ * True - Name is in the index.
+ * False - Name is not in the index (or NULL argument).
+ */
+bool nameIndexContains(NameIndex index, const char* name);
+
+/**
+ ***** Function: nameIndexRemove *****
+ * Description: Removes the element with the given name from the index and
+ * deallocates it.
+ *
+ * Notice: The name may belong to the removed element itself, it is not
+ * used after the element is freed.
+ *
+ * @param index - Index to remove from.
+ * @param name - Name of the element to remove.
+ *
+ * @return
+ * NAME_INDEX_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * NAME_INDEX_DOES_NOT_EXIST - No element with this name.
+ * NAME_INDEX_SUCCESS - Element removed.
+ */
+NameIndexResult nameIndexRemove(NameIndex index, const char* name);
+
+#endif //MTM_EX3_MTMFLIX_NAME_INDEX_H
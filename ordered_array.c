@@ -0,0 +1,261 @@
+#include <stdlib.h>
+#include <string.h>
+#include "ordered_array.h"
+
+#define ORDERED_ARRAY_INITIAL_CAPACITY 16
+
+//-----------------------------------------------------------------------//
+//             ORDERED ARRAY: STATIC FUNCTIONS DECLARATIONS              //
+//-----------------------------------------------------------------------//
+
+static int orderedArrayLowerBound(OrderedArray array,
+                                  OrderedArrayElement element);
+
+static OrderedArrayResult orderedArrayGrow(OrderedArray array);
+
+//-----------------------------------------------------------------------//
+//                      ORDERED ARRAY: STRUCT                            //
+//-----------------------------------------------------------------------//
+
+struct ordered_array_t{
+    OrderedArrayElement* elements;
+    int size;
+    int capacity;
+    compareOrderedArrayElements compareElements;
+};
+
+
+//-----------------------------------------------------------------------//
+//                     ORDERED ARRAY: FUNCTIONS                          //
+//-----------------------------------------------------------------------//
+
+/** Rows: 17
+ ***** Function: orderedArrayCreate *****
+ * Description: Creates a new empty ordered array.
+ *
+ * @param compareElements - Function that defines the order of elements.
+ *
+ * @return
+ * A new ordered array or NULL in case of NULL argument or memory error.
+ */
+OrderedArray orderedArrayCreate(compareOrderedArrayElements compareElements){
+    if(!compareElements){
+        return NULL;
+    }
+    OrderedArray array = malloc(sizeof(*array));
+    if(!array){
+        return NULL;
+    }
+    array->elements = malloc(ORDERED_ARRAY_INITIAL_CAPACITY*
+                             sizeof(OrderedArrayElement));
+    if(!array->elements){
+        free(array);
+        return NULL;
+    }
+    array->size = 0;
+    array->capacity = ORDERED_ARRAY_INITIAL_CAPACITY;
+    array->compareElements = compareElements;
+    return array;
+}
+
+/** Rows: 5
+ ***** Function: orderedArrayDestroy *****
+ * Description: Deallocates the array. The elements are not deallocated.
+ *
+ * @param array - Ordered array to destroy.
+ */
+void orderedArrayDestroy(OrderedArray array){
+    if(!array){
+        return;
+    }
+    free(array->elements);
+    free(array);
+}
+
+/** Rows: 4
+ ***** Function: orderedArrayGetSize *****
+ * Description: Returns the number of elements in the array.
+ *
+ * @param array - Ordered array to check.
+ *
+ * @return
+ * Number of elements, or -1 if array is NULL.
+ */
+int orderedArrayGetSize(OrderedArray array){
+    if(!array){
+        return -1;
+    }
+    return array->size;
+}
+
+/** Rows: 4
+ ***** Function: orderedArrayGet *****
+ * Description: Returns the element in the given position.
+ *
+ * @param array - Ordered array to get from.
+ * @param position - Position of the element, from 0 to size-1.
+ *
+ * @return
+ * The element or NULL if array is NULL or position is out of range.
+ */
+OrderedArrayElement orderedArrayGet(OrderedArray array, int position){
+    if(!array || position<0 || position>=array->size){
+        return NULL;
+    }
+    return array->elements[position];
+}
+
+/** Rows: 20
+ ***** Function: orderedArrayInsert *****
+ * Description: Inserts an element to its place in the array. Takes
+ * O(log n) comparisons.
+ *
+ * @param array - Ordered array to insert to.
+ * @param element - Element to insert.
+ *
+ * @return
+ * ORDERED_ARRAY_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * ORDERED_ARRAY_ALREADY_EXISTS - An equal element is in the array.
+ * ORDERED_ARRAY_OUT_OF_MEMORY - Failed to grow the array.
+ * ORDERED_ARRAY_SUCCESS - Element inserted.
+ */
+OrderedArrayResult orderedArrayInsert(OrderedArray array,
+                                      OrderedArrayElement element){
+    if(!array || !element){
+        return ORDERED_ARRAY_NULL_ARGUMENT;
+    }
+    int position = orderedArrayLowerBound(array,element);
+    if(position<array->size &&
+       array->compareElements(array->elements[position],element)==0){
+        return ORDERED_ARRAY_ALREADY_EXISTS;
+    }
+    if(array->size==array->capacity){
+        if(orderedArrayGrow(array)!=ORDERED_ARRAY_SUCCESS){
+            return ORDERED_ARRAY_OUT_OF_MEMORY;
+        }
+    }
+    /* Making room for the new element. */
+    memmove(array->elements+position+1,array->elements+position,
+            (size_t)(array->size-position)*sizeof(OrderedArrayElement));
+    array->elements[position] = element;
+    array->size++;
+    return ORDERED_ARRAY_SUCCESS;
+}
+
+/** Rows: 15
+ ***** Function: orderedArrayAppend *****
+ * Description: Puts an element after all the elements of the array. Takes
+ * O(1), for building an array from elements that are already sorted.
+ *
+ * @param array - Ordered array to append to.
+ * @param element - Element to append. Must be bigger than the last
+ * element of the array.
+ *
+ * @return
+ * ORDERED_ARRAY_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * ORDERED_ARRAY_OUT_OF_ORDER - The element is not bigger than the last
+ * element. Nothing is changed.
+ * ORDERED_ARRAY_OUT_OF_MEMORY - Failed to grow the array.
+ * ORDERED_ARRAY_SUCCESS - Element appended.
+ */
+OrderedArrayResult orderedArrayAppend(OrderedArray array,
+                                      OrderedArrayElement element){
+    if(!array || !element){
+        return ORDERED_ARRAY_NULL_ARGUMENT;
+    }
+    if(array->size>0 &&
+       array->compareElements(array->elements[array->size-1],element)>=0){
+        return ORDERED_ARRAY_OUT_OF_ORDER;
+    }
+    if(array->size==array->capacity &&
+       orderedArrayGrow(array)!=ORDERED_ARRAY_SUCCESS){
+        return ORDERED_ARRAY_OUT_OF_MEMORY;
+    }
+    array->elements[array->size] = element;
+    array->size++;
+    return ORDERED_ARRAY_SUCCESS;
+}
+
+/** Rows: 14
+ ***** Function: orderedArrayRemove *****
+ * Description: Removes the element that is equal to the given element from
+ * the array. Takes O(log n) comparisons.
+ *
+ * @param array - Ordered array to remove from.
+ * @param element - Element to remove.
+ *
+ * @return
+ * ORDERED_ARRAY_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * ORDERED_ARRAY_DOES_NOT_EXIST - No equal element in the array.
+ * ORDERED_ARRAY_SUCCESS - Element removed.
+ */
+OrderedArrayResult orderedArrayRemove(OrderedArray array,
+                                      OrderedArrayElement element){
+    if(!array || !element){
+        return ORDERED_ARRAY_NULL_ARGUMENT;
+    }
+    int position = orderedArrayLowerBound(array,element);
+    if(position==array->size ||
+       array->compareElements(array->elements[position],element)!=0){
+        return ORDERED_ARRAY_DOES_NOT_EXIST;
+    }
+    memmove(array->elements+position,array->elements+position+1,
+            (size_t)(array->size-position-1)*sizeof(OrderedArrayElement));
+    array->size--;
+    return ORDERED_ARRAY_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------//
+//                   ORDERED ARRAY: STATIC FUNCTIONS                     //
+//-----------------------------------------------------------------------//
+
+/** Rows: 12
+ ***** Static function: orderedArrayLowerBound *****
+ * Description: Binary search for the first position in the array that
+ * holds an element which is not smaller than the given element.
+ *
+ * @param array - Ordered array to search in.
+ * @param element - Element to search for.
+ *
+ * @return
+ * Position of the element if it is in the array, else the position it
+ * should be inserted to (size if it is bigger than all the elements).
+ */
+static int orderedArrayLowerBound(OrderedArray array,
+                                  OrderedArrayElement element){
+    int low = 0;
+    int high = array->size;
+    while(low<high){
+        int middle = low+(high-low)/2;
+        if(array->compareElements(array->elements[middle],element)<0){
+            low = middle+1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/** Rows: 10
+ ***** Static function: orderedArrayGrow *****
+ * Description: Doubles the capacity of the array.
+ *
+ * @param array - Ordered array to grow.
+ *
+ * @return
+ * ORDERED_ARRAY_OUT_OF_MEMORY - Memory allocation failed, the array is
+ * left unchanged.
+ * ORDERED_ARRAY_SUCCESS - Array grew.
+ */
+static OrderedArrayResult orderedArrayGrow(OrderedArray array){
+    int new_capacity = array->capacity*2;
+    OrderedArrayElement* new_elements = realloc(array->elements,
+                     (size_t)new_capacity*sizeof(OrderedArrayElement));
+    if(!new_elements){
+        return ORDERED_ARRAY_OUT_OF_MEMORY;
+    }
+    array->elements = new_elements;
+    array->capacity = new_capacity;
+    return ORDERED_ARRAY_SUCCESS;
+}
@@ -0,0 +1,143 @@
+#ifndef MTM_EX3_MTMFLIX_ORDERED_ARRAY_H
+#define MTM_EX3_MTMFLIX_ORDERED_ARRAY_H
+
+#include <stdbool.h>
+
+//-----------------------------------------------------------------------//
+//                ORDERED ARRAY: TYPEDEFS AND DEFINES                    //
+//-----------------------------------------------------------------------//
+
+/**
+ * Ordered array: a growable array of element references kept sorted by a
+ * given compare function. Elements are not copied and are not owned by the
+ * array.
+ *
+ * Unlike the Set of libmtm, the array has no internal iterator. Elements
+ * are reached by their position, so any number of traversals of the same
+ * array can be nested without copying it:
+ *
+ *     for(int i=0;i<orderedArrayGetSize(array);i++){
+ *         Element element = orderedArrayGet(array,i);
+ *         ...
+ *     }
+ *
+ * The array must not be changed while it is being traversed.
+ */
+
+typedef struct ordered_array_t* OrderedArray;
+
+typedef void* OrderedArrayElement;
+
+/** Compares two elements. Same return values as strcmp. */
+typedef int(*compareOrderedArrayElements)(OrderedArrayElement,
+                                          OrderedArrayElement);
+
+typedef enum {
+    ORDERED_ARRAY_SUCCESS,
+    ORDERED_ARRAY_OUT_OF_MEMORY,
+    ORDERED_ARRAY_NULL_ARGUMENT,
+    ORDERED_ARRAY_ALREADY_EXISTS,
+    ORDERED_ARRAY_DOES_NOT_EXIST,
+    ORDERED_ARRAY_OUT_OF_ORDER
+} OrderedArrayResult;
+
+
+//-----------------------------------------------------------------------//
+//                ORDERED ARRAY: FUNCTIONS DECLARATIONS                  //
+//-----------------------------------------------------------------------//
+
+/**
+ ***** Function: orderedArrayCreate *****
+ * Description: Creates a new empty ordered array.
+ *
+ * @param compareElements - Function that defines the order of elements.
+ *
+ * @return
+ * A new ordered array or NULL in case of NULL argument or memory error.
+ */
+OrderedArray orderedArrayCreate(compareOrderedArrayElements compareElements);
+
+/**
+ ***** Function: orderedArrayDestroy *****
+ * Description: Deallocates the array. The elements are not deallocated.
+ *
+ * @param array - Ordered array to destroy.
+ */
+void orderedArrayDestroy(OrderedArray array);
+
+/**
+ ***** Function: orderedArrayGetSize *****
+ * Description: Returns the number of elements in the array.
+ *
+ * @param array - Ordered array to check.
+ *
+ * @return
+ * Number of elements, or -1 if array is NULL.
+ */
+int orderedArrayGetSize(OrderedArray array);
+
+/**
+ ***** Function: orderedArrayGet *****
+ * Description: Returns the element in the given position.
+ *
+ * @param array - Ordered array to get from.
+ * @param position - Position of the element, from 0 to size-1.
+ *
+ * @return
+ * The element or NULL if array is NULL or position is out of range.
+ */
+OrderedArrayElement orderedArrayGet(OrderedArray array, int position);
+
+/**
+ ***** Function: orderedArrayInsert *****
+ * Description: Inserts an element to its place in the array. Takes
+ * O(log n) comparisons.
+ *
+ * @param array - Ordered array to insert to.
+ * @param element - Element to insert.
+ *
+ * @return
+ * ORDERED_ARRAY_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * ORDERED_ARRAY_ALREADY_EXISTS - An equal element is in the array.
+ * ORDERED_ARRAY_OUT_OF_MEMORY - Failed to grow the array.
+ * ORDERED_ARRAY_SUCCESS - Element inserted.
+ */
+OrderedArrayResult orderedArrayInsert(OrderedArray array,
+                                      OrderedArrayElement element);
+
+/**
+ ***** Function: orderedArrayAppend *****
+ * Description: Puts an element after all the elements of the array. Takes
+ * O(1), for building an array from elements that are already sorted.
+ *
+ * @param array - Ordered array to append to.
+ * @param element - Element to append. Must be bigger than the last
+ * element of the array.
+ *
+ * @return
+ * ORDERED_ARRAY_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * ORDERED_ARRAY_OUT_OF_ORDER - The element is not bigger than the last
+ * element. Nothing is changed.
+ * ORDERED_ARRAY_OUT_OF_MEMORY - Failed to grow the array.
+ * ORDERED_ARRAY_SUCCESS - Element appended.
+ */
+OrderedArrayResult orderedArrayAppend(OrderedArray array,
+                                      OrderedArrayElement element);
+
+/**
+ ***** Function: orderedArrayRemove *****
+ * Description: Removes the element that is equal to the given element from
+ * the array. Takes O(log n) comparisons.
+ *
+ * @param array - Ordered array to remove from.
+ * @param element - Element to remove.
+ *
+ * @return
+ * ORDERED_ARRAY_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * ORDERED_ARRAY_DOES_NOT_EXIST - No equal element in the array.
+ * ORDERED_ARRAY_SUCCESS - Element removed.
+ */
+OrderedArrayResult orderedArrayRemove(OrderedArray array,
+                                      OrderedArrayElement element);
+
+#endif //MTM_EX3_MTMFLIX_ORDERED_ARRAY_H
@@ -7,96 +7,224 @@
 //                        RANKED SERIES: STRUCT                          //
 //-----------------------------------------------------------------------//
 
+typedef struct {
+    int rank;
+    Series series;
+} RankedSeriesEntry;
 
 struct ranked_series_t{
-    int rank;
-    char* series_name;
-    char* series_genre;
+    /* Heap of the kept series. The worst series kept is in the root. */
+    RankedSeriesEntry* entries;
+    int size;
+    int capacity;
+    int allocated; // Number of entries the array has room for.
 };
 
 
+//-----------------------------------------------------------------------//
+//             RANKED SERIES: STATIC FUNCTIONS DECLARATIONS              //
+//-----------------------------------------------------------------------//
+
+static int rankedSeriesCompare (RankedSeriesEntry* entry1,
+                                RankedSeriesEntry* entry2);
+
+static void rankedSeriesSiftUp (RankedSeries ranked_series, int position);
+
+static void rankedSeriesSiftDown (RankedSeries ranked_series,
+                                  int position);
+
+static int rankedSeriesSort (RankedSeries ranked_series);
+
+
 //-----------------------------------------------------------------------//
 //                        RANKED SERIES: FUNCTIONS                       //
 //-----------------------------------------------------------------------//
 
 /**
  ***** Function : rankedSeriesCreate *****
- * Description : Creates a new ranked series.
+ * Description : Creates a new empty ranked series collection.
  *
- * @param rank - Series rank.
- * @param series_name - Series name.
- * @param series_genre - Series genre.
+ * @param capacity - Maximum number of series to keep.
  *
  * @return
- * NULL in case of memory allocation error, else a pointer to a new ranked
- * series.
+ * NULL in case of memory allocation error or negative capacity, else a
+ * pointer to a new ranked series collection.
  */
-RankedSeries rankedSeriesCreate (int rank, char* series_name,
-                                 char* series_genre){
-    RankedSeries new_ranked_series=malloc(sizeof(*new_ranked_series));
-    if(!new_ranked_series){
+RankedSeries rankedSeriesCreate (int capacity){
+    if(capacity<0){
         return NULL;
     }
-    char* series_name_copy=malloc(strlen(series_name)+1);
-    if(!series_name_copy){
-        free(new_ranked_series);
+    RankedSeries new_ranked_series=malloc(sizeof(*new_ranked_series));
+    if(!new_ranked_series){
         return NULL;
     }
-    strcpy(series_name_copy,series_name);
-    new_ranked_series->series_name=series_name_copy;
-    char* series_genre_copy=malloc(strlen(series_genre)+1);
-    if(!series_genre_copy){
-        free(series_name_copy);
+    /* At least one entry, so malloc never gets 0. */
+    new_ranked_series->entries=malloc(
+            sizeof(RankedSeriesEntry)*(capacity>0 ? capacity : 1));
+    if(!new_ranked_series->entries){
         free(new_ranked_series);
         return NULL;
     }
-    strcpy(series_genre_copy,series_genre);
-    new_ranked_series->series_genre=series_genre_copy;
-    new_ranked_series->rank=rank;
+    new_ranked_series->size=0;
+    new_ranked_series->capacity=capacity;
+    new_ranked_series->allocated=capacity>0 ? capacity : 1;
     return new_ranked_series;
 }
 
 /**
- ***** Function : rankedSeriesCopy *****
- * Description: Creates a copy of a given ranked series.
+ ***** Function : rankedSeriesDestroy *****
+ * Description: Deallocates all recources of a ranked series collection.
+ * The series themselves are not destroyed.
  *
- * @param ranked_series - Ranked series to create a copy of.
+ * @param ranked_series - Ranked series to destroy.
+ */
+void rankedSeriesDestroy (RankedSeries ranked_series){
+    if(!ranked_series){
+        return;
+    }
+    free(ranked_series->entries);
+    free(ranked_series);
+}
+
+/**
+ ***** Function : rankedSeriesReset *****
+ * Description: Empties the collection and changes its capacity, so one
+ * collection can be used for many recommendations. The array of entries
+ * is only reallocated if it is too small for the new capacity.
+ *
+ * @param ranked_series - Collection to reset.
+ * @param capacity - New maximum number of series to keep.
  *
  * @return
- * NULL - Any memory error.
- * Copy of given ranked series - Else.
+ * MTMFLIX_OUT_OF_MEMORY - Failed to grow the array, the collection is
+ * left empty with its old capacity.
+ * MTMFLIX_SUCCESS - Collection reset.
  */
-RankedSeries rankedSeriesCopy (RankedSeries ranked_series){
-    RankedSeries ranked_series_copy=rankedSeriesCreate(ranked_series->rank,
-            ranked_series->series_name,ranked_series->series_genre);
-    if(!ranked_series_copy){
-        return NULL;
+MtmFlixResult rankedSeriesReset (RankedSeries ranked_series, int capacity){
+    assert(ranked_series && capacity>=0);
+    ranked_series->size=0;
+    if(capacity>ranked_series->allocated){
+        RankedSeriesEntry* new_entries=realloc(ranked_series->entries,
+                                sizeof(RankedSeriesEntry)*capacity);
+        if(!new_entries){
+            return MTMFLIX_OUT_OF_MEMORY;
+        }
+        ranked_series->entries=new_entries;
+        ranked_series->allocated=capacity;
     }
-    return ranked_series_copy;
+    ranked_series->capacity=capacity;
+    return MTMFLIX_SUCCESS;
 }
 
 /**
- ***** Function : rankedSeriesDestroy *****
- * Description: Deallocates all recources of a ranked series.
+ ***** Function : rankedSeriesOffer *****
+ * Description: Offers a ranked series to the collection. The series is
+ * kept if the collection is not full or if it is better than the worst
+ * series kept (which is then dropped). Series with rank 0 are never
+ * recommended, so they are not kept.
  *
- * @param ranked_series - Ranked series to destroy.
+ * @param ranked_series - Collection to offer to.
+ * @param rank - Rank of the series.
+ * @param series - The series. Must stay alive as long as it is kept.
  */
-void rankedSeriesDestroy (RankedSeries ranked_series){
-    if(!ranked_series){
+void rankedSeriesOffer (RankedSeries ranked_series, int rank,
+                        Series series){
+    assert(ranked_series && series);
+    if(rank==0){
         return;
     }
-    free(ranked_series->series_genre);
-    free(ranked_series->series_name);
-    free(ranked_series);
+    RankedSeriesEntry entry = {rank,series};
+    if(ranked_series->size<ranked_series->capacity){
+        ranked_series->entries[ranked_series->size]=entry;
+        ranked_series->size++;
+        rankedSeriesSiftUp(ranked_series,ranked_series->size-1);
+        return;
+    }
+    if(ranked_series->size==0 ||
+       rankedSeriesCompare(&entry,&ranked_series->entries[0])>=0){
+        /* Not better than the worst series kept. */
+        return;
+    }
+    /* Replacing the worst series kept. */
+    ranked_series->entries[0]=entry;
+    rankedSeriesSiftDown(ranked_series,0);
 }
 
 /**
- ***** Function : rankedSeriesCompare *****
+ ***** Function : rankedSeriesGetMinimalRank *****
+ * Description: Returns the lowest rank an offered series may have and
+ * still be kept. While the collection is not full it is 1 (series with
+ * rank 0 are never kept), and then it is the rank of the worst series
+ * kept. A series with this very rank is kept only if its name is smaller,
+ * so any series with a lower rank can be skipped without offering it.
+ *
+ * @param ranked_series - Collection of ranked series.
+ *
+ * @return
+ * The lowest rank that may still be kept.
+ */
+int rankedSeriesGetMinimalRank (RankedSeries ranked_series){
+    assert(ranked_series);
+    if(ranked_series->size<ranked_series->capacity ||
+       ranked_series->size==0){
+        return 1;
+    }
+    return ranked_series->entries[0].rank;
+}
+
+/**
+ ***** Function : rankedSeriesMerge *****
+ * Description: Offers all the series kept by one collection to another,
+ * with their ranks, and empties it. Since the order of the series does not
+ * depend on the order they were offered in, the best series of some parts
+ * of the series merged together are the best series of all of them.
+ *
+ * @param ranked_series - Collection to offer to.
+ * @param other - Collection whose series are offered. Emptied.
+ */
+void rankedSeriesMerge (RankedSeries ranked_series, RankedSeries other){
+    assert(ranked_series && other);
+    for(int i=0;i<other->size;i++){
+        rankedSeriesOffer(ranked_series,other->entries[i].rank,
+                          other->entries[i].series);
+    }
+    other->size=0;
+}
+
+/**
+ ***** Function : rankedSeriesTakeSorted *****
+ * Description: Copies the kept series to an array, best series first. The
+ * collection is emptied. Used to print the series later, or by another
+ * thread.
+ *
+ * @param ranked_series - Collection of ranked series.
+ * @param series - Array to copy the series to. Must have room for the
+ * capacity of the collection.
+ *
+ * @return
+ * The number of series copied.
+ */
+int rankedSeriesTakeSorted (RankedSeries ranked_series, Series* series){
+    assert(ranked_series && series);
+    int number_of_series=rankedSeriesSort(ranked_series);
+    for(int i=0;i<number_of_series;i++){
+        series[i]=ranked_series->entries[i].series;
+    }
+    return number_of_series;
+}
+
+
+//-----------------------------------------------------------------------//
+//                    RANKED SERIES: STATIC FUNCTIONS                    //
+//-----------------------------------------------------------------------//
+
+/**
+ ***** Static function : rankedSeriesCompare *****
  * Description : Compares between to ranked series by their rank, if the
  * rank is equal, the comparison is made by their names.
  *
- * @param ranked_series1 - A ranked series to compare.
- * @param ranked_series2 - A ranked series to compare.
+ * @param entry1 - A ranked series to compare.
+ * @param entry2 - A ranked series to compare.
  *
  * @return
  * If the ranks are different, return a positive integer if the rank of
@@ -104,49 +232,93 @@ void rankedSeriesDestroy (RankedSeries ranked_series){
  * equal the comparison is made by strcmp (returns a positive integer if
  * the name of ranked series 1 has a bigger value).
  */
-int rankedSeriesCompare (RankedSeries ranked_series1,
-                         RankedSeries ranked_series2){
-    if((ranked_series1->rank)!=(ranked_series2->rank)){
-        return (ranked_series2->rank)-(ranked_series1->rank);
+static int rankedSeriesCompare (RankedSeriesEntry* entry1,
+                                RankedSeriesEntry* entry2){
+    if((entry1->rank)!=(entry2->rank)){
+        return (entry2->rank)-(entry1->rank);
     }
-    return strcmp(ranked_series1->series_name,ranked_series2->series_name);
+    return strcmp(seriesGetName(entry1->series),
+                  seriesGetName(entry2->series));
 }
 
 /**
- ***** Function : rankedSeriesPrintToFile *****
- * Description: Prints ranked series to file.
- *
- * @param number_of_series_to_print - The number of series to print to
- * file from each genre. If the number is 0 we need to print all the Ranked
- * series.
- * @param ranked_series_set - Set of all ranked series.
- * @param outputStream - A file to print to.
- * @param result - The status of the function, in case of memory allocation
- * error will be updated to MTMFLIX_OUT_OF_MEMORY.
+ ***** Static function : rankedSeriesSiftUp *****
+ * Description: Moves an entry up the heap until its parent is worse.
+ *
+ * @param ranked_series - Collection of ranked series.
+ * @param position - Position of the entry to move.
  */
-void rankedSeriesPrintToFile(int number_of_series_to_print,
-                             Set ranked_series_set,
-                             FILE* outputStream,MtmFlixResult* result){
-    if(number_of_series_to_print==0){
-        number_of_series_to_print=setGetSize(ranked_series_set);
+static void rankedSeriesSiftUp (RankedSeries ranked_series, int position){
+    RankedSeriesEntry* entries=ranked_series->entries;
+    while(position>0){
+        int parent=(position-1)/2;
+        if(rankedSeriesCompare(&entries[parent],&entries[position])>=0){
+            return;
+        }
+        RankedSeriesEntry temp=entries[parent];
+        entries[parent]=entries[position];
+        entries[position]=temp;
+        position=parent;
     }
-    SET_FOREACH(RankedSeries,ranked_series,ranked_series_set){
-        if(ranked_series->rank==0){
-            continue;
+}
+
+/**
+ ***** Static function : rankedSeriesSiftDown *****
+ * Description: Moves an entry down the heap until both its children are
+ * better.
+ *
+ * @param ranked_series - Collection of ranked series.
+ * @param position - Position of the entry to move.
+ */
+static void rankedSeriesSiftDown (RankedSeries ranked_series,
+                                  int position){
+    RankedSeriesEntry* entries=ranked_series->entries;
+    int size=ranked_series->size;
+    while(true){
+        int worst=position;
+        int left=2*position+1;
+        int right=left+1;
+        if(left<size &&
+           rankedSeriesCompare(&entries[left],&entries[worst])>0){
+            worst=left;
         }
-        if(number_of_series_to_print>0){
-            const char* ranked_series_details=mtmPrintSeries
-                    (ranked_series->series_name,
-                     ranked_series->series_genre);
-            if(!ranked_series_details){
-                *result=MTMFLIX_OUT_OF_MEMORY;
-                return;
-            }
-            if((fprintf(outputStream,"%s",ranked_series_details)<0)){
-                *result=MTMFLIX_OUT_OF_MEMORY;
-                return;
-            }
+        if(right<size &&
+           rankedSeriesCompare(&entries[right],&entries[worst])>0){
+            worst=right;
         }
-        number_of_series_to_print--;
+        if(worst==position){
+            return;
+        }
+        RankedSeriesEntry temp=entries[worst];
+        entries[worst]=entries[position];
+        entries[position]=temp;
+        position=worst;
+    }
+}
+
+/**
+ ***** Static function : rankedSeriesSort *****
+ * Description: Sorts the entries from the best series to the worst and
+ * empties the heap. The sorted entries stay in the array until the next
+ * series is offered.
+ *
+ * @param ranked_series - Collection of ranked series.
+ *
+ * @return
+ * The number of sorted entries.
+ */
+static int rankedSeriesSort (RankedSeries ranked_series){
+    /* Popping the worst series into the end of the array each time sorts
+     * the array from the best series to the worst. */
+    int number_of_series=ranked_series->size;
+    while(ranked_series->size>1){
+        RankedSeriesEntry worst=ranked_series->entries[0];
+        ranked_series->size--;
+        ranked_series->entries[0]=
+                ranked_series->entries[ranked_series->size];
+        ranked_series->entries[ranked_series->size]=worst;
+        rankedSeriesSiftDown(ranked_series,0);
     }
-}
\ No newline at end of file
+    ranked_series->size=0;
+    return number_of_series;
+}
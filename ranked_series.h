@@ -2,13 +2,22 @@
 #define MTM_EX3_MTMFLIX_RANKED_SERIES_H
 
 #include <assert.h>
-#include "set.h"
+#include "series.h"
 #include "mtmflix.h"
 
 //-----------------------------------------------------------------------//
 //                 RANKED SERIES: TYPEDEFS AND DEFINES                   //
 //-----------------------------------------------------------------------//
 
+/**
+ * Ranked series: keeps the best ranked series out of all the series that
+ * are offered to it, up to a fixed capacity. The series are kept as
+ * (rank, series) pairs in a bounded heap whose root is the worst series
+ * kept, so offering a series takes O(log capacity) and nothing is copied.
+ *
+ * The series are ordered by rank (higher first), and series with the same
+ * rank are ordered by name.
+ */
 
 typedef struct ranked_series_t* RankedSeries;
 
@@ -19,70 +28,95 @@ typedef struct ranked_series_t* RankedSeries;
 
 /**
  ***** Function : rankedSeriesCreate *****
- * Description : Creates a new ranked series.
+ * Description : Creates a new empty ranked series collection.
  *
- * @param rank - Series rank.
- * @param series_name - Series name.
- * @param series_genre - Series genre.
+ * @param capacity - Maximum number of series to keep.
  *
  * @return
- * NULL in case of memory allocation error, else a pointer to a new ranked
- * series.
+ * NULL in case of memory allocation error or negative capacity, else a
+ * pointer to a new ranked series collection.
+ */
+RankedSeries rankedSeriesCreate (int capacity);
+
+/**
+ ***** Function : rankedSeriesDestroy *****
+ * Description: Deallocates all recources of a ranked series collection.
+ * The series themselves are not destroyed.
+ *
+ * @param ranked_series - Ranked series to destroy.
  */
-RankedSeries rankedSeriesCreate (int rank,char* series_name,
-                                 char* series_genre);
+void rankedSeriesDestroy (RankedSeries ranked_series);
 
 /**
- ***** Function : rankedSeriesCopy *****
- * Description: Creates a copy of a given ranked series.
+ ***** Function : rankedSeriesReset *****
+ * Description: Empties the collection and changes its capacity, so one
+ * collection can be used for many recommendations. The array of entries
+ * is only reallocated if it is too small for the new capacity.
  *
- * @param ranked_series - Ranked series to create a copy of.
+ * @param ranked_series - Collection to reset.
+ * @param capacity - New maximum number of series to keep.
  *
  * @return
- * NULL - Any memory error.
- * Copy of given ranked series - Else.
+ * MTMFLIX_OUT_OF_MEMORY - Failed to grow the array, the collection is
+ * left empty with its old capacity.
+ * MTMFLIX_SUCCESS - Collection reset.
  */
-RankedSeries rankedSeriesCopy (RankedSeries ranked_series);
+MtmFlixResult rankedSeriesReset (RankedSeries ranked_series, int capacity);
 
 /**
- ***** Function : rankedSeriesDestroy *****
- * Description: Deallocates all recources of a ranked series.
+ ***** Function : rankedSeriesOffer *****
+ * Description: Offers a ranked series to the collection. The series is
+ * kept if the collection is not full or if it is better than the worst
+ * series kept (which is then dropped). Series with rank 0 are never
+ * recommended, so they are not kept.
  *
- * @param ranked_series - Ranked series to destroy.
+ * @param ranked_series - Collection to offer to.
+ * @param rank - Rank of the series.
+ * @param series - The series. Must stay alive as long as it is kept.
  */
-void rankedSeriesDestroy (RankedSeries ranked_series);
+void rankedSeriesOffer (RankedSeries ranked_series, int rank,
+                        Series series);
 
 /**
- ***** Function : rankedSeriesCompare *****
- * Description : Compares between to ranked series by their rank, if the
- * rank is equal, the comparison is made by their names.
+ ***** Function : rankedSeriesGetMinimalRank *****
+ * Description: Returns the lowest rank an offered series may have and
+ * still be kept. While the collection is not full it is 1 (series with
+ * rank 0 are never kept), and then it is the rank of the worst series
+ * kept. A series with this very rank is kept only if its name is smaller,
+ * so any series with a lower rank can be skipped without offering it.
  *
- * @param ranked_series1 - A ranked series to compare.
- * @param ranked_series2 - A ranked series to compare.
+ * @param ranked_series - Collection of ranked series.
  *
  * @return
- * If the ranks are different, return a positive integer if the rank of
- * ranked series 2 is higher else a negative integer. If the ranks are
- * equal the comparison is made by strcmp (returns a positive integer if
- * the name of ranked series 1 has a bigger value).
+ * The lowest rank that may still be kept.
  */
-int rankedSeriesCompare (RankedSeries ranked_series1,
-                         RankedSeries ranked_series2);
+int rankedSeriesGetMinimalRank (RankedSeries ranked_series);
 
 /**
- ***** Function : rankedSeriesPrintToFile *****
- * Description: Prints ranked series to file.
+ ***** Function : rankedSeriesMerge *****
+ * Description: Offers all the series kept by one collection to another,
+ * with their ranks, and empties it. Since the order of the series does not
+ * depend on the order they were offered in, the best series of some parts
+ * of the series merged together are the best series of all of them.
  *
- * @param number_of_series_to_print - The number of series to print to
- * file from each genre. If the number is 0 we need to print all the Ranked
- * series.
- * @param ranked_series_set - Set of all ranked series.
- * @param outputStream - A file to print to.
- * @param result - The status of the function, in case of memory allocation
- * error will be updated to MTMFLIX_OUT_OF_MEMORY.
+ * @param ranked_series - Collection to offer to.
+ * @param other - Collection whose series are offered. Emptied.
+ */
+void rankedSeriesMerge (RankedSeries ranked_series, RankedSeries other);
+
+/**
+ ***** Function : rankedSeriesTakeSorted *****
+ * Description: Copies the kept series to an array, best series first. The
+ * collection is emptied. Used to print the series later, or by another
+ * thread.
+ *
+ * @param ranked_series - Collection of ranked series.
+ * @param series - Array to copy the series to. Must have room for the
+ * capacity of the collection.
+ *
+ * @return
+ * The number of series copied.
  */
-void rankedSeriesPrintToFile(int number_of_series_to_print,
-                             Set ranked_series_set,
-                             FILE* outputStream,MtmFlixResult* result);
+int rankedSeriesTakeSorted (RankedSeries ranked_series, Series* series);
 
 #endif //MTM_EX3_MTMFLIX_RANKED_SERIES_H
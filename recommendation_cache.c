@@ -0,0 +1,227 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "recommendation_cache.h"
+
+#define RECOMMENDATION_CACHE_INITIAL_TEXT 64
+
+//-----------------------------------------------------------------------//
+//         RECOMMENDATION CACHE: STATIC FUNCTIONS DECLARATIONS           //
+//-----------------------------------------------------------------------//
+
+typedef struct recommendation_cache_entry_t* RecommendationCacheEntry;
+
+static RecommendationCacheEntry recommendationCacheGetEntry(
+        RecommendationCache cache, unsigned int user_id, int count);
+
+static bool recommendationCacheAppend(RecommendationCacheEntry entry,
+                                      const char* text);
+
+//-----------------------------------------------------------------------//
+//                   RECOMMENDATION CACHE: STRUCT                        //
+//-----------------------------------------------------------------------//
+
+struct recommendation_cache_entry_t{
+    bool used;
+    unsigned int user_id;
+    int count;
+    unsigned int version; // Version of the user's recommendations.
+    char* text; // The printed recommendations, kept between uses.
+    size_t length;
+    size_t allocated; // Number of chars text has room for.
+};
+
+struct recommendation_cache_t{
+    struct recommendation_cache_entry_t* entries;
+    int capacity;
+};
+
+
+//-----------------------------------------------------------------------//
+//                  RECOMMENDATION CACHE: FUNCTIONS                      //
+//-----------------------------------------------------------------------//
+
+/** Rows: 20
+ ***** Function: recommendationCacheCreate *****
+ * Description: Creates a new empty recommendation cache.
+ *
+ * @param capacity - Number of entries of the cache.
+ *
+ * @return
+ * A new cache or NULL in case of memory error or capacity smaller than 1.
+ */
+RecommendationCache recommendationCacheCreate(int capacity){
+    if(capacity<1){
+        return NULL;
+    }
+    RecommendationCache cache = malloc(sizeof(*cache));
+    if(!cache){
+        return NULL;
+    }
+    cache->entries = malloc(sizeof(*cache->entries)*capacity);
+    if(!cache->entries){
+        free(cache);
+        return NULL;
+    }
+    for(int i=0;i<capacity;i++){
+        cache->entries[i].used = false;
+        cache->entries[i].text = NULL;
+        cache->entries[i].length = 0;
+        cache->entries[i].allocated = 0;
+    }
+    cache->capacity = capacity;
+    return cache;
+}
+
+/** Rows: 8
+ ***** Function: recommendationCacheDestroy *****
+ * Description: Deallocates a recommendation cache.
+ *
+ * @param cache - Cache to destroy.
+ */
+void recommendationCacheDestroy(RecommendationCache cache){
+    if(!cache){
+        return;
+    }
+    for(int i=0;i<cache->capacity;i++){
+        free(cache->entries[i].text);
+    }
+    free(cache->entries);
+    free(cache);
+}
+
+/** Rows: 13
+ ***** Function: recommendationCacheFind *****
+ * Description: Finds the printed recommendations of a user.
+ *
+ * @param cache - Cache to search in.
+ * @param user_id - Id of the user.
+ * @param count - The number of series the user asked for.
+ * @param version - The current version of the user's recommendations.
+ * @param text - Will point to the printed recommendations. The text
+ * belongs to the cache, it is valid until the cache is changed.
+ * @param length - Will hold the length of the text.
+ *
+ * @return
+ * True - The recommendations were found.
+ * False - They were not found, or were made in an older version.
+ */
+bool recommendationCacheFind(RecommendationCache cache,
+                             unsigned int user_id, int count,
+                             unsigned int version, const char** text,
+                             size_t* length){
+    assert(cache && text && length);
+    RecommendationCacheEntry entry = recommendationCacheGetEntry(cache,
+                                                          user_id,count);
+    if(!entry->used || entry->user_id!=user_id || entry->count!=count ||
+       entry->version!=version){
+        return false;
+    }
+    *text = entry->text;
+    *length = entry->length;
+    return true;
+}
+
+/** Rows: 24
+ ***** Function: recommendationCachePut *****
+ * Description: Keeps the recommendations of a user, as they are printed.
+ * Replaces the pair that was kept in the same entry.
+ *
+ * @param cache - Cache to put in.
+ * @param user_id - Id of the user.
+ * @param count - The number of series the user asked for.
+ * @param version - The current version of the user's recommendations.
+ * @param series - The recommended series, best first.
+ * @param series_num - Number of recommended series.
+ *
+ * @return
+ * RECOMMENDATION_CACHE_NULL_ARGUMENT - Cache or series is NULL.
+ * RECOMMENDATION_CACHE_OUT_OF_MEMORY - Any memory error. The entry is left
+ * empty.
+ * RECOMMENDATION_CACHE_SUCCESS - Recommendations kept.
+ */
+RecommendationCacheResult recommendationCachePut(RecommendationCache cache,
+                                                 unsigned int user_id,
+                                                 int count,
+                                                 unsigned int version,
+                                                 Series* series,
+                                                 int series_num){
+    if(!cache || !series){
+        return RECOMMENDATION_CACHE_NULL_ARGUMENT;
+    }
+    RecommendationCacheEntry entry = recommendationCacheGetEntry(cache,
+                                                          user_id,count);
+    /* The text of the replaced pair is overwritten, its memory is kept. */
+    entry->used = false;
+    entry->length = 0;
+    for(int i=0;i<series_num;i++){
+        const char* details = seriesGetDetails(series[i]);
+        if(!details || !recommendationCacheAppend(entry,details)){
+            return RECOMMENDATION_CACHE_OUT_OF_MEMORY;
+        }
+    }
+    entry->used = true;
+    entry->user_id = user_id;
+    entry->count = count;
+    entry->version = version;
+    return RECOMMENDATION_CACHE_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------//
+//                RECOMMENDATION CACHE: STATIC FUNCTIONS                 //
+//-----------------------------------------------------------------------//
+
+/** Rows: 5
+ ***** Static function: recommendationCacheGetEntry *****
+ * Description: Returns the only entry a (user id, count) pair can be kept
+ * in.
+ *
+ * @param cache - Cache of the entry.
+ * @param user_id - Id of the user.
+ * @param count - The number of series the user asked for.
+ *
+ * @return
+ * The entry of the pair.
+ */
+static RecommendationCacheEntry recommendationCacheGetEntry(
+        RecommendationCache cache, unsigned int user_id, int count){
+    /* Multiplicative hashing spreads consecutive ids over the entries. */
+    unsigned int hash = user_id*2654435761u;
+    hash ^= (unsigned int)count*40503u;
+    return &cache->entries[hash%(unsigned int)cache->capacity];
+}
+
+/** Rows: 18
+ ***** Static function: recommendationCacheAppend *****
+ * Description: Appends a text to the text of an entry, which grows if it
+ * is too small. The text of the entry is kept terminated.
+ *
+ * @param entry - Entry to append to.
+ * @param text - Text to append.
+ *
+ * @return
+ * True - Text appended.
+ * False - Memory allocation failed.
+ */
+static bool recommendationCacheAppend(RecommendationCacheEntry entry,
+                                      const char* text){
+    size_t text_length = strlen(text);
+    size_t needed = entry->length+text_length+1;
+    if(needed>entry->allocated){
+        size_t new_allocated = entry->allocated>0 ? entry->allocated :
+                               RECOMMENDATION_CACHE_INITIAL_TEXT;
+        while(new_allocated<needed){
+            new_allocated *= 2;
+        }
+        char* new_text = realloc(entry->text,new_allocated);
+        if(!new_text){
+            return false;
+        }
+        entry->text = new_text;
+        entry->allocated = new_allocated;
+    }
+    memcpy(entry->text+entry->length,text,text_length+1);
+    entry->length += text_length;
+    return true;
+}
@@ -0,0 +1,105 @@
+#ifndef MTM_EX3_MTMFLIX_RECOMMENDATION_CACHE_H
+#define MTM_EX3_MTMFLIX_RECOMMENDATION_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "series.h"
+
+//-----------------------------------------------------------------------//
+//              RECOMMENDATION CACHE: TYPEDEFS AND DEFINES               //
+//-----------------------------------------------------------------------//
+
+/**
+ * Recommendation cache: keeps the printed recommendations of users, so a
+ * request that is repeated while nothing it depends on changed is answered
+ * without ranking any series.
+ *
+ * An entry is kept for a (user id, count) pair, together with the version
+ * of the user's recommendations when it was made. A user changes his
+ * version whenever his recommendations may change, so an entry with an old
+ * version is never found.
+ *
+ * The cache has a fixed number of entries, and every pair has one entry it
+ * can be kept in. A new pair replaces the pair that was in its entry, so
+ * the cache never grows and finding a pair takes O(1).
+ */
+
+typedef struct recommendation_cache_t* RecommendationCache;
+
+typedef enum {
+    RECOMMENDATION_CACHE_SUCCESS,
+    RECOMMENDATION_CACHE_OUT_OF_MEMORY,
+    RECOMMENDATION_CACHE_NULL_ARGUMENT
+} RecommendationCacheResult;
+
+
+//-----------------------------------------------------------------------//
+//              RECOMMENDATION CACHE: FUNCTIONS DECLARATIONS             //
+//-----------------------------------------------------------------------//
+
+/**
+ ***** Function: recommendationCacheCreate *****
+ * Description: Creates a new empty recommendation cache.
+ *
+ * @param capacity - Number of entries of the cache.
+ *
+ * @return
+ * A new cache or NULL in case of memory error or capacity smaller than 1.
+ */
+RecommendationCache recommendationCacheCreate(int capacity);
+
+/**
+ ***** Function: recommendationCacheDestroy *****
+ * Description: Deallocates a recommendation cache.
+ *
+ * @param cache - Cache to destroy.
+ */
+void recommendationCacheDestroy(RecommendationCache cache);
+
+/**
+ ***** Function: recommendationCacheFind *****
+ * Description: Finds the printed recommendations of a user.
+ *
+ * @param cache - Cache to search in.
+ * @param user_id - Id of the user.
+ * @param count - The number of series the user asked for.
+ * @param version - The current version of the user's recommendations.
+ * @param text - Will point to the printed recommendations. The text
+ * belongs to the cache, it is valid until the cache is changed.
+ * @param length - Will hold the length of the text.
+ *
+ * @return
+ * True - The recommendations were found.
+ * False - They were not found, or were made in an older version.
+ */
+bool recommendationCacheFind(RecommendationCache cache,
+                             unsigned int user_id, int count,
+                             unsigned int version, const char** text,
+                             size_t* length);
+
+/**
+ ***** Function: recommendationCachePut *****
+ * Description: Keeps the recommendations of a user, as they are printed.
+ * Replaces the pair that was kept in the same entry.
+ *
+ * @param cache - Cache to put in.
+ * @param user_id - Id of the user.
+ * @param count - The number of series the user asked for.
+ * @param version - The current version of the user's recommendations.
+ * @param series - The recommended series, best first.
+ * @param series_num - Number of recommended series.
+ *
+ * @return
+ * RECOMMENDATION_CACHE_NULL_ARGUMENT - Cache or series is NULL.
+ * RECOMMENDATION_CACHE_OUT_OF_MEMORY - Any memory error. The entry is left
+ * empty.
+ * RECOMMENDATION_CACHE_SUCCESS - Recommendations kept.
+ */
+RecommendationCacheResult recommendationCachePut(RecommendationCache cache,
+                                                 unsigned int user_id,
+                                                 int count,
+                                                 unsigned int version,
+                                                 Series* series,
+                                                 int series_num);
+
+#endif //MTM_EX3_MTMFLIX_RECOMMENDATION_CACHE_H
@@ -0,0 +1,141 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "report_writer.h"
+
+//-----------------------------------------------------------------------//
+//                       REPORT WRITER: STRUCT                           //
+//-----------------------------------------------------------------------//
+
+struct report_writer_t{
+    char* buffer;
+    size_t size; // Number of bytes of the report in the buffer.
+    size_t capacity;
+    FILE* output_stream; // File of the current report.
+};
+
+
+//-----------------------------------------------------------------------//
+//                      REPORT WRITER: FUNCTIONS                         //
+//-----------------------------------------------------------------------//
+
+/** Rows: 17
+ ***** Function: reportWriterCreate *****
+ * Description: Creates a new report writer.
+ *
+ * @param buffer_size - Size in bytes of the buffer of the writer.
+ *
+ * @return
+ * A new report writer or NULL in case of memory error or size 0.
+ */
+ReportWriter reportWriterCreate(size_t buffer_size){
+    if(buffer_size==0){
+        return NULL;
+    }
+    ReportWriter writer = malloc(sizeof(*writer));
+    if(!writer){
+        return NULL;
+    }
+    writer->buffer = malloc(buffer_size);
+    if(!writer->buffer){
+        free(writer);
+        return NULL;
+    }
+    writer->size = 0;
+    writer->capacity = buffer_size;
+    writer->output_stream = NULL;
+    return writer;
+}
+
+/** Rows: 5
+ ***** Function: reportWriterDestroy *****
+ * Description: Deallocates a report writer. Lines that were not flushed
+ * are lost.
+ *
+ * @param writer - Report writer to destroy.
+ */
+void reportWriterDestroy(ReportWriter writer){
+    if(!writer){
+        return;
+    }
+    free(writer->buffer);
+    free(writer);
+}
+
+/** Rows: 3
+ ***** Function: reportWriterStart *****
+ * Description: Starts a new report to the given file. Lines that were not
+ * flushed from the previous report are dropped.
+ *
+ * @param writer - Report writer to write with.
+ * @param outputStream - File the report is written to.
+ */
+void reportWriterStart(ReportWriter writer, FILE* outputStream){
+    assert(writer && outputStream);
+    writer->size = 0;
+    writer->output_stream = outputStream;
+}
+
+/** Rows: 18
+ ***** Function: reportWriterWrite *****
+ * Description: Adds text to the report. The buffer is flushed first if the
+ * text does not fit in it, and text bigger than the buffer is written
+ * straight to the file.
+ *
+ * @param writer - Report writer of the report.
+ * @param text - Text to add. NULL is taken as the failed result of
+ * creating the text, so the caller does not have to check it.
+ *
+ * @return
+ * REPORT_WRITER_NULL_ARGUMENT - Writer or text is NULL.
+ * REPORT_WRITER_WRITE_FAILED - Failed to write to the file.
+ * REPORT_WRITER_SUCCESS - Text added.
+ */
+ReportWriterResult reportWriterWrite(ReportWriter writer, const char* text){
+    if(!writer || !text){
+        return REPORT_WRITER_NULL_ARGUMENT;
+    }
+    size_t length = strlen(text);
+    if(length>writer->capacity-writer->size &&
+       reportWriterFlush(writer)!=REPORT_WRITER_SUCCESS){
+        return REPORT_WRITER_WRITE_FAILED;
+    }
+    if(length>writer->capacity){
+        /* Copying it would only split it to more writes. */
+        if(fwrite(text,1,length,writer->output_stream)!=length){
+            return REPORT_WRITER_WRITE_FAILED;
+        }
+        return REPORT_WRITER_SUCCESS;
+    }
+    memcpy(writer->buffer+writer->size,text,length);
+    writer->size += length;
+    return REPORT_WRITER_SUCCESS;
+}
+
+/** Rows: 12
+ ***** Function: reportWriterFlush *****
+ * Description: Writes the buffered text of the report to its file. Should
+ * be called when the report is done, even if it failed, so the lines that
+ * were already added are not lost.
+ *
+ * @param writer - Report writer of the report.
+ *
+ * @return
+ * REPORT_WRITER_NULL_ARGUMENT - Writer is NULL.
+ * REPORT_WRITER_WRITE_FAILED - Failed to write to the file.
+ * REPORT_WRITER_SUCCESS - Buffer written.
+ */
+ReportWriterResult reportWriterFlush(ReportWriter writer){
+    if(!writer){
+        return REPORT_WRITER_NULL_ARGUMENT;
+    }
+    if(writer->size==0){
+        return REPORT_WRITER_SUCCESS;
+    }
+    size_t size = writer->size;
+    writer->size = 0;
+    if(fwrite(writer->buffer,1,size,writer->output_stream)!=size){
+        return REPORT_WRITER_WRITE_FAILED;
+    }
+    return REPORT_WRITER_SUCCESS;
+}
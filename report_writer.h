@@ -0,0 +1,92 @@
+#ifndef MTM_EX3_MTMFLIX_REPORT_WRITER_H
+#define MTM_EX3_MTMFLIX_REPORT_WRITER_H
+
+#include <stdio.h>
+
+//-----------------------------------------------------------------------//
+//                 REPORT WRITER: TYPEDEFS AND DEFINES                   //
+//-----------------------------------------------------------------------//
+
+/**
+ * Report writer: collects the lines of a report in one buffer, and writes
+ * them to the output file only when the buffer is full or the report is
+ * done. The buffer is allocated once and reused by every report, so
+ * printing a line only copies it.
+ */
+
+typedef struct report_writer_t* ReportWriter;
+
+typedef enum {
+    REPORT_WRITER_SUCCESS,
+    REPORT_WRITER_WRITE_FAILED,
+    REPORT_WRITER_NULL_ARGUMENT
+} ReportWriterResult;
+
+
+//-----------------------------------------------------------------------//
+//                REPORT WRITER: FUNCTIONS DECLARATIONS                  //
+//-----------------------------------------------------------------------//
+
+/**
+ ***** Function: reportWriterCreate *****
+ * Description: Creates a new report writer.
+ *
+ * @param buffer_size - Size in bytes of the buffer of the writer.
+ *
+ * @return
+ * A new report writer or NULL in case of memory error or size 0.
+ */
+ReportWriter reportWriterCreate(size_t buffer_size);
+
+/**
+ ***** Function: reportWriterDestroy *****
+ * Description: Deallocates a report writer. Lines that were not flushed
+ * are lost.
+ *
+ * @param writer - Report writer to destroy.
+ */
+void reportWriterDestroy(ReportWriter writer);
+
+/**
+ ***** Function: reportWriterStart *****
+ * Description: Starts a new report to the given file. Lines that were not
+ * flushed from the previous report are dropped.
+ *
+ * @param writer - Report writer to write with.
+ * @param outputStream - File the report is written to.
+ */
+void reportWriterStart(ReportWriter writer, FILE* outputStream);
+
+/**
+ ***** Function: reportWriterWrite *****
+ * Description: Adds text to the report. The buffer is flushed first if the
+ * text does not fit in it, and text bigger than the buffer is written
+ * straight to the file.
+ *
+ * @param writer - Report writer of the report.
+ * @param text - Text to add. NULL is taken as the failed result of
+ * creating the text, so the caller does not have to check it.
+ *
+ * @return
+ * REPORT_WRITER_NULL_ARGUMENT - Writer or text is NULL.
+ * REPORT_WRITER_WRITE_FAILED - Failed to write to the file.
+ * REPORT_WRITER_SUCCESS - Text added.
+ */
+ReportWriterResult reportWriterWrite(ReportWriter writer, const char* text);
+
+/**
+ ***** Function: reportWriterFlush *****
+ * Description: Writes the buffered text of the report to its file. Should
+ * be called when the report is done, even if it failed, so the lines that
+ * were already added are not lost.
+ *
+ * @param writer - Report writer of the report.
+ *
+ * @return
+ * REPORT_WRITER_NULL_ARGUMENT - Writer is NULL.
+ * REPORT_WRITER_WRITE_FAILED - Failed to write to the file.
+ * REPORT_WRITER_SUCCESS - Buffer written.
+ */
+ReportWriterResult reportWriterFlush(ReportWriter writer);
+
+#endif //MTM_EX3_MTMFLIX_REPORT_WRITER_H
@@ -6,19 +6,23 @@
 //                SERIES: STATIC FUNCTIONS DECLARATIONS                  //
 //-----------------------------------------------------------------------//
 
-static int* seriesInsertAgeLimit(int *ages, SeriesResult *status);
-static int getGenrePosition(Genre genre);
+static void seriesSetAgeLimit(Series series, int* ages);
 
 //-----------------------------------------------------------------------//
 //                            SERIES: STRUCT                             //
 //-----------------------------------------------------------------------//
 
 struct series_t{
+    Slab slab; // The slab the series was allocated from.
     char* series_name;
     int number_of_episodes;
     Genre genre;
-    int* ages;
+    bool has_age_limit;
+    int min_age; // MTM_MIN_AGE if there is no age limitation.
+    int max_age; // MTM_MAX_AGE if there is no age limitation.
     int episode_duration;
+    IdArray liked_by; // Ids of the users that have the series as favorite.
+    unsigned int id; // Unique in the mtmflix, never reused.
 };
 
 //-----------------------------------------------------------------------//
@@ -29,50 +33,48 @@ struct series_t{
  ***** Function: seriesCreate *****
  * Description: Creates a new series.
  *
- * @param series_name - Name of the series.
+ * @param slab - Slab of series to allocate the series from.
+ * @param series_name - Name of the series. Must be interned in the string
+ * pool of the mtmflix, the series takes its own reference to it.
  * @param number_of_episodes - Number of episodes of the series.
  * @param genre - Genre of the series.
  * @param ages - Array of age limitations. The size of the array is 2. The
  * First cell is the minimum age and the second cell is maximum age.
  * If ages is NULL there is no age limitaions.
  * @param episode_duration - Average duration of episode in series.
+ * @param id - Id of the series. Must be unique in the mtmflix.
  *
  * @return - New series or NULL in case of fail.
  */
-Series seriesCreate(char* series_name, int number_of_episodes,
-                    Genre genre, int* ages, int episode_duration){
+Series seriesCreate(Slab slab, char* series_name, int number_of_episodes,
+                    Genre genre, int* ages, int episode_duration,
+                    unsigned int id){
 
-    Series series = malloc(sizeof(*series));
+    Series series = slabAlloc(slab);
     if(!series){
         /* Series memory allocation failed. */
         return NULL;
     }
-    char* name = malloc(strlen(series_name)+1);
-    if(!name){
-        /* Name memory allocation failed. */
-        free(series);
-        return NULL;
-    }
-    strcpy(name,series_name);
-    SeriesResult status;
-    int* series_age_limit = seriesInsertAgeLimit(ages, &status);
-    if(status != SERIES_SUCCESS){
-        /* Couldn't allocate memory for ages array of series. */
-        free(name);
-        free(series);
+    IdArray liked_by = idArrayCreate();
+    if(!liked_by){
+        /* Liked-by array creation failed. */
+        slabFree(slab,series);
         return NULL;
     }
-    series->ages = series_age_limit;
-    series->series_name = name;
+    series->slab = slab;
+    series->liked_by = liked_by;
+    series->id = id;
+    seriesSetAgeLimit(series,ages);
+    series->series_name = stringPoolRetain(series_name);
     series->genre = genre;
     series->episode_duration = episode_duration;
     series->number_of_episodes = number_of_episodes;
     return series;
 }
 
-/** Rows: 8
+/** Rows: 18
  ***** Function: seriesCopy *****
- * Description: Creates a copy of the given series.
+ * Description: Creates a copy of the given series from the same slab.
  *
  * @param series - A series to create a copy of.
  * @return - A copy of the given series or NULL in case of failure.
@@ -82,25 +84,37 @@ Series seriesCopy(Series series){
         /* NULL argument.*/
         return NULL;
     }
-    Series series_copy = seriesCreate(series->series_name,
-               series->number_of_episodes,series->genre,series->ages,
-                                                 series->episode_duration);
+    Series series_copy = seriesCreate(series->slab,series->series_name,
+               series->number_of_episodes,series->genre,NULL,
+                                    series->episode_duration,series->id);
 
     if(!series_copy){
         /* Series create failed. */
         return NULL;
     }
+    IdArray liked_by = idArrayCopy(series->liked_by);
+    if(!liked_by){
+        /* Liked-by array copy failed. */
+        seriesDestroy(series_copy);
+        return NULL;
+    }
+    idArrayDestroy(series_copy->liked_by);
+    series_copy->liked_by = liked_by;
+    series_copy->has_age_limit = series->has_age_limit;
+    series_copy->min_age = series->min_age;
+    series_copy->max_age = series->max_age;
     return series_copy;
 }
 
-/** Rows: 7
+/** Rows: 5
  ***** Function: seriesCopyName *****
- * Description: Creates a copy of the given series name.
+ * Description: Copies an interned series name. The name is not duplicated,
+ * only another reference to it is taken.
  *
- * @param name - Name we want to copy.
+ * @param name - Interned name we want to copy.
  *
  * @return
- * If success - A copy of the given name.
+ * If success - The same interned name.
  * Else - NULL.
  */
 char* seriesCopyName(char *name){
@@ -108,13 +122,7 @@ char* seriesCopyName(char *name){
         /* NULL argument. */
         return NULL;
     }
-    char* name_copy = malloc(strlen(name)+1);
-    if(!name_copy){
-        /* Name copy memory allocation failed. */
-        return NULL;
-    }
-    strcpy(name_copy,name);
-    return name_copy;
+    return stringPoolRetain(name);
 }
 
 /** Rows: 5
@@ -127,12 +135,12 @@ void seriesDestroy(Series series){
     if(!series){
         return;
     }
-    free(series->series_name);
-    free(series->ages);
-    free(series);
+    stringPoolRelease(series->series_name);
+    idArrayDestroy(series->liked_by);
+    slabFree(series->slab,series);
 }
 
-/** Rows: 9
+/** Rows: 10
  ***** Function: seriesCompare *****
  * Description: Compare between two series.
  *
@@ -145,14 +153,15 @@ void seriesDestroy(Series series){
  * Zero - Series are equal.
  */
 int seriesCompare(Series series1, Series series2){
-    if(!strcmp(series1->series_name,series2->series_name)){
+    assert(series1 && series2);
+    if(series1->series_name==series2->series_name){
         /* Series has the same name. This is in order to check if a series
-         * exist in a set using its name only. */
+         * exist in a set using its name only. Names are interned, so equal
+         * names are the same pointer. */
         return 0;
     }
-    assert(series1 && series2);
-    int genre1_position = getGenrePosition(series1->genre);
-    int genre2_position = getGenrePosition(series2->genre);
+    int genre1_position = seriesGetGenrePosition(series1->genre);
+    int genre2_position = seriesGetGenrePosition(series2->genre);
     int genre_diff = genre1_position-genre2_position;
     if(genre_diff){
         /* The series has different genres. */
@@ -164,15 +173,15 @@ int seriesCompare(Series series1, Series series2){
 
 /** Rows: 1
  ***** Function: seriesDestroyName *****
- * Description: Free all allocated memory for the name of a series.
+ * Description: Releases a reference to an interned series name.
  *
  * @param name - Name we want to destroy.
  */
 void seriesDestroyName(char* name){
-    free(name);
+    stringPoolRelease(name);
 }
 
-/** Rows: 3
+/** Rows: 2
  ***** Function: seriesHasAgeRestrictions *****
  * Description: Returns whether or not a series has age restrictions.
  *
@@ -183,10 +192,8 @@ void seriesDestroyName(char* name){
  * False - Doesn't have age restrictions.
  */
 bool seriesHasAgeRestrictions(Series series){
-    if(!series->ages){
-        return false;
-    }
-    return true;
+    assert(series);
+    return series->has_age_limit;
 }
 
 /** Rows: 1
@@ -200,8 +207,7 @@ bool seriesHasAgeRestrictions(Series series){
  */
 int seriesGetMaxAge(Series series){
     assert(series);
-    assert(series->ages);
-    return series->ages[1];
+    return series->max_age;
 }
 
 /** Rows: 1
@@ -215,8 +221,24 @@ int seriesGetMaxAge(Series series){
  */
 int seriesGetMinAge(Series series){
     assert(series);
-    assert(series->ages);
-    return series->ages[0];
+    return series->min_age;
+}
+
+/** Rows: 2
+ ***** Function: seriesAllowsAge *****
+ * Description: Returns whether a user of the given age may watch a
+ * series. Takes two comparisons, also for series without age limitations.
+ *
+ * @param series - Series to check.
+ * @param age - Age of the user.
+ *
+ * @return
+ * True - The age is in the age limitations of the series (or it has none).
+ * False - The age is not allowed.
+ */
+bool seriesAllowsAge(Series series, int age){
+    assert(series);
+    return series->min_age<=age && age<=series->max_age;
 }
 
 
@@ -234,6 +256,20 @@ int seriesGetEpisodeDuration (Series series){
     return series->episode_duration;
 }
 
+/** Rows: 2
+ ***** Function: seriesGetEpisodesNum *****
+ * Description: returns the number of episodes of a given series.
+ *
+ * @param series - Series we want to get its number of episodes.
+ *
+ * @return
+ * Number of episodes of given series.
+ */
+int seriesGetEpisodesNum (Series series){
+    assert(series);
+    return series->number_of_episodes;
+}
+
 /** Rows: 2
  ***** Function: seriesGetGenre *****
  * Description: returns the genre of a given series.
@@ -248,197 +284,151 @@ Genre seriesGetGenre (Series series){
     return series->genre;
 }
 
-/** Rows: 11
- ***** Function: printSeriesDetailsToFile *****
- * Description: Prints a series name and genre to a file.
+/** Rows: 3
+ ***** Function: seriesGetDetails *****
+ * Description: Returns the name and genre of a series, as they are
+ * printed in reports and recommendations.
  *
- * @param series - Series we want to print to the given file.
- * @param outputStream - The file we want to print into.
+ * Notice: The string belongs to the mtm library, it is only valid until
+ * the details of another series are taken.
+ *
+ * @param series - Series to get its details.
  *
  * @return
- * SERIES_MEMORY_ALLOCATION_FAILED - Any memory error.
- * SERIES_SUCCESS - Successfully printed.
+ * The details of the series or NULL in case of memory error.
  */
-SeriesResult printSeriesDetailsToFile(Series series,
-                                      FILE* outputStream){
-    char* series_genre_string = getGenreNameByEnum(series->genre);
-    if(!series_genre_string){
-        /* Failed to get genre. */
-        return SERIES_MEMORY_ALLOCATION_FAILED;
-    }
-    const char* series_details = mtmPrintSeries(series->series_name,
-                                                series_genre_string);
-    free(series_genre_string);
-    if(!series_details){
-        return SERIES_MEMORY_ALLOCATION_FAILED;
-    }
-    if(fprintf(outputStream,"%s",series_details)<0){
-        return SERIES_MEMORY_ALLOCATION_FAILED;
-    }
-    return SERIES_SUCCESS;
+const char* seriesGetDetails(Series series){
+    assert(series);
+    return mtmPrintSeries(series->series_name,
+                          seriesGetGenreName(series->genre));
 }
 
-/** Rows: 5
+/** Rows: 2
  ***** Function: seriesGetName *****
- * Description: Returns the name of a given series.
+ * Description: Returns the name of a given series. The name is not copied,
+ * it belongs to the series and should not be freed. The name is interned,
+ * so it is equal to another interned name only if it is the same pointer.
  * @param series - Series we want to get its name.
  * @return
- * If success - Name of given series.
- * Else - NULL.
+ * Name of given series.
  */
-char* seriesGetName (Series series){
-    char* series_name_copy=malloc(strlen(series->series_name)+1);
-    if(!series_name_copy){
-        return NULL;
-    }
-    strcpy(series_name_copy,series->series_name);
-    return series_name_copy;
+const char* seriesGetName (Series series){
+    assert(series);
+    return series->series_name;
 }
 
-/** Rows: 6
- ***** Function: getGenreNameByEnum *****
+/** Rows: 5
+ ***** Function: seriesGetGenreName *****
  * Description: Converts genre to the string that represents the genre.
+ * The names are constant, so nothing is allocated.
  *
  * @param genre - A number that represents a genre.
  * @return
- * NULL in case of memory allocation error, else the string represents the
- * number of genre.
+ * The string represents the number of genre. Should not be freed.
  */
-char* getGenreNameByEnum(Genre genre){
-    const char* genres[] = { "SCIENCE_FICTION", "DRAMA", "COMEDY", "CRIME",
-                             "MYSTERY","DOCUMENTARY", "ROMANCE", "HORROR"};
-    char* genre_string = malloc(strlen(genres[genre])+1);
-    if(!genre_string){
-        return NULL;
-    }
-    strcpy(genre_string,genres[genre]);
-    return genre_string;
+const char* seriesGetGenreName(Genre genre){
+    static const char* const genres[NUMBER_OF_GENRES] = {
+            "SCIENCE_FICTION", "DRAMA", "COMEDY", "CRIME", "MYSTERY",
+            "DOCUMENTARY", "ROMANCE", "HORROR"};
+    assert(genre>=0 && genre<NUMBER_OF_GENRES);
+    return genres[genre];
 }
 
-/** Rows: 12
- ***** Function: seriesGetGenreByName *****
- * Description: Gets a series name, a set of all the series in the mtmflix
- * and a status. The function returns the genre of the series with that
- * name.
+/** Rows: 3
+ ***** Function: seriesFindByName *****
+ * Description: Returns the series with the given name. The lookup does
+ * not allocate memory.
+ *
+ * @param series_index - Index of all the series in the system.
+ * @param series_name - Name of the series we look for.
  *
- * @param series_name - The name of the series we want its genre.
- * @param series_set - Set of all the series in the system.
- * @param status - A status that will be updated at the end of the
- * function indicates if there was a problem.
  * @return
- * Genre of the series with the given name.
+ * The series with the given name or NULL if it doesn't exist.
  */
-Genre seriesGetGenreByName(char* series_name, Set series_set,
-                           SeriesResult* status){
+Series seriesFindByName(NameIndex series_index, const char* series_name){
+    assert(series_index);
     assert(series_name);
-    assert(series_set);
-    Series dummy_series = seriesCreate(series_name,1,HORROR,NULL,4);
-    if(!dummy_series){
-        *status = SERIES_MEMORY_ALLOCATION_FAILED;
-        return HORROR; // This value won't be checked.
-    }
-    SET_FOREACH(SetElement,current_series,series_set){
-        if(seriesCompare(current_series,dummy_series)==0){
-            /* We found the series with the given name. */
-            seriesDestroy(dummy_series);
-            *status = SERIES_SUCCESS;
-            return ((Series)current_series)->genre;
-        }
+    return nameIndexFind(series_index,series_name);
+}
+
+/** Rows: 7
+ ***** Function: seriesAddLikedBy *****
+ * Description: Marks that the user with the given id has the series in
+ * his favorite series list.
+ *
+ * @param series - Series the user likes.
+ * @param user_id - Id of the user.
+ *
+ * @return
+ * SERIES_MEMORY_ALLOCATION_FAILED - Any memory error.
+ * SERIES_SUCCESS - User id added (or already was there).
+ */
+SeriesResult seriesAddLikedBy(Series series, unsigned int user_id){
+    assert(series);
+    if(idArrayInsert(series->liked_by,user_id)==ID_ARRAY_OUT_OF_MEMORY){
+        /* Failed to grow the liked-by array. */
+        return SERIES_MEMORY_ALLOCATION_FAILED;
     }
-    /* We shouldn't get here. */
-    seriesDestroy(dummy_series);
-    *status = SERIES_MEMORY_ALLOCATION_FAILED; // Series doesn't exist.
-    return HORROR;
+    return SERIES_SUCCESS;
+}
 
+/** Rows: 2
+ ***** Function: seriesRemoveLikedBy *****
+ * Description: Marks that the user with the given id no longer has the
+ * series in his favorite series list.
+ *
+ * @param series - Series the user stopped liking.
+ * @param user_id - Id of the user.
+ */
+void seriesRemoveLikedBy(Series series, unsigned int user_id){
+    assert(series);
+    idArrayRemove(series->liked_by,user_id);
 }
 
-/** Rows: 12
- ***** Function: seriesGetDurationByName *****
- * Description: Gets series name, a status and a set of all the series in
- * the system and returns the episode duration of the given series.
+/** Rows: 2
+ ***** Function: seriesGetId *****
+ * Description: Returns the id of a given series.
+ *
+ * @param series - Series to get its id.
  *
- * @param series_name - The series we want to get its episode duration.
- * @param series_set - Set of all the series in the system.
- * @param status - Will hold information of success/failure of the
- * function.
  * @return
- * If succeeded - The episode duration of the series with the given series
- * name.
- * If fails - Returns ILLEGAL_VALUE.
+ * Id of given series.
  */
-int seriesGetDurationByName(char *series_name, Set series_set,
-                            SeriesResult *status){
-    Series dummy_series = seriesCreate(series_name,1,HORROR,NULL,2);
-    if(!dummy_series){
-        /* Memory allocation failed. */
-        *status = SERIES_MEMORY_ALLOCATION_FAILED;
-        return ILLEGAL_VALUE; // This value won't be checked.
-    }
-    SET_FOREACH(SetElement,current_series,series_set){
-        if(seriesCompare(current_series,dummy_series)==0){
-            /* We fount the series with the given name. */
-            *status = SERIES_SUCCESS;
-            seriesDestroy(dummy_series);
-            return ((Series)current_series)->episode_duration;
-        }
-    }
-    /*  Shouldn't get here. */
-    seriesDestroy(dummy_series);
-    *status = SERIES_MEMORY_ALLOCATION_FAILED; // Series doesn't exist.
-    return ILLEGAL_VALUE; // This value won't be checked.
+unsigned int seriesGetId(Series series){
+    assert(series);
+    return series->id;
 }
 
-//-----------------------------------------------------------------------//
-//                      SERIES: STATIC FUNCTIONS                         //
-//-----------------------------------------------------------------------//
+/** Rows: 1
+ ***** Function: seriesGetAllocationSize *****
+ * Description: Returns the size of the memory of a series. Used to create
+ * the slab the series are allocated from.
+ *
+ * @return
+ * Size in bytes of a series.
+ */
+size_t seriesGetAllocationSize(){
+    return sizeof(struct series_t);
+}
 
-/** Rows: 16
- ***** Static function: seriesSetAgeLimit *****
- * Description: This function will be used at seriesCreate.
- * The function gets an array of ages or NULL. If NULL, there are no age
- * limitations. Else, the first cell will contain minimum age limit and the
- * second cell will contain maximum age limit. In case not NULL, the
- * function will duplicate the array with a slight change: If the maximum
- * age in the array is higher than MtmFlix maximum age then the new array
- * will contain MtmFlix maximum age. If the minimum age in the array is
- * lower than MtmFlix minimum age then the new array will contain MtmFlix
- * minimum age.
+/** Rows: 2
+ ***** Function: seriesGetLikedBy *****
+ * Description: Returns the ids of the users that have the series in their
+ * favorite series list. The array belongs to the series and should not be
+ * changed or freed.
+ *
+ * @param series - Series we want to get its liked-by ids.
  *
- * @param ages - Array of age limitations. If NULL there are no limitaions.
  * @return
- * Array of final age restrictions.
+ * Sorted array of user ids.
  */
-static int* seriesInsertAgeLimit(int* ages, SeriesResult *status) {
-    if (ages) {
-        /* There is an age limitations */
-        int *series_ages = malloc(sizeof(ages));
-        if (!series_ages) {
-            /* Ages array memory allocation failed. */
-            *status = SERIES_MEMORY_ALLOCATION_FAILED;
-            return NULL;
-        }
-        if (ages[0] < MTM_MIN_AGE) {
-            /* Minimum age of series is lower then MtmFlix minimum age. */
-            series_ages[0] = MTM_MIN_AGE;
-        } else {
-            series_ages[0] = ages[0];
-        }
-        if (ages[1] > MTM_MAX_AGE) {
-            /* Maximum age of series is higher then MtmFlix maximum age. */
-            series_ages[1] = MTM_MAX_AGE;
-        } else {
-            series_ages[1] = ages[1];
-        }
-        *status = SERIES_SUCCESS;
-        return series_ages;
-    }
-    /* There is no age limitation. */
-    *status = SERIES_SUCCESS;
-    return NULL;
+IdArray seriesGetLikedBy(Series series){
+    assert(series);
+    return series->liked_by;
 }
 
 /** Rows: 2
- ***** Static function: getGenrePosition *****
+ ***** Function: seriesGetGenrePosition *****
  * Description: Gets a genre and returns its lexicographical position.
  * ascii value.
  *
@@ -457,8 +447,43 @@ static int* seriesInsertAgeLimit(int* ages, SeriesResult *status) {
  * @return
  * Integer indicates the position of the genre.
  */
-static int getGenrePosition(Genre genre){
+int seriesGetGenrePosition(Genre genre){
     int genres_position[NUMBER_OF_GENRES] = {7,3,0,1,5,2,6,4};
     return genres_position[genre];
 }
 
+//-----------------------------------------------------------------------//
+//                      SERIES: STATIC FUNCTIONS                         //
+//-----------------------------------------------------------------------//
+
+/** Rows: 17
+ ***** Static function: seriesSetAgeLimit *****
+ * Description: This function will be used at seriesCreate.
+ * The function gets an array of ages or NULL. If NULL, there are no age
+ * limitations. Else, the first cell will contain minimum age limit and the
+ * second cell will contain maximum age limit. The limits are kept in the
+ * series with a slight change: If the maximum age in the array is higher
+ * than MtmFlix maximum age then MtmFlix maximum age is kept. If the minimum
+ * age in the array is lower than MtmFlix minimum age then MtmFlix minimum
+ * age is kept. A series without limitations keeps the MtmFlix ages, so
+ * checking an age never needs to know if there are limitations.
+ *
+ * @param series - Series to set its age limitations.
+ * @param ages - Array of age limitations. If NULL there are no limitaions.
+ */
+static void seriesSetAgeLimit(Series series, int* ages) {
+    series->has_age_limit = ages!=NULL;
+    series->min_age = MTM_MIN_AGE;
+    series->max_age = MTM_MAX_AGE;
+    if (!ages) {
+        /* There is no age limitation. */
+        return;
+    }
+    if (ages[0] > MTM_MIN_AGE) {
+        series->min_age = ages[0];
+    }
+    if (ages[1] < MTM_MAX_AGE) {
+        series->max_age = ages[1];
+    }
+}
+
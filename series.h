@@ -6,6 +6,10 @@
 #include <malloc.h>
 #include <string.h>
 #include "set.h"
+#include "name_index.h"
+#include "id_array.h"
+#include "string_pool.h"
+#include "slab.h"
 #include "mtm_ex3.h"
 #include <assert.h>
 
@@ -31,7 +35,7 @@ typedef enum SeriesResult_t {
 
 /**
  ***** Function: seriesCopy *****
- * Description: Creates a copy of the given series.
+ * Description: Creates a copy of the given series from the same slab.
  *
  * @param series - A series to create a copy of.
  * @return - A copy of the given series or NULL in case of failure.
@@ -40,12 +44,13 @@ Series seriesCopy(Series series);
 
 /**
  ***** Function: seriesCopyName *****
- * Description: Creates a copy of the given series name.
+ * Description: Copies an interned series name. The name is not duplicated,
+ * only another reference to it is taken.
  *
- * @param name - Name we want to copy.
+ * @param name - Interned name we want to copy.
  *
  * @return
- * If success - A copy of the given name.
+ * If success - The same interned name.
  * Else - NULL.
  */
 char* seriesCopyName(char *name);
@@ -76,22 +81,26 @@ int seriesCompare(Series series1, Series series2);
  ***** Function: seriesCreate *****
  * Description: Creates a new series.
  *
- * @param series_name - Name of the series.
+ * @param slab - Slab of series to allocate the series from.
+ * @param series_name - Name of the series. Must be interned in the string
+ * pool of the mtmflix, the series takes its own reference to it.
  * @param number_of_episodes - Number of episodes of the series.
  * @param genre - Genre of the series.
  * @param ages - Array of age limitations. The size of the array is 2. The
  * First cell is the minimum age and the second cell is maximum age.
  * If ages is NULL there is no age limitaions.
  * @param episode_duration - Average duration of episode in series.
+ * @param id - Id of the series. Must be unique in the mtmflix.
  *
  * @return - New series or NULL in case of fail.
  */
-Series seriesCreate(char* series_name, int number_of_episodes,
-                    Genre genre, int* ages, int episode_duration);
+Series seriesCreate(Slab slab, char* series_name, int number_of_episodes,
+                    Genre genre, int* ages, int episode_duration,
+                    unsigned int id);
 
 /**
  ***** Function: seriesDestroyName *****
- * Description: Free all allocated memory for the name of a series.
+ * Description: Releases a reference to an interned series name.
  *
  * @param name - Name we want to destroy.
  */
@@ -109,29 +118,43 @@ void seriesDestroyName(char* name);
 Genre seriesGetGenre (Series series);
 
 /**
- ***** Function: printSeriesDetailsToFile *****
- * Description: Prints a series name and genre to a file.
+ ***** Function: seriesGetGenrePosition *****
+ * Description: Gets a genre and returns its lexicographical position.
+ * Series are ordered by the position of their genre first.
  *
- * @param series - Series we want to print to the given file.
- * @param outputStream - The file we want to print into.
+ * @param genre - The genre we want to get its position.
  *
  * @return
- * SERIES_MEMORY_ALLOCATION_FAILED - Any memory error.
- * SERIES_SUCCESS - Successfully printed.
+ * Integer indicates the position of the genre, from 0 to
+ * NUMBER_OF_GENRES-1.
  */
-SeriesResult printSeriesDetailsToFile(Series series,
-                                      FILE* outputStream);
+int seriesGetGenrePosition(Genre genre);
 
 /**
- ***** Function: getGenreNameByEnum *****
+ ***** Function: seriesGetDetails *****
+ * Description: Returns the name and genre of a series, as they are
+ * printed in reports and recommendations.
+ *
+ * Notice: The string belongs to the mtm library, it is only valid until
+ * the details of another series are taken.
+ *
+ * @param series - Series to get its details.
+ *
+ * @return
+ * The details of the series or NULL in case of memory error.
+ */
+const char* seriesGetDetails(Series series);
+
+/**
+ ***** Function: seriesGetGenreName *****
  * Description: Converts genre to the string that represents the genre.
+ * The names are constant, so nothing is allocated.
  *
  * @param genre - A number that represents a genre.
  * @return
- * NULL in case of memory allocation error, else the string represents the
- * number of genre.
+ * The string represents the number of genre. Should not be freed.
  */
-char* getGenreNameByEnum(Genre genre);
+const char* seriesGetGenreName(Genre genre);
 
 /**
  ***** Function: seriesHasAgeRestrictions *****
@@ -168,47 +191,42 @@ int seriesGetMaxAge(Series series);
 int seriesGetMinAge(Series series);
 
 /**
- ***** Function: seriesGetName *****
- * Description: Returns the name of a given series.
- * @param series - Series we want to get its name.
+ ***** Function: seriesAllowsAge *****
+ * Description: Returns whether a user of the given age may watch a
+ * series. Takes two comparisons, also for series without age limitations.
+ *
+ * @param series - Series to check.
+ * @param age - Age of the user.
+ *
  * @return
- * If success - Name of given series.
- * Else - NULL.
+ * True - The age is in the age limitations of the series (or it has none).
+ * False - The age is not allowed.
  */
-char* seriesGetName (Series series);
+bool seriesAllowsAge(Series series, int age);
 
 /**
- ***** Function: seriesGetGenreByName *****
- * Description: Gets a series name, a set of all the series in the mtmflix
- * and a status. The function returns the genre of the series with that
- * name.
- *
- * @param series_name - The name of the series we want its genre.
- * @param series_set - Set of all the series in the system.
- * @param status - A status that will be updated at the end of the
- * function indicates if there was a problem.
+ ***** Function: seriesGetName *****
+ * Description: Returns the name of a given series. The name is not copied,
+ * it belongs to the series and should not be freed. The name is interned,
+ * so it is equal to another interned name only if it is the same pointer.
+ * @param series - Series we want to get its name.
  * @return
- * Genre of the series with the given name.
+ * Name of given series.
  */
-Genre seriesGetGenreByName(char* series_name, Set series_set,
-                           SeriesResult* status);
+const char* seriesGetName (Series series);
 
 /**
- ***** Function: seriesGetDurationByName *****
- * Description: Gets series name, a status and a set of all the series in
- * the system and returns the episode duration of the given series.
+ ***** Function: seriesFindByName *****
+ * Description: Returns the series with the given name. The lookup does
+ * not allocate memory.
+ *
+ * @param series_index - Index of all the series in the system.
+ * @param series_name - Name of the series we look for.
  *
- * @param series_name - The series we want to get its episode duration.
- * @param series_set - Set of all the series in the system.
- * @param status - Will hold information of success/failure of the
- * function.
  * @return
- * If succeeded - The episode duration of the series with the given series
- * name.
- * If fails - Returns ILLEGAL_VALUE.
+ * The series with the given name or NULL if it doesn't exist.
  */
-int seriesGetDurationByName(char *series_name, Set series_set,
-                            SeriesResult *status);
+Series seriesFindByName(NameIndex series_index, const char* series_name);
 
 /**
  ***** Function: seriesGetEpisodeDuration *****
@@ -221,5 +239,74 @@ int seriesGetDurationByName(char *series_name, Set series_set,
  */
 int seriesGetEpisodeDuration (Series series);
 
+/**
+ ***** Function: seriesGetEpisodesNum *****
+ * Description: returns the number of episodes of a given series.
+ *
+ * @param series - Series we want to get its number of episodes.
+ *
+ * @return
+ * Number of episodes of given series.
+ */
+int seriesGetEpisodesNum (Series series);
+
+/**
+ ***** Function: seriesAddLikedBy *****
+ * Description: Marks that the user with the given id has the series in
+ * his favorite series list.
+ *
+ * @param series - Series the user likes.
+ * @param user_id - Id of the user.
+ *
+ * @return
+ * SERIES_MEMORY_ALLOCATION_FAILED - Any memory error.
+ * SERIES_SUCCESS - User id added (or already was there).
+ */
+SeriesResult seriesAddLikedBy(Series series, unsigned int user_id);
+
+/**
+ ***** Function: seriesRemoveLikedBy *****
+ * Description: Marks that the user with the given id no longer has the
+ * series in his favorite series list.
+ *
+ * @param series - Series the user stopped liking.
+ * @param user_id - Id of the user.
+ */
+void seriesRemoveLikedBy(Series series, unsigned int user_id);
+
+/**
+ ***** Function: seriesGetId *****
+ * Description: Returns the id of a given series.
+ *
+ * @param series - Series to get its id.
+ *
+ * @return
+ * Id of given series.
+ */
+unsigned int seriesGetId(Series series);
+
+/**
+ ***** Function: seriesGetAllocationSize *****
+ * Description: Returns the size of the memory of a series. Used to create
+ * the slab the series are allocated from.
+ *
+ * @return
+ * Size in bytes of a series.
+ */
+size_t seriesGetAllocationSize();
+
+/**
+ ***** Function: seriesGetLikedBy *****
+ * Description: Returns the ids of the users that have the series in their
+ * favorite series list. The array belongs to the series and should not be
+ * changed or freed.
+ *
+ * @param series - Series we want to get its liked-by ids.
+ *
+ * @return
+ * Sorted array of user ids.
+ */
+IdArray seriesGetLikedBy(Series series);
+
 #endif //MTM_EX3_MTMFLIX_SERIES_H
 
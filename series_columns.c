@@ -0,0 +1,429 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <limits.h>
+#include "series_columns.h"
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define SERIES_COLUMNS_INITIAL_CAPACITY 16
+
+//-----------------------------------------------------------------------//
+//             SERIES COLUMNS: STATIC FUNCTIONS DECLARATIONS             //
+//-----------------------------------------------------------------------//
+
+static SeriesColumnsResult seriesColumnsGrow(SeriesColumns columns,
+                                             unsigned int id);
+
+static bool seriesColumnsGrowColumn(int** column, unsigned int capacity);
+
+static void seriesColumnsRankRange(SeriesColumns columns,
+                                   const unsigned int* ids, int* ranks,
+                                   int start, int end,
+                                   const int* genre_counts,
+                                   double average_duration, int age);
+
+#ifdef __AVX2__
+static int seriesColumnsRankAvx2(SeriesColumns columns,
+                                 const unsigned int* ids, int* ranks,
+                                 int series_num, const int* genre_counts,
+                                 double average_duration, int age);
+
+static __m128i seriesColumnsDivideAvx2(__m128i counts, __m128i friends,
+                                       __m128i durations,
+                                       __m256d average_duration);
+#elif defined(__SSE2__)
+static int seriesColumnsRankSse2(SeriesColumns columns,
+                                 const unsigned int* ids, int* ranks,
+                                 int series_num, const int* genre_counts,
+                                 double average_duration, int age);
+
+static __m128i seriesColumnsDivideSse2(__m128i counts, __m128i friends,
+                                       __m128i durations,
+                                       __m128d average_duration);
+#endif
+
+//-----------------------------------------------------------------------//
+//                       SERIES COLUMNS: STRUCT                          //
+//-----------------------------------------------------------------------//
+
+struct series_columns_t{
+    int* genres;
+    int* durations; // Episode durations.
+    int* min_ages; // MTM_MIN_AGE if there is no age limitation.
+    int* max_ages; // MTM_MAX_AGE if there is no age limitation.
+    unsigned int capacity; // Number of ids the columns have room for.
+};
+
+
+//-----------------------------------------------------------------------//
+//                      SERIES COLUMNS: FUNCTIONS                        //
+//-----------------------------------------------------------------------//
+
+/** Rows: 18
+ ***** Function: seriesColumnsCreate *****
+ * Description: Creates new empty series columns.
+ *
+ * @return
+ * New series columns or NULL in case of memory error.
+ */
+SeriesColumns seriesColumnsCreate(){
+    SeriesColumns columns = malloc(sizeof(*columns));
+    if(!columns){
+        return NULL;
+    }
+    size_t size = SERIES_COLUMNS_INITIAL_CAPACITY*sizeof(int);
+    columns->genres = malloc(size);
+    columns->durations = malloc(size);
+    columns->min_ages = malloc(size);
+    columns->max_ages = malloc(size);
+    columns->capacity = SERIES_COLUMNS_INITIAL_CAPACITY;
+    if(!columns->genres || !columns->durations || !columns->min_ages ||
+       !columns->max_ages){
+        seriesColumnsDestroy(columns);
+        return NULL;
+    }
+    return columns;
+}
+
+/** Rows: 9
+ ***** Function: seriesColumnsDestroy *****
+ * Description: Deallocates series columns.
+ *
+ * @param columns - Series columns to destroy.
+ */
+void seriesColumnsDestroy(SeriesColumns columns){
+    if(!columns){
+        return;
+    }
+    free(columns->genres);
+    free(columns->durations);
+    free(columns->min_ages);
+    free(columns->max_ages);
+    free(columns);
+}
+
+/** Rows: 15
+ ***** Function: seriesColumnsPut *****
+ * Description: Copies the genre, episode duration and age limitations of
+ * a series to the columns of its id.
+ *
+ * @param columns - Series columns to put in.
+ * @param series - Series to put.
+ *
+ * @return
+ * SERIES_COLUMNS_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * SERIES_COLUMNS_OUT_OF_MEMORY - Failed to grow the columns.
+ * SERIES_COLUMNS_SUCCESS - Series put.
+ */
+SeriesColumnsResult seriesColumnsPut(SeriesColumns columns, Series series){
+    if(!columns || !series){
+        return SERIES_COLUMNS_NULL_ARGUMENT;
+    }
+    unsigned int id = seriesGetId(series);
+    if(id>=columns->capacity &&
+       seriesColumnsGrow(columns,id)!=SERIES_COLUMNS_SUCCESS){
+        return SERIES_COLUMNS_OUT_OF_MEMORY;
+    }
+    columns->genres[id] = seriesGetGenre(series);
+    columns->durations[id] = seriesGetEpisodeDuration(series);
+    columns->min_ages[id] = seriesGetMinAge(series);
+    columns->max_ages[id] = seriesGetMaxAge(series);
+    return SERIES_COLUMNS_SUCCESS;
+}
+
+/** Rows: 14
+ ***** Function: seriesColumnsRank *****
+ * Description: Ranks many series for one user, with the rank
+ * G*F/(1+|CUR-L|). A series the user is not allowed to watch gets rank 0.
+ * With AVX2 the series are ranked 8 at a time and their columns are
+ * gathered by their ids, with SSE2 they are ranked 4 at a time. The rest
+ * of the series, or all of them without these instructions, are ranked
+ * one at a time. Every way multiplies G by F in doubles, so it does not
+ * overflow, and caps the rank at INT_MAX before it is truncated. So every
+ * way gives exactly the same ranks, whatever G and F are.
+ *
+ * @param columns - Columns of the series.
+ * @param ids - Ids of the series to rank. Their columns must be valid.
+ * @param ranks - For every series, F (how many friends loved it) when
+ * called. Holds the rank of every series on return.
+ * @param series_num - Number of series to rank.
+ * @param genre_counts - G of every genre: how many series of the genre the
+ * user loves. Indexed by the genre.
+ * @param average_duration - L: average episode duration of the series
+ * the user loves.
+ * @param age - Age of the user.
+ */
+void seriesColumnsRank(SeriesColumns columns, const unsigned int* ids,
+                       int* ranks, int series_num, const int* genre_counts,
+                       double average_duration, int age){
+    assert(columns && (series_num==0 || (ids && ranks && genre_counts)));
+    int ranked = 0;
+#ifdef __AVX2__
+    ranked = seriesColumnsRankAvx2(columns,ids,ranks,series_num,
+                                   genre_counts,average_duration,age);
+#elif defined(__SSE2__)
+    ranked = seriesColumnsRankSse2(columns,ids,ranks,series_num,
+                                   genre_counts,average_duration,age);
+#endif
+    seriesColumnsRankRange(columns,ids,ranks,ranked,series_num,genre_counts,
+                           average_duration,age);
+}
+
+
+//-----------------------------------------------------------------------//
+//                   SERIES COLUMNS: STATIC FUNCTIONS                    //
+//-----------------------------------------------------------------------//
+
+/** Rows: 15
+ ***** Static function: seriesColumnsGrow *****
+ * Description: Grows all the columns until they have room for the given
+ * id.
+ *
+ * @param columns - Series columns to grow.
+ * @param id - Id that needs room.
+ *
+ * @return
+ * SERIES_COLUMNS_OUT_OF_MEMORY - Memory allocation failed. The columns
+ * that grew keep their old values, so nothing is lost.
+ * SERIES_COLUMNS_SUCCESS - Columns grew.
+ */
+static SeriesColumnsResult seriesColumnsGrow(SeriesColumns columns,
+                                             unsigned int id){
+    unsigned int new_capacity = columns->capacity;
+    while(id>=new_capacity){
+        new_capacity *= 2;
+    }
+    if(!seriesColumnsGrowColumn(&columns->genres,new_capacity) ||
+       !seriesColumnsGrowColumn(&columns->durations,new_capacity) ||
+       !seriesColumnsGrowColumn(&columns->min_ages,new_capacity) ||
+       !seriesColumnsGrowColumn(&columns->max_ages,new_capacity)){
+        return SERIES_COLUMNS_OUT_OF_MEMORY;
+    }
+    columns->capacity = new_capacity;
+    return SERIES_COLUMNS_SUCCESS;
+}
+
+/** Rows: 7
+ ***** Static function: seriesColumnsGrowColumn *****
+ * Description: Reallocates one column to the given capacity.
+ *
+ * @param column - Pointer to the column to grow.
+ * @param capacity - New capacity of the column.
+ *
+ * @return
+ * True - Column grew.
+ * False - Memory allocation failed, the column is unchanged.
+ */
+static bool seriesColumnsGrowColumn(int** column, unsigned int capacity){
+    int* new_column = realloc(*column,capacity*sizeof(int));
+    if(!new_column){
+        return false;
+    }
+    *column = new_column;
+    return true;
+}
+
+/** Rows: 21
+ ***** Static function: seriesColumnsRankRange *****
+ * Description: Ranks the series of a range one at a time, as
+ * seriesColumnsRank describes.
+ *
+ * @param columns - Columns of the series.
+ * @param ids - Ids of the series to rank.
+ * @param ranks - F of every series when called, its rank on return.
+ * @param start - Index of the first series of the range.
+ * @param end - Index after the last series of the range.
+ * @param genre_counts - G of every genre.
+ * @param average_duration - L of the user.
+ * @param age - Age of the user.
+ */
+static void seriesColumnsRankRange(SeriesColumns columns,
+                                   const unsigned int* ids, int* ranks,
+                                   int start, int end,
+                                   const int* genre_counts,
+                                   double average_duration, int age){
+    const int* genres = columns->genres;
+    const int* durations = columns->durations;
+    const int* min_ages = columns->min_ages;
+    const int* max_ages = columns->max_ages;
+    for(int i=start;i<end;i++){
+        unsigned int id = ids[i];
+        /* Computed exactly as a single series is ranked, so the ranks do
+         * not depend on the way they were computed. */
+        double distance = (double)durations[id]-average_duration;
+        distance = distance<0 ? -distance : distance;
+        double rank = (double)genre_counts[genres[id]]*ranks[i];
+        rank /= (1+distance);
+        rank = rank<INT_MAX ? rank : INT_MAX;
+        int allowed = min_ages[id]<=age && age<=max_ages[id];
+        ranks[i] = allowed*(int)rank;
+    }
+}
+
+#ifdef __AVX2__
+/** Rows: 32
+ ***** Static function: seriesColumnsRankAvx2 *****
+ * Description: Ranks the series 8 at a time with AVX2, as long as 8 of
+ * them are left. The columns of the 8 series, and G of their genres, are
+ * gathered by their ids. The doubles are computed as the scalar ranking
+ * computes them, so the ranks are exactly the same.
+ *
+ * @param columns - Columns of the series.
+ * @param ids - Ids of the series to rank.
+ * @param ranks - F of every series when called, its rank on return.
+ * @param series_num - Number of series.
+ * @param genre_counts - G of every genre.
+ * @param average_duration - L of the user.
+ * @param age - Age of the user.
+ *
+ * @return
+ * Number of series that were ranked, a multiple of 8.
+ */
+static int seriesColumnsRankAvx2(SeriesColumns columns,
+                                 const unsigned int* ids, int* ranks,
+                                 int series_num, const int* genre_counts,
+                                 double average_duration, int age){
+    const __m256d average = _mm256_set1_pd(average_duration);
+    const __m256i ages = _mm256_set1_epi32(age);
+    int i = 0;
+    for(;i+8<=series_num;i+=8){
+        __m256i id = _mm256_loadu_si256((const __m256i*)&ids[i]);
+        __m256i genres = _mm256_i32gather_epi32(columns->genres,id,4);
+        __m256i counts = _mm256_i32gather_epi32(genre_counts,genres,4);
+        __m256i friends = _mm256_loadu_si256((const __m256i*)&ranks[i]);
+        __m256i durations = _mm256_i32gather_epi32(columns->durations,id,4);
+        __m256i min_ages = _mm256_i32gather_epi32(columns->min_ages,id,4);
+        __m256i max_ages = _mm256_i32gather_epi32(columns->max_ages,id,4);
+        __m256i forbidden = _mm256_or_si256(
+                _mm256_cmpgt_epi32(min_ages,ages),
+                _mm256_cmpgt_epi32(ages,max_ages));
+        __m128i low = seriesColumnsDivideAvx2(
+                _mm256_castsi256_si128(counts),
+                _mm256_castsi256_si128(friends),
+                _mm256_castsi256_si128(durations),average);
+        __m128i high = seriesColumnsDivideAvx2(
+                _mm256_extracti128_si256(counts,1),
+                _mm256_extracti128_si256(friends,1),
+                _mm256_extracti128_si256(durations,1),average);
+        __m256i rank = _mm256_inserti128_si256(_mm256_castsi128_si256(low),
+                                               high,1);
+        _mm256_storeu_si256((__m256i*)&ranks[i],
+                            _mm256_andnot_si256(forbidden,rank));
+    }
+    return i;
+}
+
+/** Rows: 13
+ ***** Static function: seriesColumnsDivideAvx2 *****
+ * Description: Computes G*F/(1+|CUR-L|) of 4 series in doubles, caps it
+ * at INT_MAX and truncates it, as the scalar ranking does.
+ *
+ * @param counts - G of the 4 series.
+ * @param friends - F of the 4 series.
+ * @param durations - CUR of the 4 series.
+ * @param average_duration - L in all 4 lanes.
+ *
+ * @return
+ * The 4 ranks, before the age limitations are checked.
+ */
+static __m128i seriesColumnsDivideAvx2(__m128i counts, __m128i friends,
+                                       __m128i durations,
+                                       __m256d average_duration){
+    __m256d distance = _mm256_sub_pd(_mm256_cvtepi32_pd(durations),
+                                     average_duration);
+    /* Clearing the sign bit is the absolute value. */
+    distance = _mm256_andnot_pd(_mm256_set1_pd(-0.0),distance);
+    __m256d product = _mm256_mul_pd(_mm256_cvtepi32_pd(counts),
+                                    _mm256_cvtepi32_pd(friends));
+    __m256d rank = _mm256_div_pd(product,
+                        _mm256_add_pd(_mm256_set1_pd(1.0),distance));
+    rank = _mm256_min_pd(rank,_mm256_set1_pd(INT_MAX));
+    return _mm256_cvttpd_epi32(rank);
+}
+#elif defined(__SSE2__)
+/** Rows: 36
+ ***** Static function: seriesColumnsRankSse2 *****
+ * Description: Ranks the series 4 at a time with SSE2, as long as 4 of
+ * them are left. SSE2 has no gather, so the columns of the 4 series are
+ * copied one by one, and the rest is done on all 4 together. The doubles
+ * are computed as the scalar ranking computes them, so the ranks are
+ * exactly the same.
+ *
+ * @param columns - Columns of the series.
+ * @param ids - Ids of the series to rank.
+ * @param ranks - F of every series when called, its rank on return.
+ * @param series_num - Number of series.
+ * @param genre_counts - G of every genre.
+ * @param average_duration - L of the user.
+ * @param age - Age of the user.
+ *
+ * @return
+ * Number of series that were ranked, a multiple of 4.
+ */
+static int seriesColumnsRankSse2(SeriesColumns columns,
+                                 const unsigned int* ids, int* ranks,
+                                 int series_num, const int* genre_counts,
+                                 double average_duration, int age){
+    const __m128d average = _mm_set1_pd(average_duration);
+    const __m128i ages = _mm_set1_epi32(age);
+    int counts[4], durations[4], min_ages[4], max_ages[4];
+    int i = 0;
+    for(;i+4<=series_num;i+=4){
+        for(int j=0;j<4;j++){
+            unsigned int id = ids[i+j];
+            counts[j] = genre_counts[columns->genres[id]];
+            durations[j] = columns->durations[id];
+            min_ages[j] = columns->min_ages[id];
+            max_ages[j] = columns->max_ages[id];
+        }
+        __m128i count = _mm_loadu_si128((const __m128i*)counts);
+        __m128i friends = _mm_loadu_si128((const __m128i*)&ranks[i]);
+        __m128i duration = _mm_loadu_si128((const __m128i*)durations);
+        __m128i forbidden = _mm_or_si128(
+                _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*)min_ages),
+                                ages),
+                _mm_cmpgt_epi32(ages,
+                                _mm_loadu_si128((const __m128i*)max_ages)));
+        /* Each division takes 2 doubles: the low 2 series, then the high
+         * 2 moved down. */
+        __m128i low = seriesColumnsDivideSse2(count,friends,duration,
+                                              average);
+        __m128i high = seriesColumnsDivideSse2(
+                _mm_shuffle_epi32(count,_MM_SHUFFLE(1,0,3,2)),
+                _mm_shuffle_epi32(friends,_MM_SHUFFLE(1,0,3,2)),
+                _mm_shuffle_epi32(duration,_MM_SHUFFLE(1,0,3,2)),average);
+        __m128i rank = _mm_unpacklo_epi64(low,high);
+        _mm_storeu_si128((__m128i*)&ranks[i],_mm_andnot_si128(forbidden,rank));
+    }
+    return i;
+}
+
+/** Rows: 13
+ ***** Static function: seriesColumnsDivideSse2 *****
+ * Description: Computes G*F/(1+|CUR-L|) of 2 series in doubles, caps it
+ * at INT_MAX and truncates it, as the scalar ranking does.
+ *
+ * @param counts - G of the 2 series in the 2 low lanes.
+ * @param friends - F of the 2 series in the 2 low lanes.
+ * @param durations - CUR of the 2 series in the 2 low lanes.
+ * @param average_duration - L in both lanes.
+ *
+ * @return
+ * The 2 ranks in the 2 low lanes, before the age limitations are checked.
+ */
+static __m128i seriesColumnsDivideSse2(__m128i counts, __m128i friends,
+                                       __m128i durations,
+                                       __m128d average_duration){
+    __m128d distance = _mm_sub_pd(_mm_cvtepi32_pd(durations),
+                                  average_duration);
+    /* Clearing the sign bit is the absolute value. */
+    distance = _mm_andnot_pd(_mm_set1_pd(-0.0),distance);
+    __m128d product = _mm_mul_pd(_mm_cvtepi32_pd(counts),
+                                 _mm_cvtepi32_pd(friends));
+    __m128d rank = _mm_div_pd(product,
+                              _mm_add_pd(_mm_set1_pd(1.0),distance));
+    rank = _mm_min_pd(rank,_mm_set1_pd(INT_MAX));
+    return _mm_cvttpd_epi32(rank);
+}
+#endif
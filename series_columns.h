@@ -0,0 +1,89 @@
+#ifndef MTM_EX3_MTMFLIX_SERIES_COLUMNS_H
+#define MTM_EX3_MTMFLIX_SERIES_COLUMNS_H
+
+#include "series.h"
+
+//-----------------------------------------------------------------------//
+//                SERIES COLUMNS: TYPEDEFS AND DEFINES                   //
+//-----------------------------------------------------------------------//
+
+/**
+ * Series columns: the fields of the series that are needed for ranking
+ * them, kept in one packed array per field and indexed by the series id.
+ * Ranking many series reads a few ints of each one from these arrays
+ * instead of visiting the series themselves.
+ *
+ * The columns of a series are valid from the time it is put until its id
+ * is put again. Ids of removed series are simply not read.
+ */
+
+typedef struct series_columns_t* SeriesColumns;
+
+typedef enum {
+    SERIES_COLUMNS_SUCCESS,
+    SERIES_COLUMNS_OUT_OF_MEMORY,
+    SERIES_COLUMNS_NULL_ARGUMENT
+} SeriesColumnsResult;
+
+
+//-----------------------------------------------------------------------//
+//                SERIES COLUMNS: FUNCTIONS DECLARATIONS                 //
+//-----------------------------------------------------------------------//
+
+/**
+ ***** Function: seriesColumnsCreate *****
+ * Description: Creates new empty series columns.
+ *
+ * @return
+ * New series columns or NULL in case of memory error.
+ */
+SeriesColumns seriesColumnsCreate();
+
+/**
+ ***** Function: seriesColumnsDestroy *****
+ * Description: Deallocates series columns.
+ *
+ * @param columns - Series columns to destroy.
+ */
+void seriesColumnsDestroy(SeriesColumns columns);
+
+/**
+ ***** Function: seriesColumnsPut *****
+ * Description: Copies the genre, episode duration and age limitations of
+ * a series to the columns of its id.
+ *
+ * @param columns - Series columns to put in.
+ * @param series - Series to put.
+ *
+ * @return
+ * SERIES_COLUMNS_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * SERIES_COLUMNS_OUT_OF_MEMORY - Failed to grow the columns.
+ * SERIES_COLUMNS_SUCCESS - Series put.
+ */
+SeriesColumnsResult seriesColumnsPut(SeriesColumns columns, Series series);
+
+/**
+ ***** Function: seriesColumnsRank *****
+ * Description: Ranks many series for one user, with the rank
+ * G*F/(1+|CUR-L|). A series the user is not allowed to watch gets rank 0.
+ * With AVX2 or SSE2 several series are ranked at once with vector
+ * instructions. G*F is computed in doubles and the rank is capped at
+ * INT_MAX, so every way gives exactly the same ranks, also when G*F does
+ * not fit in an int.
+ *
+ * @param columns - Columns of the series.
+ * @param ids - Ids of the series to rank. Their columns must be valid.
+ * @param ranks - For every series, F (how many friends loved it) when
+ * called. Holds the rank of every series on return.
+ * @param series_num - Number of series to rank.
+ * @param genre_counts - G of every genre: how many series of the genre the
+ * user loves. Indexed by the genre.
+ * @param average_duration - L: average episode duration of the series
+ * the user loves.
+ * @param age - Age of the user.
+ */
+void seriesColumnsRank(SeriesColumns columns, const unsigned int* ids,
+                       int* ranks, int series_num, const int* genre_counts,
+                       double average_duration, int age);
+
+#endif //MTM_EX3_MTMFLIX_SERIES_COLUMNS_H
@@ -0,0 +1,157 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "slab.h"
+
+#define SLAB_OBJECTS_PER_BLOCK 64
+
+//-----------------------------------------------------------------------//
+//                 SLAB: STATIC FUNCTIONS DECLARATIONS                   //
+//-----------------------------------------------------------------------//
+
+typedef union slab_slot_t* SlabSlot;
+
+static bool slabAddBlock(Slab slab);
+
+//-----------------------------------------------------------------------//
+//                            SLAB: STRUCT                               //
+//-----------------------------------------------------------------------//
+
+/* The unit every block is made of. Its members only give it the strictest
+ * alignment of the basic types. A free object keeps the next free object
+ * in its first slot, and the first slot of a block keeps the next block. */
+union slab_slot_t{
+    SlabSlot next;
+    long double long_double_alignment;
+    long long long_long_alignment;
+    void (*function_alignment)(void);
+};
+
+struct slab_t{
+    size_t slots_per_object;
+    SlabSlot blocks; // Every block starts with a slot of the next block.
+    SlabSlot free_objects;
+};
+
+
+//-----------------------------------------------------------------------//
+//                           SLAB: FUNCTIONS                             //
+//-----------------------------------------------------------------------//
+
+/** Rows: 13
+ ***** Function: slabCreate *****
+ * Description: Creates a new empty slab.
+ *
+ * @param object_size - Size in bytes of every object of the slab.
+ *
+ * @return
+ * A new slab or NULL in case of memory error or object size 0.
+ */
+Slab slabCreate(size_t object_size){
+    if(object_size==0){
+        return NULL;
+    }
+    Slab slab = malloc(sizeof(*slab));
+    if(!slab){
+        return NULL;
+    }
+    /* Rounding the size up to whole slots keeps every object aligned. */
+    slab->slots_per_object = (object_size+sizeof(union slab_slot_t)-1)/
+                             sizeof(union slab_slot_t);
+    slab->blocks = NULL;
+    slab->free_objects = NULL;
+    return slab;
+}
+
+/** Rows: 9
+ ***** Function: slabDestroy *****
+ * Description: Deallocates the slab and all of its objects, including the
+ * objects that were not freed.
+ *
+ * @param slab - Slab to destroy.
+ */
+void slabDestroy(Slab slab){
+    if(!slab){
+        return;
+    }
+    while(slab->blocks){
+        SlabSlot next_block = slab->blocks->next;
+        free(slab->blocks);
+        slab->blocks = next_block;
+    }
+    free(slab);
+}
+
+/** Rows: 9
+ ***** Function: slabAlloc *****
+ * Description: Allocates an object from the slab. The object is suitably
+ * aligned for any type, like memory returned by malloc.
+ *
+ * @param slab - Slab to allocate from.
+ *
+ * @return
+ * A new object (not initialized) or NULL in case of memory error or NULL
+ * argument.
+ */
+void* slabAlloc(Slab slab){
+    if(!slab){
+        return NULL;
+    }
+    if(!slab->free_objects && !slabAddBlock(slab)){
+        return NULL;
+    }
+    SlabSlot object = slab->free_objects;
+    slab->free_objects = object->next;
+    return object;
+}
+
+/** Rows: 7
+ ***** Function: slabFree *****
+ * Description: Returns an object to the slab it was allocated from.
+ *
+ * @param slab - Slab the object was allocated from.
+ * @param object - Object to free. Nothing is done if it is NULL.
+ */
+void slabFree(Slab slab, void* object){
+    assert(slab);
+    if(!object){
+        return;
+    }
+    SlabSlot slot = object;
+    slot->next = slab->free_objects;
+    slab->free_objects = slot;
+}
+
+
+//-----------------------------------------------------------------------//
+//                        SLAB: STATIC FUNCTIONS                         //
+//-----------------------------------------------------------------------//
+
+/** Rows: 15
+ ***** Static function: slabAddBlock *****
+ * Description: Allocates a new block and adds all of its objects to the
+ * free objects of the slab.
+ *
+ * @param slab - Slab to add a block to.
+ *
+ * @return
+ * True - Block added.
+ * False - Memory allocation failed.
+ */
+static bool slabAddBlock(Slab slab){
+    size_t slots_per_block = 1+SLAB_OBJECTS_PER_BLOCK*slab->slots_per_object;
+    SlabSlot block = malloc(slots_per_block*sizeof(union slab_slot_t));
+    if(!block){
+        return false;
+    }
+    block->next = slab->blocks;
+    slab->blocks = block;
+    /* The objects are linked from the last to the first, so they are
+     * given in the order of their addresses. */
+    for(int i=SLAB_OBJECTS_PER_BLOCK-1;i>=0;i--){
+        SlabSlot object = block+1+(size_t)i*slab->slots_per_object;
+        object->next = slab->free_objects;
+        slab->free_objects = object;
+    }
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef MTM_EX3_MTMFLIX_SLAB_H
+#define MTM_EX3_MTMFLIX_SLAB_H
+
+#include <stddef.h>
+
+//-----------------------------------------------------------------------//
+//                      SLAB: TYPEDEFS AND DEFINES                       //
+//-----------------------------------------------------------------------//
+
+/**
+ * Slab: allocates objects of one fixed size out of big blocks. Freed
+ * objects are kept in a free list and given again by the next allocation,
+ * so objects that are created and destroyed many times do not go through
+ * malloc and do not fragment the heap. The blocks are deallocated only
+ * when the slab is destroyed.
+ */
+
+typedef struct slab_t* Slab;
+
+
+//-----------------------------------------------------------------------//
+//                     SLAB: FUNCTIONS DECLARATIONS                      //
+//-----------------------------------------------------------------------//
+
+/**
+ ***** Function: slabCreate *****
+ * Description: Creates a new empty slab.
+ *
+ * @param object_size - Size in bytes of every object of the slab.
+ *
+ * @return
+ * A new slab or NULL in case of memory error or object size 0.
+ */
+Slab slabCreate(size_t object_size);
+
+/**
+ ***** Function: slabDestroy *****
+ * Description: Deallocates the slab and all of its objects, including the
+ * objects that were not freed.
+ *
+ * @param slab - Slab to destroy.
+ */
+void slabDestroy(Slab slab);
+
+/**
+ ***** Function: slabAlloc *****
+ * Description: Allocates an object from the slab. The object is suitably
+ * aligned for any type, like memory returned by malloc.
+ *
+ * @param slab - Slab to allocate from.
+ *
+ * @return
+ * A new object (not initialized) or NULL in case of memory error or NULL
+ * argument.
+ */
+void* slabAlloc(Slab slab);
+
+/**
+ ***** Function: slabFree *****
+ * Description: Returns an object to the slab it was allocated from.
+ *
+ * @param slab - Slab the object was allocated from.
+ * @param object - Object to free. Nothing is done if it is NULL.
+ */
+void slabFree(Slab slab, void* object);
+
+#endif //MTM_EX3_MTMFLIX_SLAB_H
@@ -0,0 +1,572 @@
+/* For mmap, fstat and fileno, like pthreads a POSIX dependency. */
+#define _POSIX_C_SOURCE 200112L
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <assert.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "snapshot.h"
+
+/* "MFS1" - changes if the byte order of the file is not ours. */
+#define SNAPSHOT_MAGIC 0x3153464Du
+#define SNAPSHOT_VERSION 1u
+#define SNAPSHOT_HEADER_WORDS 7
+#define SNAPSHOT_SERIES_WORDS (sizeof(SnapshotSeries)/sizeof(uint32_t))
+#define SNAPSHOT_USER_WORDS (sizeof(SnapshotUser)/sizeof(uint32_t))
+/* A stream that cannot be mapped is read in parts of at least this many
+ * words, so a header that lies about the sizes is found out before more
+ * memory than the stream holds is allocated. */
+#define SNAPSHOT_READ_WORDS 4096
+
+//-----------------------------------------------------------------------//
+//                SNAPSHOT: STATIC FUNCTIONS DECLARATIONS                //
+//-----------------------------------------------------------------------//
+
+static Snapshot snapshotAllocate(const uint32_t* header);
+
+static bool snapshotSetSizes(Snapshot snapshot, const uint32_t* header);
+
+static void snapshotFindSections(Snapshot snapshot);
+
+static SnapshotResult snapshotMapImage(Snapshot snapshot, FILE* inputStream,
+                                       bool* mapped);
+
+static SnapshotResult snapshotReadImage(Snapshot snapshot,
+                                        FILE* inputStream,
+                                        const uint32_t* header);
+
+static bool snapshotNameIsValid(Snapshot snapshot, uint32_t name);
+
+static bool snapshotIsValid(Snapshot snapshot);
+
+//-----------------------------------------------------------------------//
+//                          SNAPSHOT: STRUCT                             //
+//-----------------------------------------------------------------------//
+
+/* The header is: magic, version, number of series, number of users, size
+ * of the names table in bytes, number of friends, number of favorites. */
+struct snapshot_t{
+    uint32_t* image; // The header and the sections, as in the file.
+    size_t words; // Size of the image.
+    /* The mapping of the file the image is in, or NULL if the image was
+     * allocated. */
+    void* mapping;
+    size_t mapping_size;
+    size_t series_num;
+    size_t users_num;
+    size_t names_size;
+    size_t friends_num;
+    size_t favorites_num;
+    /* The sections, in their order in the image. */
+    char* names;
+    SnapshotSeries* series;
+    SnapshotUser* users;
+    uint32_t* friends;
+    uint32_t* favorites;
+};
+
+
+//-----------------------------------------------------------------------//
+//                         SNAPSHOT: FUNCTIONS                           //
+//-----------------------------------------------------------------------//
+
+/** Rows: 16
+ ***** Function: snapshotCreate *****
+ * Description: Creates a new snapshot with room for the given number of
+ * records. The sections are not initialized, they should be filled by
+ * the caller before the snapshot is written.
+ *
+ * @param series_num - Number of series records.
+ * @param users_num - Number of user records.
+ * @param names_size - Size in bytes of the names table.
+ * @param friends_num - Number of friends of all the users together.
+ * @param favorites_num - Number of favorite series of all the users
+ * together.
+ *
+ * @return
+ * A new snapshot or NULL in case of memory error or a snapshot too big
+ * for the format.
+ */
+Snapshot snapshotCreate(size_t series_num, size_t users_num,
+                        size_t names_size, size_t friends_num,
+                        size_t favorites_num){
+    if(series_num>UINT32_MAX || users_num>UINT32_MAX ||
+       names_size>UINT32_MAX || friends_num>UINT32_MAX ||
+       favorites_num>UINT32_MAX){
+        return NULL;
+    }
+    uint32_t header[SNAPSHOT_HEADER_WORDS] = {SNAPSHOT_MAGIC,
+            SNAPSHOT_VERSION,(uint32_t)series_num,(uint32_t)users_num,
+            (uint32_t)names_size,(uint32_t)friends_num,
+            (uint32_t)favorites_num};
+    Snapshot snapshot = snapshotAllocate(header);
+    if(!snapshot){
+        return NULL;
+    }
+    /* The padding of the names table is written too. */
+    memset(snapshot->names,0,
+           (size_t)((char*)snapshot->series-snapshot->names));
+    return snapshot;
+}
+
+/** Rows: 10
+ ***** Function: snapshotDestroy *****
+ * Description: Deallocates a snapshot.
+ *
+ * @param snapshot - Snapshot to destroy.
+ */
+void snapshotDestroy(Snapshot snapshot){
+    if(!snapshot){
+        return;
+    }
+    if(snapshot->mapping){
+        munmap(snapshot->mapping,snapshot->mapping_size);
+    }else{
+        free(snapshot->image);
+    }
+    free(snapshot);
+}
+
+/** Rows: 9
+ ***** Function: snapshotWrite *****
+ * Description: Writes the image of a snapshot to a file.
+ *
+ * @param snapshot - Snapshot to write.
+ * @param outputStream - File to write to.
+ *
+ * @return
+ * SNAPSHOT_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * SNAPSHOT_WRITE_FAILED - Failed to write to the file.
+ * SNAPSHOT_SUCCESS - Snapshot written.
+ */
+SnapshotResult snapshotWrite(Snapshot snapshot, FILE* outputStream){
+    if(!snapshot || !outputStream){
+        return SNAPSHOT_NULL_ARGUMENT;
+    }
+    if(fwrite(snapshot->image,sizeof(uint32_t),snapshot->words,
+              outputStream)!=snapshot->words){
+        return SNAPSHOT_WRITE_FAILED;
+    }
+    return SNAPSHOT_SUCCESS;
+}
+
+/** Rows: 35
+ ***** Function: snapshotRead *****
+ * Description: Reads a snapshot that was written by snapshotWrite. The
+ * sizes in the header are checked against what the file holds before
+ * anything is allocated for them. A snapshot in a regular file is mapped
+ * to memory and its sections are used in place, any other stream is read
+ * into memory. The layout is checked too: that every name offset points
+ * to a name in the table, that the friends and favorites of every user
+ * are in their sections and refer to existing users and series. The
+ * values of the records are not checked. The stream is left after the
+ * snapshot.
+ *
+ * @param inputStream - File to read from.
+ * @param snapshot - Holds the new snapshot on success.
+ *
+ * @return
+ * SNAPSHOT_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * SNAPSHOT_OUT_OF_MEMORY - Any memory error.
+ * SNAPSHOT_BAD_FILE - The file is not a valid snapshot.
+ * SNAPSHOT_SUCCESS - Snapshot read.
+ */
+SnapshotResult snapshotRead(FILE* inputStream, Snapshot* snapshot){
+    if(!inputStream || !snapshot){
+        return SNAPSHOT_NULL_ARGUMENT;
+    }
+    uint32_t header[SNAPSHOT_HEADER_WORDS];
+    if(fread(header,sizeof(uint32_t),SNAPSHOT_HEADER_WORDS,inputStream)!=
+       SNAPSHOT_HEADER_WORDS || header[0]!=SNAPSHOT_MAGIC ||
+       header[1]!=SNAPSHOT_VERSION){
+        return SNAPSHOT_BAD_FILE;
+    }
+    Snapshot new_snapshot = malloc(sizeof(*new_snapshot));
+    if(!new_snapshot){
+        return SNAPSHOT_OUT_OF_MEMORY;
+    }
+    new_snapshot->image = NULL;
+    new_snapshot->mapping = NULL;
+    bool mapped = false;
+    SnapshotResult result = snapshotSetSizes(new_snapshot,header) ?
+            snapshotMapImage(new_snapshot,inputStream,&mapped) :
+            SNAPSHOT_BAD_FILE;
+    if(result==SNAPSHOT_SUCCESS && !mapped){
+        result = snapshotReadImage(new_snapshot,inputStream,header);
+    }
+    if(result==SNAPSHOT_SUCCESS){
+        snapshotFindSections(new_snapshot);
+        if(!snapshotIsValid(new_snapshot)){
+            result = SNAPSHOT_BAD_FILE;
+        }
+    }
+    if(result!=SNAPSHOT_SUCCESS){
+        snapshotDestroy(new_snapshot);
+        return result;
+    }
+    *snapshot = new_snapshot;
+    return SNAPSHOT_SUCCESS;
+}
+
+/** Rows: 4
+ ***** Function: snapshotGetSeriesNum *****
+ * Description: Returns the number of series records of a snapshot.
+ *
+ * @param snapshot - Snapshot to check.
+ *
+ * @return
+ * Number of series records.
+ */
+size_t snapshotGetSeriesNum(Snapshot snapshot){
+    assert(snapshot);
+    return snapshot->series_num;
+}
+
+/** Rows: 4
+ ***** Function: snapshotGetUsersNum *****
+ * Description: Returns the number of user records of a snapshot.
+ *
+ * @param snapshot - Snapshot to check.
+ *
+ * @return
+ * Number of user records.
+ */
+size_t snapshotGetUsersNum(Snapshot snapshot){
+    assert(snapshot);
+    return snapshot->users_num;
+}
+
+/** Rows: 4
+ ***** Function: snapshotGetNames *****
+ * Description: Returns the names table of a snapshot.
+ *
+ * @param snapshot - Snapshot to get from.
+ *
+ * @return
+ * The names table. Belongs to the snapshot.
+ */
+char* snapshotGetNames(Snapshot snapshot){
+    assert(snapshot);
+    return snapshot->names;
+}
+
+/** Rows: 4
+ ***** Function: snapshotGetSeries *****
+ * Description: Returns the series records of a snapshot.
+ *
+ * @param snapshot - Snapshot to get from.
+ *
+ * @return
+ * Array of the series records. Belongs to the snapshot.
+ */
+SnapshotSeries* snapshotGetSeries(Snapshot snapshot){
+    assert(snapshot);
+    return snapshot->series;
+}
+
+/** Rows: 4
+ ***** Function: snapshotGetUsers *****
+ * Description: Returns the user records of a snapshot.
+ *
+ * @param snapshot - Snapshot to get from.
+ *
+ * @return
+ * Array of the user records. Belongs to the snapshot.
+ */
+SnapshotUser* snapshotGetUsers(Snapshot snapshot){
+    assert(snapshot);
+    return snapshot->users;
+}
+
+/** Rows: 4
+ ***** Function: snapshotGetFriends *****
+ * Description: Returns the friends of all the users of a snapshot, as
+ * positions of users.
+ *
+ * @param snapshot - Snapshot to get from.
+ *
+ * @return
+ * Array of the friends. Belongs to the snapshot.
+ */
+uint32_t* snapshotGetFriends(Snapshot snapshot){
+    assert(snapshot);
+    return snapshot->friends;
+}
+
+/** Rows: 4
+ ***** Function: snapshotGetFavorites *****
+ * Description: Returns the favorite series of all the users of a
+ * snapshot, as positions of series.
+ *
+ * @param snapshot - Snapshot to get from.
+ *
+ * @return
+ * Array of the favorite series. Belongs to the snapshot.
+ */
+uint32_t* snapshotGetFavorites(Snapshot snapshot){
+    assert(snapshot);
+    return snapshot->favorites;
+}
+
+
+//-----------------------------------------------------------------------//
+//                       SNAPSHOT: STATIC FUNCTIONS                      //
+//-----------------------------------------------------------------------//
+
+/** Rows: 18
+ ***** Static function: snapshotAllocate *****
+ * Description: Allocates a snapshot and its image for the sizes of the
+ * given header, copies the header to the image and finds the sections.
+ *
+ * @param header - Header of the snapshot.
+ *
+ * @return
+ * A new snapshot (with only its header initialized) or NULL in case of
+ * memory error or an image too big to allocate.
+ */
+static Snapshot snapshotAllocate(const uint32_t* header){
+    Snapshot snapshot = malloc(sizeof(*snapshot));
+    if(!snapshot){
+        return NULL;
+    }
+    snapshot->mapping = NULL;
+    if(!snapshotSetSizes(snapshot,header)){
+        free(snapshot);
+        return NULL;
+    }
+    snapshot->image = malloc(snapshot->words*sizeof(uint32_t));
+    if(!snapshot->image){
+        free(snapshot);
+        return NULL;
+    }
+    memcpy(snapshot->image,header,SNAPSHOT_HEADER_WORDS*sizeof(uint32_t));
+    snapshotFindSections(snapshot);
+    return snapshot;
+}
+
+/** Rows: 19
+ ***** Static function: snapshotSetSizes *****
+ * Description: Sets the sizes of the sections of a snapshot, and the size
+ * of its image, from a header.
+ *
+ * @param snapshot - Snapshot to set the sizes of.
+ * @param header - Header of the snapshot.
+ *
+ * @return
+ * True - Sizes set.
+ * False - The image is too big for the memory of this machine.
+ */
+static bool snapshotSetSizes(Snapshot snapshot, const uint32_t* header){
+    snapshot->series_num = header[2];
+    snapshot->users_num = header[3];
+    snapshot->names_size = header[4];
+    snapshot->friends_num = header[5];
+    snapshot->favorites_num = header[6];
+    unsigned long long names_words = ((unsigned long long)
+            snapshot->names_size+sizeof(uint32_t)-1)/sizeof(uint32_t);
+    /* Every size is below 2^32, so the sum fits in 64 bits, but it may
+     * not fit in a size_t. */
+    unsigned long long words = SNAPSHOT_HEADER_WORDS+names_words+
+            (unsigned long long)snapshot->series_num*SNAPSHOT_SERIES_WORDS+
+            (unsigned long long)snapshot->users_num*SNAPSHOT_USER_WORDS+
+            snapshot->friends_num+snapshot->favorites_num;
+    if(words>SIZE_MAX/sizeof(uint32_t)){
+        return false;
+    }
+    snapshot->words = (size_t)words;
+    return true;
+}
+
+/** Rows: 13
+ ***** Static function: snapshotFindSections *****
+ * Description: Points the sections of a snapshot into its image, by the
+ * sizes of the sections.
+ *
+ * @param snapshot - Snapshot with its sizes set and its image in place.
+ */
+static void snapshotFindSections(Snapshot snapshot){
+    size_t names_words = (snapshot->names_size+sizeof(uint32_t)-1)/
+                         sizeof(uint32_t);
+    uint32_t* section = snapshot->image+SNAPSHOT_HEADER_WORDS;
+    snapshot->names = (char*)section;
+    section += names_words;
+    snapshot->series = (SnapshotSeries*)section;
+    section += snapshot->series_num*SNAPSHOT_SERIES_WORDS;
+    snapshot->users = (SnapshotUser*)section;
+    section += snapshot->users_num*SNAPSHOT_USER_WORDS;
+    snapshot->friends = section;
+    snapshot->favorites = section+snapshot->friends_num;
+}
+
+/** Rows: 37
+ ***** Static function: snapshotMapImage *****
+ * Description: Maps the image of a snapshot from a regular file, whose
+ * header was just read from the stream. The file is mapped from its
+ * start, so the image must start at a word in it. Its pages are private
+ * copies, so the image may be changed like an allocated one. The stream
+ * is moved to the end of the image.
+ *
+ * @param snapshot - Snapshot with its sizes set.
+ * @param inputStream - The stream, right after the header.
+ * @param mapped - Set to whether the image was mapped. If not, it should
+ * be read from the stream.
+ *
+ * @return
+ * SNAPSHOT_BAD_FILE - The file is shorter than the image.
+ * SNAPSHOT_SUCCESS - The image was mapped, or it could not be and the file
+ * is long enough.
+ */
+static SnapshotResult snapshotMapImage(Snapshot snapshot, FILE* inputStream,
+                                       bool* mapped){
+    *mapped = false;
+    int descriptor = fileno(inputStream);
+    long position = ftell(inputStream);
+    struct stat status;
+    if(descriptor<0 || position<0 || fstat(descriptor,&status)!=0 ||
+       !S_ISREG(status.st_mode)){
+        /* Not a regular file, its length is found while it is read. */
+        return SNAPSHOT_SUCCESS;
+    }
+    unsigned long long start = (unsigned long long)position-
+                               SNAPSHOT_HEADER_WORDS*sizeof(uint32_t);
+    unsigned long long end = start+
+            (unsigned long long)snapshot->words*sizeof(uint32_t);
+    if(end>(unsigned long long)status.st_size){
+        return SNAPSHOT_BAD_FILE;
+    }
+    if(start%sizeof(uint32_t)!=0 || end>SIZE_MAX || end>LONG_MAX){
+        return SNAPSHOT_SUCCESS;
+    }
+    void* mapping = mmap(NULL,(size_t)end,PROT_READ|PROT_WRITE,MAP_PRIVATE,
+                         descriptor,0);
+    if(mapping==MAP_FAILED){
+        return SNAPSHOT_SUCCESS;
+    }
+    if(fseek(inputStream,(long)end,SEEK_SET)!=0){
+        /* Read after all, right after the header. */
+        munmap(mapping,(size_t)end);
+        return SNAPSHOT_SUCCESS;
+    }
+    snapshot->mapping = mapping;
+    snapshot->mapping_size = (size_t)end;
+    snapshot->image = (uint32_t*)((char*)mapping+start);
+    *mapped = true;
+    return SNAPSHOT_SUCCESS;
+}
+
+/** Rows: 31
+ ***** Static function: snapshotReadImage *****
+ * Description: Reads the image of a snapshot from a stream, whose header
+ * was just read from it. The image grows while the stream still holds
+ * more of it, so no more than twice what the stream holds is allocated
+ * even if the header claims a huge image.
+ *
+ * @param snapshot - Snapshot with its sizes set.
+ * @param inputStream - The stream, right after the header.
+ * @param header - The header that was read.
+ *
+ * @return
+ * SNAPSHOT_OUT_OF_MEMORY - Any memory error.
+ * SNAPSHOT_BAD_FILE - The stream ended before the image.
+ * SNAPSHOT_SUCCESS - Image read.
+ */
+static SnapshotResult snapshotReadImage(Snapshot snapshot,
+                                        FILE* inputStream,
+                                        const uint32_t* header){
+    size_t read_words = SNAPSHOT_HEADER_WORDS;
+    while(read_words<snapshot->words){
+        size_t words = read_words<SNAPSHOT_READ_WORDS ? SNAPSHOT_READ_WORDS :
+                       read_words*2;
+        if(words>snapshot->words){
+            words = snapshot->words;
+        }
+        uint32_t* new_image = realloc(snapshot->image,
+                                      words*sizeof(uint32_t));
+        if(!new_image){
+            return SNAPSHOT_OUT_OF_MEMORY;
+        }
+        snapshot->image = new_image;
+        if(fread(snapshot->image+read_words,sizeof(uint32_t),
+                 words-read_words,inputStream)!=words-read_words){
+            return SNAPSHOT_BAD_FILE;
+        }
+        read_words = words;
+    }
+    if(!snapshot->image){
+        /* An image of only a header. */
+        snapshot->image = malloc(SNAPSHOT_HEADER_WORDS*sizeof(uint32_t));
+        if(!snapshot->image){
+            return SNAPSHOT_OUT_OF_MEMORY;
+        }
+    }
+    memcpy(snapshot->image,header,SNAPSHOT_HEADER_WORDS*sizeof(uint32_t));
+    return SNAPSHOT_SUCCESS;
+}
+
+/** Rows: 3
+ ***** Static function: snapshotNameIsValid *****
+ * Description: Checks that a name offset points to a name that ends
+ * inside the names table.
+ *
+ * @param snapshot - Snapshot the name is in.
+ * @param name - Offset of the name.
+ *
+ * @return
+ * True - The name is valid.
+ * False - The name is out of the table or does not end in it.
+ */
+static bool snapshotNameIsValid(Snapshot snapshot, uint32_t name){
+    return name<snapshot->names_size &&
+           memchr(snapshot->names+name,'\0',snapshot->names_size-name);
+}
+
+/** Rows: 34
+ ***** Static function: snapshotIsValid *****
+ * Description: Checks the layout of a snapshot that was read: the names
+ * of the records, and that the friends and favorites of the users are in
+ * their sections and refer to existing users and series.
+ *
+ * @param snapshot - Snapshot to check.
+ *
+ * @return
+ * True - The layout is valid.
+ * False - The snapshot is corrupted.
+ */
+static bool snapshotIsValid(Snapshot snapshot){
+    for(size_t i=0;i<snapshot->series_num;i++){
+        if(!snapshotNameIsValid(snapshot,snapshot->series[i].name)){
+            return false;
+        }
+    }
+    uint32_t friends_start = 0;
+    uint32_t favorites_start = 0;
+    for(size_t i=0;i<snapshot->users_num;i++){
+        SnapshotUser* user = &snapshot->users[i];
+        if(!snapshotNameIsValid(snapshot,user->name) ||
+           user->friends_end<friends_start ||
+           user->friends_end>snapshot->friends_num ||
+           user->favorites_end<favorites_start ||
+           user->favorites_end>snapshot->favorites_num){
+            return false;
+        }
+        friends_start = user->friends_end;
+        favorites_start = user->favorites_end;
+    }
+    if(friends_start!=snapshot->friends_num ||
+       favorites_start!=snapshot->favorites_num){
+        return false;
+    }
+    for(size_t i=0;i<snapshot->friends_num;i++){
+        if(snapshot->friends[i]>=snapshot->users_num){
+            return false;
+        }
+    }
+    for(size_t i=0;i<snapshot->favorites_num;i++){
+        if(snapshot->favorites[i]>=snapshot->series_num){
+            return false;
+        }
+    }
+    return true;
+}
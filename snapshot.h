@@ -0,0 +1,202 @@
+#ifndef MTM_EX3_MTMFLIX_SNAPSHOT_H
+#define MTM_EX3_MTMFLIX_SNAPSHOT_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------//
+//                    SNAPSHOT: TYPEDEFS AND DEFINES                     //
+//-----------------------------------------------------------------------//
+
+/**
+ * Snapshot: the binary image of a whole mtmflix, as it is kept in a file.
+ * The image is an array of 32 bit words: a header with the sizes of the
+ * sections, then a table of all the names (each ends with '\0'), the
+ * series records, the user records, and the friends and favorite series
+ * of all the users one after the other. Users and series are referred to
+ * by their positions in the snapshot, and names by their offsets in the
+ * table.
+ *
+ * The file holds exactly the image that is kept in memory, with every
+ * section aligned to a word, so a snapshot in a regular file is mapped to
+ * memory and its sections are used in place. Other streams are read.
+ * Words are kept in the byte order of the machine; a file written on a
+ * machine with another byte order is rejected by its magic number.
+ */
+
+typedef struct snapshot_t* Snapshot;
+
+typedef struct snapshot_series_t{
+    uint32_t name; // Offset of the name in the names table.
+    uint32_t genre;
+    uint32_t episodes_num;
+    uint32_t episodes_duration;
+    uint32_t has_age_limit; // 1 if the ages below are a limit, else 0.
+    uint32_t min_age;
+    uint32_t max_age;
+} SnapshotSeries;
+
+typedef struct snapshot_user_t{
+    uint32_t name; // Offset of the name in the names table.
+    uint32_t age;
+    /* The friends and favorite series of the user end where these say,
+     * and start where those of the previous user end. */
+    uint32_t friends_end;
+    uint32_t favorites_end;
+} SnapshotUser;
+
+typedef enum {
+    SNAPSHOT_SUCCESS,
+    SNAPSHOT_OUT_OF_MEMORY,
+    SNAPSHOT_BAD_FILE,
+    SNAPSHOT_WRITE_FAILED,
+    SNAPSHOT_NULL_ARGUMENT
+} SnapshotResult;
+
+
+//-----------------------------------------------------------------------//
+//                   SNAPSHOT: FUNCTIONS DECLARATIONS                    //
+//-----------------------------------------------------------------------//
+
+/**
+ ***** Function: snapshotCreate *****
+ * Description: Creates a new snapshot with room for the given number of
+ * records. The sections are not initialized, they should be filled by
+ * the caller before the snapshot is written.
+ *
+ * @param series_num - Number of series records.
+ * @param users_num - Number of user records.
+ * @param names_size - Size in bytes of the names table.
+ * @param friends_num - Number of friends of all the users together.
+ * @param favorites_num - Number of favorite series of all the users
+ * together.
+ *
+ * @return
+ * A new snapshot or NULL in case of memory error or a snapshot too big
+ * for the format.
+ */
+Snapshot snapshotCreate(size_t series_num, size_t users_num,
+                        size_t names_size, size_t friends_num,
+                        size_t favorites_num);
+
+/**
+ ***** Function: snapshotDestroy *****
+ * Description: Deallocates a snapshot.
+ *
+ * @param snapshot - Snapshot to destroy.
+ */
+void snapshotDestroy(Snapshot snapshot);
+
+/**
+ ***** Function: snapshotWrite *****
+ * Description: Writes the image of a snapshot to a file.
+ *
+ * @param snapshot - Snapshot to write.
+ * @param outputStream - File to write to.
+ *
+ * @return
+ * SNAPSHOT_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * SNAPSHOT_WRITE_FAILED - Failed to write to the file.
+ * SNAPSHOT_SUCCESS - Snapshot written.
+ */
+SnapshotResult snapshotWrite(Snapshot snapshot, FILE* outputStream);
+
+/**
+ ***** Function: snapshotRead *****
+ * Description: Reads a snapshot that was written by snapshotWrite. The
+ * layout of the file is checked: the sizes of the sections, that every
+ * name offset points to a name in the table, that the friends and
+ * favorites of every user are in their sections and refer to existing
+ * users and series. The values of the records are not checked.
+ *
+ * @param inputStream - File to read from.
+ * @param snapshot - Holds the new snapshot on success.
+ *
+ * @return
+ * SNAPSHOT_NULL_ARGUMENT - At least one of the arguments is NULL.
+ * SNAPSHOT_OUT_OF_MEMORY - Any memory error.
+ * SNAPSHOT_BAD_FILE - The file is not a valid snapshot.
+ * SNAPSHOT_SUCCESS - Snapshot read.
+ */
+SnapshotResult snapshotRead(FILE* inputStream, Snapshot* snapshot);
+
+/**
+ ***** Function: snapshotGetSeriesNum *****
+ * Description: Returns the number of series records of a snapshot.
+ *
+ * @param snapshot - Snapshot to check.
+ *
+ * @return
+ * Number of series records.
+ */
+size_t snapshotGetSeriesNum(Snapshot snapshot);
+
+/**
+ ***** Function: snapshotGetUsersNum *****
+ * Description: Returns the number of user records of a snapshot.
+ *
+ * @param snapshot - Snapshot to check.
+ *
+ * @return
+ * Number of user records.
+ */
+size_t snapshotGetUsersNum(Snapshot snapshot);
+
+/**
+ ***** Function: snapshotGetNames *****
+ * Description: Returns the names table of a snapshot.
+ *
+ * @param snapshot - Snapshot to get from.
+ *
+ * @return
+ * The names table. Belongs to the snapshot.
+ */
+char* snapshotGetNames(Snapshot snapshot);
+
+/**
+ ***** Function: snapshotGetSeries *****
+ * Description: Returns the series records of a snapshot.
+ *
+ * @param snapshot - Snapshot to get from.
+ *
+ * @return
+ * Array of the series records. Belongs to the snapshot.
+ */
+SnapshotSeries* snapshotGetSeries(Snapshot snapshot);
+
+/**
+ ***** Function: snapshotGetUsers *****
+ * Description: Returns the user records of a snapshot.
+ *
+ * @param snapshot - Snapshot to get from.
+ *
+ * @return
+ * Array of the user records. Belongs to the snapshot.
+ */
+SnapshotUser* snapshotGetUsers(Snapshot snapshot);
+
+/**
+ ***** Function: snapshotGetFriends *****
+ * Description: Returns the friends of all the users of a snapshot, as
+ * positions of users.
+ *
+ * @param snapshot - Snapshot to get from.
+ *
+ * @return
+ * Array of the friends. Belongs to the snapshot.
+ */
+uint32_t* snapshotGetFriends(Snapshot snapshot);
+
+/**
+ ***** Function: snapshotGetFavorites *****
+ * Description: Returns the favorite series of all the users of a
+ * snapshot, as positions of series.
+ *
+ * @param snapshot - Snapshot to get from.
+ *
+ * @return
+ * Array of the favorite series. Belongs to the snapshot.
+ */
+uint32_t* snapshotGetFavorites(Snapshot snapshot);
+
+#endif //MTM_EX3_MTMFLIX_SNAPSHOT_H
@@ -0,0 +1,189 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <assert.h>
+#include "string_pool.h"
+#include "name_index.h"
+
+//-----------------------------------------------------------------------//
+//              STRING POOL: STATIC FUNCTIONS DECLARATIONS               //
+//-----------------------------------------------------------------------//
+
+typedef struct string_pool_entry_t* StringPoolEntry;
+
+static StringPoolEntry stringPoolGetEntry(char* string);
+
+static const char* stringPoolGetEntryKey(NameIndexElement element);
+
+static void stringPoolFreeEntry(NameIndexElement element);
+
+//-----------------------------------------------------------------------//
+//                       STRING POOL: STRUCT                             //
+//-----------------------------------------------------------------------//
+
+struct string_pool_t{
+    NameIndex entries; // Owns the entries. Lookup by string.
+};
+
+/* Every interned string is stored right after its header, so the header
+ * can be found from the string itself. */
+struct string_pool_entry_t{
+    StringPool pool;
+    int references;
+    char string[];
+};
+
+
+//-----------------------------------------------------------------------//
+//                      STRING POOL: FUNCTIONS                           //
+//-----------------------------------------------------------------------//
+
+/** Rows: 12
+ ***** Function: stringPoolCreate *****
+ * Description: Creates a new empty string pool.
+ *
+ * @return
+ * A new string pool or NULL in case of memory error.
+ */
+StringPool stringPoolCreate(){
+    StringPool pool = malloc(sizeof(*pool));
+    if(!pool){
+        return NULL;
+    }
+    pool->entries = nameIndexCreate(stringPoolGetEntryKey,
+                                    stringPoolFreeEntry);
+    if(!pool->entries){
+        free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+/** Rows: 5
+ ***** Function: stringPoolDestroy *****
+ * Description: Deallocates the pool and every string still in it. Should
+ * be called after all the references were released.
+ *
+ * @param pool - String pool to destroy.
+ */
+void stringPoolDestroy(StringPool pool){
+    if(!pool){
+        return;
+    }
+    nameIndexDestroy(pool->entries);
+    free(pool);
+}
+
+/** Rows: 21
+ ***** Function: stringPoolIntern *****
+ * Description: Returns the interned copy of the given string and takes a
+ * reference to it. The string is added to the pool if it is not there.
+ *
+ * @param pool - String pool to intern in.
+ * @param string - String to intern.
+ *
+ * @return
+ * The interned string (should be released with stringPoolRelease), or NULL
+ * in case of NULL argument or memory error.
+ */
+char* stringPoolIntern(StringPool pool, const char* string){
+    if(!pool || !string){
+        return NULL;
+    }
+    StringPoolEntry entry = nameIndexFind(pool->entries,string);
+    if(entry){
+        /* Already interned. */
+        entry->references++;
+        return entry->string;
+    }
+    size_t length = strlen(string);
+    entry = malloc(sizeof(*entry)+length+1);
+    if(!entry){
+        return NULL;
+    }
+    entry->pool = pool;
+    entry->references = 1;
+    memcpy(entry->string,string,length+1);
+    if(nameIndexInsert(pool->entries,entry)!=NAME_INDEX_SUCCESS){
+        free(entry);
+        return NULL;
+    }
+    return entry->string;
+}
+
+/** Rows: 3
+ ***** Function: stringPoolRetain *****
+ * Description: Takes another reference to an interned string.
+ *
+ * @param string - Interned string.
+ *
+ * @return
+ * The same interned string.
+ */
+char* stringPoolRetain(char* string){
+    assert(string);
+    stringPoolGetEntry(string)->references++;
+    return string;
+}
+
+/** Rows: 9
+ ***** Function: stringPoolRelease *****
+ * Description: Releases a reference to an interned string. The string is
+ * removed from its pool and deallocated when its last reference is
+ * released.
+ *
+ * @param string - Interned string. Nothing is done if it is NULL.
+ */
+void stringPoolRelease(char* string){
+    if(!string){
+        return;
+    }
+    StringPoolEntry entry = stringPoolGetEntry(string);
+    entry->references--;
+    if(entry->references==0){
+        /* Deallocates the entry. */
+        nameIndexRemove(entry->pool->entries,string);
+    }
+}
+
+
+//-----------------------------------------------------------------------//
+//                    STRING POOL: STATIC FUNCTIONS                      //
+//-----------------------------------------------------------------------//
+
+/** Rows: 2
+ ***** Static function: stringPoolGetEntry *****
+ * Description: Returns the entry that holds an interned string.
+ *
+ * @param string - Interned string.
+ *
+ * @return
+ * The entry of the string.
+ */
+static StringPoolEntry stringPoolGetEntry(char* string){
+    return (StringPoolEntry)(string-
+                             offsetof(struct string_pool_entry_t,string));
+}
+
+/** Rows: 1
+ ***** Static function: stringPoolGetEntryKey *****
+ * Description: Returns the string of an entry. Used by the name index.
+ *
+ * @param element - An entry.
+ *
+ * @return
+ * The interned string of the entry.
+ */
+static const char* stringPoolGetEntryKey(NameIndexElement element){
+    return ((StringPoolEntry)element)->string;
+}
+
+/** Rows: 1
+ ***** Static function: stringPoolFreeEntry *****
+ * Description: Deallocates an entry. Used by the name index.
+ *
+ * @param element - An entry.
+ */
+static void stringPoolFreeEntry(NameIndexElement element){
+    free(element);
+}
@@ -0,0 +1,82 @@
+#ifndef MTM_EX3_MTMFLIX_STRING_POOL_H
+#define MTM_EX3_MTMFLIX_STRING_POOL_H
+
+//-----------------------------------------------------------------------//
+//                 STRING POOL: TYPEDEFS AND DEFINES                     //
+//-----------------------------------------------------------------------//
+
+/**
+ * String pool: keeps a single reference counted copy of every string that
+ * is interned in it. Interning a string that is already in the pool
+ * returns the same pointer, so two interned strings are equal if and only
+ * if they are the same pointer.
+ *
+ * An interned string is released when its last reference is released.
+ * References are taken and released through the string itself, so copy
+ * and destroy functions of containers can share interned strings without
+ * knowing the pool.
+ *
+ * Interned strings must not be changed.
+ */
+
+typedef struct string_pool_t* StringPool;
+
+
+//-----------------------------------------------------------------------//
+//                 STRING POOL: FUNCTIONS DECLARATIONS                   //
+//-----------------------------------------------------------------------//
+
+/**
+ ***** Function: stringPoolCreate *****
+ * Description: Creates a new empty string pool.
+ *
+ * @return
+ * A new string pool or NULL in case of memory error.
+ */
+StringPool stringPoolCreate();
+
+/**
+ ***** Function: stringPoolDestroy *****
+ * Description: Deallocates the pool and every string still in it. Should
+ * be called after all the references were released.
+ *
+ * @param pool - String pool to destroy.
+ */
+void stringPoolDestroy(StringPool pool);
+
+/**
+ ***** Function: stringPoolIntern *****
+ * Description: Returns the interned copy of the given string and takes a
+ * reference to it. The string is added to the pool if it is not there.
+ *
+ * @param pool - String pool to intern in.
+ * @param string - String to intern.
+ *
+ * @return
+ * The interned string (should be released with stringPoolRelease), or NULL
+ * in case of NULL argument or memory error.
+ */
+char* stringPoolIntern(StringPool pool, const char* string);
+
+/**
+ ***** Function: stringPoolRetain *****
+ * Description: Takes another reference to an interned string.
+ *
+ * @param string - Interned string.
+ *
+ * @return
+ * The same interned string.
+ */
+char* stringPoolRetain(char* string);
+
+/**
+ ***** Function: stringPoolRelease *****
+ * Description: Releases a reference to an interned string. The string is
+ * removed from its pool and deallocated when its last reference is
+ * released.
+ *
+ * @param string - Interned string. Nothing is done if it is NULL.
+ */
+void stringPoolRelease(char* string);
+
+#endif //MTM_EX3_MTMFLIX_STRING_POOL_H
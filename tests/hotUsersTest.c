@@ -0,0 +1,116 @@
+#include "test_utilities.h"
+#include "../user.h"
+#include "../series.h"
+#include "../id_index.h"
+#include "../like_counts.h"
+#include "../string_pool.h"
+#include "../slab.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+/*
+* Unit tests of hot users: a hot user keeps how many of his friends love
+* each series, a user that is not hot anymore keeps no counts, and a user
+* that is hot again counts everything from the start.
+*/
+
+#define HOT_TEST_USERS 3
+#define HOT_TEST_SERIES 2
+
+/* How many friends love a series, by the counts of a hot user. */
+static int countOf(LikeCounts counts, Series series){
+	for(int i = 0; i < likeCountsGetSize(counts); i++){
+		if(likeCountsGetSeries(counts, i) == series){
+			return likeCountsGetCount(counts, i);
+		}
+	}
+	return 0;
+}
+
+/* Adds a series to the favorites of a user, as mtmflix does. */
+static bool like(User user, Series series, IdIndex users_by_id){
+	if(userAddFavoriteSeries(user, series) != MTMFLIX_SUCCESS){
+		return false;
+	}
+	userUpdateFollowers(user, series, true, users_by_id);
+	return true;
+}
+
+/* Removes a series from the favorites of a user, as mtmflix does. */
+static void unlike(User user, Series series, IdIndex users_by_id){
+	userRemoveFavoriteSeries(user, series);
+	userUpdateFollowers(user, series, false, users_by_id);
+}
+
+static bool hotUserUnmarkTest(){
+	Slab users_slab = slabCreate(userGetAllocationSize());
+	Slab series_slab = slabCreate(seriesGetAllocationSize());
+	StringPool pool = stringPoolCreate();
+	IdIndex users_by_id = idIndexCreate();
+	ASSERT_TEST(users_slab != NULL && series_slab != NULL && pool != NULL &&
+			users_by_id != NULL);
+	const char* names[HOT_TEST_USERS] = {"Viewer", "First", "Second"};
+	User users[HOT_TEST_USERS];
+	for(int i = 0; i < HOT_TEST_USERS; i++){
+		char* name = stringPoolIntern(pool, names[i]);
+		ASSERT_TEST(name != NULL);
+		users[i] = userCreate(users_slab, name, 30, i);
+		stringPoolRelease(name);
+		ASSERT_TEST(users[i] != NULL);
+		ASSERT_TEST(idIndexPut(users_by_id, i, users[i]) == ID_INDEX_SUCCESS);
+	}
+	Series series[HOT_TEST_SERIES];
+	for(int i = 0; i < HOT_TEST_SERIES; i++){
+		char* name = stringPoolIntern(pool, i ? "Later" : "Early");
+		ASSERT_TEST(name != NULL);
+		series[i] = seriesCreate(series_slab, name, 10, DRAMA, NULL, 30, i);
+		stringPoolRelease(name);
+		ASSERT_TEST(series[i] != NULL);
+	}
+	User viewer = users[0], first = users[1], second = users[2];
+	ASSERT_TEST(userAddFriend(viewer, first) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(userAddFriend(viewer, second) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(like(first, series[0], users_by_id));
+	/* Not hot: no counts are kept. */
+	ASSERT_TEST(userGetFriendLikes(viewer) == NULL);
+	ASSERT_TEST(userSetHot(viewer, true, users_by_id) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(userGetFriendLikes(viewer) != NULL);
+	ASSERT_TEST(countOf(userGetFriendLikes(viewer), series[0]) == 1);
+	/* The counts follow the favorites of the friends. */
+	ASSERT_TEST(like(second, series[0], users_by_id));
+	ASSERT_TEST(countOf(userGetFriendLikes(viewer), series[0]) == 2);
+	/* Unmarked, the counts are dropped, also when unmarked again. */
+	ASSERT_TEST(userSetHot(viewer, false, users_by_id) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(userGetFriendLikes(viewer) == NULL);
+	ASSERT_TEST(userSetHot(viewer, false, users_by_id) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(userGetFriendLikes(viewer) == NULL);
+	/* Changes while he is not hot are not counted anywhere... */
+	unlike(first, series[0], users_by_id);
+	ASSERT_TEST(like(second, series[1], users_by_id));
+	ASSERT_TEST(userGetFriendLikes(viewer) == NULL);
+	/* ...so hot again, he counts the favorites of his friends anew. */
+	ASSERT_TEST(userSetHot(viewer, true, users_by_id) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(countOf(userGetFriendLikes(viewer), series[0]) == 1);
+	ASSERT_TEST(countOf(userGetFriendLikes(viewer), series[1]) == 1);
+	/* Marked again while hot, the counts stay as they are. */
+	ASSERT_TEST(userSetHot(viewer, true, users_by_id) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(countOf(userGetFriendLikes(viewer), series[0]) == 1);
+	ASSERT_TEST(likeCountsGetSize(userGetFriendLikes(viewer)) == 2);
+	for(int i = 0; i < HOT_TEST_USERS; i++){
+		userDestroy(users[i]);
+	}
+	for(int i = 0; i < HOT_TEST_SERIES; i++){
+		seriesDestroy(series[i]);
+	}
+	idIndexDestroy(users_by_id);
+	stringPoolDestroy(pool);
+	slabDestroy(series_slab);
+	slabDestroy(users_slab);
+	return true;
+}
+
+int main(){
+	RUN_TEST(hotUserUnmarkTest);
+	return 0;
+}
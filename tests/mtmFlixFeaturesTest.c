@@ -0,0 +1,697 @@
+#include "test_utilities.h"
+#include "../mtmflix.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+/*
+* Tests of the features that were added on top of the basic functions. Most
+* of them compare what a feature prints with what the basic functions print
+* for the same mtmflix, so they need no expected output files.
+*/
+
+/* Reads everything that was written to a temporary file. */
+static char* readAll(FILE* file){
+	long size = ftell(file);
+	char* text = malloc(size + 1);
+	if(!text){
+		return NULL;
+	}
+	rewind(file);
+	text[fread(text, 1, size, file)] = '\0';
+	return text;
+}
+
+#define FEATURES_TEST_GENRES_NUM (HORROR+1)
+
+/* A small random number generator, so every run builds the same mtmflix. */
+static unsigned int nextRandom(unsigned int* seed){
+	*seed = *seed * 1103515245u + 12345u;
+	return (*seed >> 16) & 0x7fff;
+}
+
+/*
+* Adds random users and series to a mtmflix. Every user loves favoritesNum
+* random series and has friendsNum random friends, and the first user is a
+* friend of everybody, so he has many candidate series.
+*/
+static void addRandomUsersAndSeries(MtmFlix m, int usersNum, int seriesNum,
+		int favoritesNum, int friendsNum, unsigned int seed){
+	char name[32], other[32];
+	for(int i = 0; i < seriesNum; i++){
+		int ages[2] = {MTM_MIN_AGE + (int)nextRandom(&seed) % 20,
+				60 + (int)nextRandom(&seed) % 80};
+		sprintf(name, "Series%d", i);
+		mtmFlixAddSeries(m, name, 1 + nextRandom(&seed) % 50,
+				(Genre)(nextRandom(&seed) % FEATURES_TEST_GENRES_NUM),
+				i % 3 ? ages : NULL, 20 + nextRandom(&seed) % 4);
+	}
+	for(int i = 0; i < usersNum; i++){
+		sprintf(name, "User%d", i);
+		mtmFlixAddUser(m, name, MTM_MIN_AGE + nextRandom(&seed) % 100);
+	}
+	for(int i = 0; i < usersNum; i++){
+		sprintf(name, "User%d", i);
+		for(int j = 0; j < favoritesNum; j++){
+			sprintf(other, "Series%u", nextRandom(&seed) % seriesNum);
+			mtmFlixSeriesJoin(m, name, other);
+		}
+		for(int j = 0; j < friendsNum; j++){
+			sprintf(other, "User%u", nextRandom(&seed) % usersNum);
+			mtmFlixAddFriend(m, name, other);
+		}
+		mtmFlixAddFriend(m, "User0", name);
+	}
+}
+
+/* Builds a mtmflix of random users and series. */
+static MtmFlix createRandomMtmflix(int usersNum, int seriesNum,
+		int favoritesNum, int friendsNum, unsigned int seed){
+	MtmFlix m = mtmFlixCreate();
+	if(m){
+		addRandomUsersAndSeries(m, usersNum, seriesNum, favoritesNum,
+				friendsNum, seed);
+	}
+	return m;
+}
+
+/* Prints the recommendations of the users one after the other, with the
+ * basic function. Returns what was printed. */
+static char* printRecommendations(MtmFlix m, const char** usernames,
+		int usersNum, int count){
+	FILE* file = tmpfile();
+	if(!file){
+		return NULL;
+	}
+	for(int i = 0; i < usersNum; i++){
+		if(mtmFlixGetRecommendations(m, usernames[i], count, file) !=
+				MTMFLIX_SUCCESS){
+			fclose(file);
+			return NULL;
+		}
+	}
+	char* text = readAll(file);
+	fclose(file);
+	return text;
+}
+
+/* Checks that what a function printed to a file is the expected text. */
+static bool isPrinted(FILE* file, const char* expected){
+	char* text = readAll(file);
+	fclose(file);
+	bool equal = text && expected && strcmp(text, expected) == 0;
+	free(text);
+	return equal;
+}
+
+static bool mtmflixAgeLimitsTest(){
+	MtmFlix m = mtmFlixCreate();
+	int teens[2] = {16, 77};
+	int everyone[2] = {3, 180};
+	ASSERT_TEST(mtmFlixAddSeries(m, "Limited", 10, DRAMA, teens, 30) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddSeries(m, "Wide", 10, DRAMA, everyone, 30) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddSeries(m, "Free", 10, DRAMA, NULL, 30) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddUser(m, "Young", 15) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddUser(m, "First", 16) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddUser(m, "Last", 77) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddUser(m, "Old", 78) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddUser(m, "Baby", MTM_MIN_AGE) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddUser(m, "Oldest", MTM_MAX_AGE) == MTMFLIX_SUCCESS);
+	/* The limits themselves are allowed. */
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Young", "Limited") == MTMFLIX_USER_NOT_IN_THE_RIGHT_AGE);
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "First", "Limited") == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Last", "Limited") == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Old", "Limited") == MTMFLIX_USER_NOT_IN_THE_RIGHT_AGE);
+	/* Limits outside of the legal ages allow every legal age. */
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Baby", "Wide") == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Oldest", "Wide") == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Baby", "Free") == MTMFLIX_SUCCESS);
+	/* A series the user may not watch is not recommended to him. The
+	 * users love a drama, so dramas get a rank for them. */
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Young", "Wide") == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Old", "Wide") == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddFriend(m, "Young", "First") == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddFriend(m, "Old", "First") == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddFriend(m, "Last", "First") == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "First", "Free") == MTMFLIX_SUCCESS);
+	const char* users[3] = {"Young", "Old", "Last"};
+	for(int i = 0; i < 3; i++){
+		FILE* file = tmpfile();
+		ASSERT_TEST(file != NULL);
+		ASSERT_TEST(mtmFlixGetRecommendations(m, users[i], 0, file) == MTMFLIX_SUCCESS);
+		char* text = readAll(file);
+		fclose(file);
+		ASSERT_TEST(text != NULL);
+		bool limited = strstr(text, "'Limited'") != NULL;
+		bool free_series = strstr(text, "'Free'") != NULL;
+		free(text);
+		ASSERT_TEST(free_series);
+		/* Only Last is in the ages of Limited, and he already loves it. */
+		ASSERT_TEST(!limited);
+	}
+	mtmFlixDestroy(m);
+	return true;
+}
+
+static bool mtmflixAgeBoundsTest(){
+	MtmFlix m = mtmFlixCreate();
+	ASSERT_TEST(m != NULL);
+	int bounds[2] = {MTM_MIN_AGE, MTM_MAX_AGE};
+	int inside[2] = {MTM_MIN_AGE + 1, MTM_MAX_AGE - 1};
+	int single[2] = {MTM_MIN_AGE, MTM_MIN_AGE};
+	ASSERT_TEST(mtmFlixAddSeries(m, "Bounds", 1, DRAMA, bounds, 30) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddSeries(m, "Inside", 1, DRAMA, inside, 30) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddSeries(m, "Single", 1, DRAMA, single, 30) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddUser(m, "TooYoung", MTM_MIN_AGE - 1) == MTMFLIX_ILLEGAL_AGE);
+	ASSERT_TEST(mtmFlixAddUser(m, "TooOld", MTM_MAX_AGE + 1) == MTMFLIX_ILLEGAL_AGE);
+	ASSERT_TEST(mtmFlixAddUser(m, "Youngest", MTM_MIN_AGE) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddUser(m, "Oldest", MTM_MAX_AGE) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddUser(m, "Almost", MTM_MIN_AGE + 1) == MTMFLIX_SUCCESS);
+	/* Limits at the legal ages allow exactly the legal ages. */
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Youngest", "Bounds") == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Oldest", "Bounds") == MTMFLIX_SUCCESS);
+	/* One year inside of the legal ages leaves out the youngest and the
+	 * oldest users. */
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Youngest", "Inside") == MTMFLIX_USER_NOT_IN_THE_RIGHT_AGE);
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Oldest", "Inside") == MTMFLIX_USER_NOT_IN_THE_RIGHT_AGE);
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Almost", "Inside") == MTMFLIX_SUCCESS);
+	/* Limits of a single age. */
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Youngest", "Single") == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Almost", "Single") == MTMFLIX_USER_NOT_IN_THE_RIGHT_AGE);
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Oldest", "Single") == MTMFLIX_USER_NOT_IN_THE_RIGHT_AGE);
+	mtmFlixDestroy(m);
+	return true;
+}
+
+static bool mtmflixBatchRecommendationsTest(){
+	MtmFlix m = createRandomMtmflix(300, 200, 8, 10, 7);
+	ASSERT_TEST(m != NULL);
+	char names[300][32];
+	const char* usernames[300];
+	for(int i = 0; i < 300; i++){
+		sprintf(names[i], "User%d", (i * 37) % 300);
+		usernames[i] = names[i];
+	}
+	int counts[3] = {0, 1, 4};
+	for(int c = 0; c < 3; c++){
+		char* expected = printRecommendations(m, usernames, 300, counts[c]);
+		ASSERT_TEST(expected != NULL && expected[0] != '\0');
+		FILE* file = tmpfile();
+		ASSERT_TEST(mtmFlixGetRecommendationsBatch(m, usernames, 300,
+				counts[c], file) == MTMFLIX_SUCCESS);
+		ASSERT_TEST(isPrinted(file, expected));
+		/* The output does not depend on the number of threads. */
+		for(int threads = 1; threads <= 8; threads *= 2){
+			file = tmpfile();
+			ASSERT_TEST(mtmFlixGetRecommendationsParallel(m, usernames, 300,
+					counts[c], threads, file) == MTMFLIX_SUCCESS);
+			ASSERT_TEST(isPrinted(file, expected));
+		}
+		free(expected);
+	}
+	/* Nothing is printed when one of the users does not exist. */
+	usernames[150] = "Nobody";
+	FILE* file = tmpfile();
+	ASSERT_TEST(mtmFlixGetRecommendationsBatch(m, usernames, 300, 0, file) ==
+			MTMFLIX_USER_DOES_NOT_EXIST);
+	ASSERT_TEST(mtmFlixGetRecommendationsParallel(m, usernames, 300, 0, 4,
+			file) == MTMFLIX_USER_DOES_NOT_EXIST);
+	ASSERT_TEST(isPrinted(file, ""));
+	mtmFlixDestroy(m);
+	return true;
+}
+
+static bool mtmflixRecommendationsWithThreadsTest(){
+	/* User0 is a friend of everybody, so thousands of series are loved
+	 * by his friends, enough to be split between threads. */
+	MtmFlix m = createRandomMtmflix(400, 3000, 10, 5, 11);
+	ASSERT_TEST(m != NULL);
+	const char* usernames[3] = {"User0", "User1", "User399"};
+	int counts[4] = {0, 1, 3, 50};
+	for(int u = 0; u < 3; u++){
+		for(int c = 0; c < 4; c++){
+			char* expected = printRecommendations(m, usernames + u, 1,
+					counts[c]);
+			ASSERT_TEST(expected != NULL && expected[0] != '\0');
+			for(int threads = 1; threads <= 8; threads++){
+				FILE* file = tmpfile();
+				ASSERT_TEST(mtmFlixGetRecommendationsWithThreads(m,
+						usernames[u], counts[c], threads, file) ==
+						MTMFLIX_SUCCESS);
+				ASSERT_TEST(isPrinted(file, expected));
+			}
+			free(expected);
+		}
+	}
+	FILE* file = tmpfile();
+	ASSERT_TEST(mtmFlixGetRecommendationsWithThreads(m, "User0", 0, 0, file)
+			== MTMFLIX_ILLEGAL_NUMBER);
+	ASSERT_TEST(mtmFlixGetRecommendationsWithThreads(m, "Nobody", 0, 2,
+			file) == MTMFLIX_USER_DOES_NOT_EXIST);
+	fclose(file);
+	mtmFlixDestroy(m);
+	return true;
+}
+
+/* Checks that two mtmflixes print the same recommendations for the first
+ * users, and that they print something. */
+static bool isSameRecommendations(MtmFlix m1, MtmFlix m2, int usersNum){
+	char names[16][32];
+	const char* usernames[16];
+	for(int i = 0; i < usersNum; i++){
+		sprintf(names[i], "User%d", i);
+		usernames[i] = names[i];
+	}
+	char* text1 = printRecommendations(m1, usernames, usersNum, 2);
+	char* text2 = printRecommendations(m2, usernames, usersNum, 2);
+	bool same = text1 && text2 && text1[0] != '\0' &&
+			strcmp(text1, text2) == 0;
+	free(text1);
+	free(text2);
+	return same;
+}
+
+static bool mtmflixRecommendationsCacheTest(){
+	int entries[2] = {2, 100};
+	for(int e = 0; e < 2; e++){
+		MtmFlix cached = createRandomMtmflix(16, 40, 4, 3, 5);
+		MtmFlix plain = createRandomMtmflix(16, 40, 4, 3, 5);
+		ASSERT_TEST(cached != NULL && plain != NULL);
+		ASSERT_TEST(mtmFlixSetRecommendationsCache(cached, entries[e]) ==
+				MTMFLIX_SUCCESS);
+		ASSERT_TEST(isSameRecommendations(cached, plain, 16));
+		/* Printed twice: the second time from the cache. */
+		ASSERT_TEST(isSameRecommendations(cached, plain, 16));
+		/* Every change is made in both, and the cached recommendations
+		 * must follow it. */
+		MtmFlix both[2] = {cached, plain};
+		for(int i = 0; i < 2; i++){
+			mtmFlixSeriesJoin(both[i], "User1", "Series7");
+			mtmFlixSeriesJoin(both[i], "User2", "Series8");
+		}
+		ASSERT_TEST(isSameRecommendations(cached, plain, 16));
+		for(int i = 0; i < 2; i++){
+			mtmFlixSeriesLeave(both[i], "User1", "Series7");
+		}
+		ASSERT_TEST(isSameRecommendations(cached, plain, 16));
+		for(int i = 0; i < 2; i++){
+			mtmFlixAddFriend(both[i], "User3", "User4");
+			mtmFlixAddFriend(both[i], "User5", "User3");
+		}
+		ASSERT_TEST(isSameRecommendations(cached, plain, 16));
+		for(int i = 0; i < 2; i++){
+			mtmFlixRemoveFriend(both[i], "User0", "User2");
+		}
+		ASSERT_TEST(isSameRecommendations(cached, plain, 16));
+		for(int i = 0; i < 2; i++){
+			mtmFlixRemoveSeries(both[i], "Series8");
+			mtmFlixRemoveUser(both[i], "User15");
+		}
+		ASSERT_TEST(isSameRecommendations(cached, plain, 15));
+		/* Turning the cache off drops it. */
+		ASSERT_TEST(mtmFlixSetRecommendationsCache(cached, 0) ==
+				MTMFLIX_SUCCESS);
+		ASSERT_TEST(isSameRecommendations(cached, plain, 15));
+		ASSERT_TEST(mtmFlixSetRecommendationsCache(cached, -1) ==
+				MTMFLIX_ILLEGAL_NUMBER);
+		mtmFlixDestroy(cached);
+		mtmFlixDestroy(plain);
+	}
+	return true;
+}
+
+/* Prints the recommendations of one user to a new string. */
+static char* printUserRecommendations(MtmFlix m, const char* username){
+	return printRecommendations(m, &username, 1, 0);
+}
+
+static bool mtmflixCacheRemovedSeriesTest(){
+	MtmFlix m = mtmFlixCreate();
+	ASSERT_TEST(m != NULL);
+	ASSERT_TEST(mtmFlixSetRecommendationsCache(m, 10) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddSeries(m, "Liked", 1, DRAMA, NULL, 30) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddSeries(m, "Gone", 1, DRAMA, NULL, 30) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddSeries(m, "Kept", 1, DRAMA, NULL, 30) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddUser(m, "Viewer", 30) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddUser(m, "Friend", 30) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddFriend(m, "Viewer", "Friend") == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Viewer", "Liked") == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Friend", "Gone") == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Friend", "Kept") == MTMFLIX_SUCCESS);
+	/* Printed twice, so the second time is from the cache. */
+	for(int i = 0; i < 2; i++){
+		char* text = printUserRecommendations(m, "Viewer");
+		ASSERT_TEST(text != NULL);
+		bool gone = strstr(text, "'Gone'") != NULL;
+		bool kept = strstr(text, "'Kept'") != NULL;
+		free(text);
+		ASSERT_TEST(gone && kept);
+	}
+	/* Nobody that the recommendations depend on changed, only the
+	 * catalogue, and the cached text must not recommend the series. */
+	ASSERT_TEST(mtmFlixRemoveSeries(m, "Gone") == MTMFLIX_SUCCESS);
+	char* text = printUserRecommendations(m, "Viewer");
+	ASSERT_TEST(text != NULL);
+	bool gone = strstr(text, "'Gone'") != NULL;
+	bool kept = strstr(text, "'Kept'") != NULL;
+	free(text);
+	ASSERT_TEST(!gone && kept);
+	mtmFlixDestroy(m);
+	return true;
+}
+
+static bool mtmflixHotUsersTest(){
+	MtmFlix hot = createRandomMtmflix(16, 40, 4, 3, 9);
+	MtmFlix plain = createRandomMtmflix(16, 40, 4, 3, 9);
+	ASSERT_TEST(hot != NULL && plain != NULL);
+	/* User0 is a friend of everybody, so every change touches his counts. */
+	ASSERT_TEST(mtmFlixSetUserHot(hot, "User0", true) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixSetUserHot(hot, "User3", true) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixSetUserHot(hot, "Nobody", true) ==
+			MTMFLIX_USER_DOES_NOT_EXIST);
+	ASSERT_TEST(isSameRecommendations(hot, plain, 16));
+	MtmFlix both[2] = {hot, plain};
+	for(int i = 0; i < 2; i++){
+		mtmFlixSeriesJoin(both[i], "User4", "Series11");
+		mtmFlixSeriesJoin(both[i], "User5", "Series11");
+		mtmFlixSeriesLeave(both[i], "User6", "Series12");
+	}
+	ASSERT_TEST(isSameRecommendations(hot, plain, 16));
+	for(int i = 0; i < 2; i++){
+		mtmFlixAddFriend(both[i], "User3", "User9");
+		mtmFlixRemoveFriend(both[i], "User0", "User4");
+		mtmFlixRemoveFriend(both[i], "User3", "User7");
+	}
+	ASSERT_TEST(isSameRecommendations(hot, plain, 16));
+	/* Removed series and users are taken out of the counts. */
+	for(int i = 0; i < 2; i++){
+		mtmFlixRemoveSeries(both[i], "Series11");
+		mtmFlixRemoveUser(both[i], "User15");
+	}
+	ASSERT_TEST(isSameRecommendations(hot, plain, 15));
+	/* A user that is hot again counts everything from the start. */
+	ASSERT_TEST(mtmFlixSetUserHot(hot, "User0", false) == MTMFLIX_SUCCESS);
+	for(int i = 0; i < 2; i++){
+		mtmFlixSeriesJoin(both[i], "User8", "Series13");
+	}
+	ASSERT_TEST(mtmFlixSetUserHot(hot, "User0", true) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(isSameRecommendations(hot, plain, 15));
+	mtmFlixDestroy(hot);
+	mtmFlixDestroy(plain);
+	return true;
+}
+
+static bool mtmflixParallelUsersReportTest(){
+	/* Several shards of users, and users without friends or series. */
+	MtmFlix m = createRandomMtmflix(1000, 300, 6, 8, 13);
+	ASSERT_TEST(m != NULL);
+	ASSERT_TEST(mtmFlixAddUser(m, "Alone", 30) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddUser(m, "Zed", 40) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddFriend(m, "Zed", "Alone") == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddFriend(m, "Zed", "User7") == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Zed", "Series5") == MTMFLIX_SUCCESS);
+	FILE* file = tmpfile();
+	ASSERT_TEST(file != NULL);
+	ASSERT_TEST(mtmFlixReportUsers(m, file) == MTMFLIX_SUCCESS);
+	char* expected = readAll(file);
+	fclose(file);
+	ASSERT_TEST(expected != NULL);
+	for(int threads = 1; threads <= 8; threads++){
+		file = tmpfile();
+		ASSERT_TEST(mtmFlixReportUsersParallel(m, threads, file) ==
+				MTMFLIX_SUCCESS);
+		ASSERT_TEST(isPrinted(file, expected));
+	}
+	free(expected);
+	/* The details of one user, exactly as they are printed, and not only
+	 * as the basic function prints them. */
+	file = tmpfile();
+	ASSERT_TEST(mtmFlixReportUsersParallel(m, 4, file) == MTMFLIX_SUCCESS);
+	char* text = readAll(file);
+	fclose(file);
+	ASSERT_TEST(text != NULL);
+	bool found = strstr(text,
+			"~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n"
+			"The user Zed is 40 years old\n"
+			"Friend: Alone\n"
+			"Friend: User7\n"
+			"Series: Series5\n") != NULL;
+	free(text);
+	ASSERT_TEST(found);
+	file = tmpfile();
+	ASSERT_TEST(mtmFlixReportUsersParallel(m, 0, file) ==
+			MTMFLIX_ILLEGAL_NUMBER);
+	fclose(file);
+	mtmFlixDestroy(m);
+	return true;
+}
+
+/* Writes the first size bytes of a text to a new temporary file, and
+ * rewinds it. */
+static FILE* writeTemporary(const char* text, long size){
+	FILE* file = tmpfile();
+	if(file && (fwrite(text, 1, size, file) != (size_t)size ||
+			fseek(file, 0, SEEK_SET) != 0)){
+		fclose(file);
+		return NULL;
+	}
+	return file;
+}
+
+/* Prints the reports of a mtmflix, one after the other. */
+static char* printReports(MtmFlix m){
+	FILE* file = tmpfile();
+	if(!file){
+		return NULL;
+	}
+	if(mtmFlixReportUsers(m, file) != MTMFLIX_SUCCESS ||
+			mtmFlixReportSeries(m, 0, file) != MTMFLIX_SUCCESS ||
+			mtmFlixReportSeries(m, 2, file) != MTMFLIX_SUCCESS){
+		fclose(file);
+		return NULL;
+	}
+	char* text = readAll(file);
+	fclose(file);
+	return text;
+}
+
+static bool mtmflixSnapshotTest(){
+	MtmFlix m = createRandomMtmflix(400, 150, 5, 6, 17);
+	ASSERT_TEST(m != NULL);
+	ASSERT_TEST(mtmFlixAddUser(m, "Alone", 30) == MTMFLIX_SUCCESS);
+	FILE* file = tmpfile();
+	ASSERT_TEST(file != NULL);
+	ASSERT_TEST(mtmFlixSaveSnapshot(m, file) == MTMFLIX_SUCCESS);
+	char* image = readAll(file);
+	long size = ftell(file);
+	ASSERT_TEST(image != NULL && size > 16);
+	/* A loaded mtmflix reports and recommends like the one that was
+	 * saved. */
+	rewind(file);
+	MtmFlix loaded = NULL;
+	ASSERT_TEST(mtmFlixLoadSnapshot(file, &loaded) == MTMFLIX_SUCCESS);
+	fclose(file);
+	char* expected = printReports(m);
+	char* reports = printReports(loaded);
+	ASSERT_TEST(expected != NULL && reports != NULL);
+	ASSERT_TEST(strcmp(expected, reports) == 0);
+	ASSERT_TEST(isSameRecommendations(m, loaded, 16));
+	free(expected);
+	free(reports);
+	mtmFlixDestroy(loaded);
+	/* Short snapshots, and a header with too many users for the file. */
+	long sizes[3] = {3, 16, size - 1};
+	for(int i = 0; i < 3; i++){
+		file = writeTemporary(image, sizes[i]);
+		ASSERT_TEST(file != NULL);
+		ASSERT_TEST(mtmFlixLoadSnapshot(file, &loaded) ==
+				MTMFLIX_CANNOT_OPEN_FILE);
+		fclose(file);
+	}
+	memset(image + 12, 0xff, 4);
+	file = writeTemporary(image, size);
+	ASSERT_TEST(file != NULL);
+	ASSERT_TEST(mtmFlixLoadSnapshot(file, &loaded) ==
+			MTMFLIX_CANNOT_OPEN_FILE);
+	fclose(file);
+	free(image);
+	mtmFlixDestroy(m);
+	return true;
+}
+
+#define JOURNAL_TEST_PATH "mtmflixJournalTest"
+
+/* Removes the files of the journaled mtmflix of the tests. */
+static void removeJournalFiles(){
+	char name[64];
+	remove(JOURNAL_TEST_PATH ".checkpoint");
+	remove(JOURNAL_TEST_PATH ".checkpoint.tmp");
+	for(int i = 0; i < 100; i++){
+		sprintf(name, "%s.journal.%d", JOURNAL_TEST_PATH, i);
+		remove(name);
+	}
+}
+
+/* Removes some of the users, series, favorites and friends that
+ * addRandomUsersAndSeries added. */
+static void removeSome(MtmFlix m, int usersNum, int seriesNum){
+	char name[32], other[32];
+	for(int i = 1; i < usersNum; i += 7){
+		sprintf(name, "User%d", i);
+		sprintf(other, "User%d", (i + 1) % usersNum);
+		mtmFlixRemoveFriend(m, name, other);
+		mtmFlixRemoveFriend(m, "User0", other);
+		sprintf(other, "Series%d", i % seriesNum);
+		mtmFlixSeriesLeave(m, name, other);
+	}
+	for(int i = 5; i < usersNum; i += 11){
+		sprintf(name, "User%d", i);
+		mtmFlixRemoveUser(m, name);
+	}
+	for(int i = 3; i < seriesNum; i += 13){
+		sprintf(name, "Series%d", i);
+		mtmFlixRemoveSeries(m, name);
+	}
+}
+
+/* Checks that two mtmflixes print the same reports. */
+static bool isSameReports(MtmFlix m1, MtmFlix m2){
+	char* text1 = printReports(m1);
+	char* text2 = printReports(m2);
+	bool same = text1 && text2 && strcmp(text1, text2) == 0;
+	free(text1);
+	free(text2);
+	return same;
+}
+
+static bool mtmflixJournalReopenTest(){
+	removeJournalFiles();
+	MtmFlix plain = mtmFlixCreate();
+	MtmFlix m = NULL;
+	ASSERT_TEST(plain != NULL);
+	ASSERT_TEST(mtmFlixOpenJournaled(JOURNAL_TEST_PATH, 7, 0, &m) ==
+			MTMFLIX_SUCCESS);
+	for(int i = 0; i < 2; i++){
+		addRandomUsersAndSeries(m, 200, 80, 4, 5, 19 + i);
+		addRandomUsersAndSeries(plain, 200, 80, 4, 5, 19 + i);
+	}
+	removeSome(m, 200, 80);
+	removeSome(plain, 200, 80);
+	/* The changes that were not committed yet are committed on destroy,
+	 * and all of them are made again on reopen. */
+	mtmFlixDestroy(m);
+	m = NULL;
+	ASSERT_TEST(mtmFlixOpenJournaled(JOURNAL_TEST_PATH, 7, 0, &m) ==
+			MTMFLIX_SUCCESS);
+	ASSERT_TEST(isSameReports(m, plain));
+	ASSERT_TEST(isSameRecommendations(m, plain, 5));
+	/* Changes after a checkpoint, and with checkpoints on the way. */
+	ASSERT_TEST(mtmFlixCheckpoint(m) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddUser(m, "Late", 30) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixAddUser(plain, "Late", 30) == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixSeriesJoin(m, "Late", "Series1") == MTMFLIX_SUCCESS);
+	ASSERT_TEST(mtmFlixSeriesJoin(plain, "Late", "Series1") ==
+			MTMFLIX_SUCCESS);
+	mtmFlixDestroy(m);
+	m = NULL;
+	ASSERT_TEST(mtmFlixOpenJournaled(JOURNAL_TEST_PATH, 3, 50, &m) ==
+			MTMFLIX_SUCCESS);
+	ASSERT_TEST(isSameReports(m, plain));
+	removeSome(m, 200, 80);
+	removeSome(plain, 200, 80);
+	addRandomUsersAndSeries(m, 100, 80, 3, 3, 23);
+	addRandomUsersAndSeries(plain, 100, 80, 3, 3, 23);
+	mtmFlixDestroy(m);
+	m = NULL;
+	ASSERT_TEST(mtmFlixOpenJournaled(JOURNAL_TEST_PATH, 1, 0, &m) ==
+			MTMFLIX_SUCCESS);
+	ASSERT_TEST(isSameReports(m, plain));
+	ASSERT_TEST(isSameRecommendations(m, plain, 5));
+	mtmFlixDestroy(m);
+	mtmFlixDestroy(plain);
+	removeJournalFiles();
+	return true;
+}
+
+/* Rewrites the journal of the first checkpoint of the tests without its
+ * last bytes, or with a byte changed. */
+static bool damageJournal(long cut, long changed){
+	FILE* file = fopen(JOURNAL_TEST_PATH ".journal.1", "rb");
+	if(!file || fseek(file, 0, SEEK_END) != 0){
+		return false;
+	}
+	char* text = readAll(file);
+	long size = ftell(file);
+	fclose(file);
+	if(!text){
+		return false;
+	}
+	if(changed >= 0){
+		text[changed] ^= 0x55;
+	}
+	file = fopen(JOURNAL_TEST_PATH ".journal.1", "wb");
+	bool written = file && fwrite(text, 1, size - cut, file) ==
+			(size_t)(size - cut);
+	free(text);
+	return file && fclose(file) == 0 && written;
+}
+
+static bool mtmflixJournalDamagedTest(){
+	/* A new journaled mtmflix writes its first checkpoint, so its journal
+	 * is the one of generation 1. */
+	char name[32];
+	for(int damage = 0; damage < 2; damage++){
+		removeJournalFiles();
+		MtmFlix m = NULL;
+		ASSERT_TEST(mtmFlixOpenJournaled(JOURNAL_TEST_PATH, 1, 0, &m) ==
+				MTMFLIX_SUCCESS);
+		ASSERT_TEST(mtmFlixAddSeries(m, "Show", 8, DRAMA, NULL, 30) ==
+				MTMFLIX_SUCCESS);
+		for(int i = 0; i < 10; i++){
+			sprintf(name, "User%d", i);
+			ASSERT_TEST(mtmFlixAddUser(m, name, 20 + i) == MTMFLIX_SUCCESS);
+		}
+		mtmFlixDestroy(m);
+		m = NULL;
+		if(damage == 0){
+			/* The last record was cut while it was written, so only the
+			 * user it adds is lost. */
+			ASSERT_TEST(damageJournal(3, -1));
+			ASSERT_TEST(mtmFlixOpenJournaled(JOURNAL_TEST_PATH, 1, 0, &m) ==
+					MTMFLIX_SUCCESS);
+			MtmFlix plain = mtmFlixCreate();
+			ASSERT_TEST(plain != NULL);
+			mtmFlixAddSeries(plain, "Show", 8, DRAMA, NULL, 30);
+			for(int i = 0; i < 9; i++){
+				sprintf(name, "User%d", i);
+				mtmFlixAddUser(plain, name, 20 + i);
+			}
+			ASSERT_TEST(isSameReports(m, plain));
+			mtmFlixDestroy(plain);
+			mtmFlixDestroy(m);
+		} else {
+			/* A damaged record with records after it is not a cut. */
+			ASSERT_TEST(damageJournal(0, 12));
+			ASSERT_TEST(mtmFlixOpenJournaled(JOURNAL_TEST_PATH, 1, 0, &m) ==
+					MTMFLIX_CANNOT_OPEN_FILE);
+		}
+	}
+	removeJournalFiles();
+	return true;
+}
+
+int main(){
+	RUN_TEST(mtmflixAgeLimitsTest);
+	RUN_TEST(mtmflixAgeBoundsTest);
+	RUN_TEST(mtmflixBatchRecommendationsTest);
+	RUN_TEST(mtmflixRecommendationsWithThreadsTest);
+	RUN_TEST(mtmflixRecommendationsCacheTest);
+	RUN_TEST(mtmflixCacheRemovedSeriesTest);
+	RUN_TEST(mtmflixHotUsersTest);
+	RUN_TEST(mtmflixParallelUsersReportTest);
+	RUN_TEST(mtmflixSnapshotTest);
+	RUN_TEST(mtmflixJournalReopenTest);
+	RUN_TEST(mtmflixJournalDamagedTest);
+	return 0;
+}
@@ -0,0 +1,77 @@
+#include "test_utilities.h"
+#include "../slab.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+* Unit tests of the slab allocator: objects that are freed are given again
+* before any new block is allocated, so users and series that are added and
+* removed many times keep using the same memory.
+*/
+
+#define SLAB_TEST_OBJECTS 300
+
+static bool isOneOf(void* object, void** objects, int size){
+	for(int i = 0; i < size; i++){
+		if(objects[i] == object){
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool slabReusesFreedObjectsTest(){
+	Slab slab = slabCreate(40);
+	ASSERT_TEST(slab != NULL);
+	void* objects[SLAB_TEST_OBJECTS];
+	for(int i = 0; i < SLAB_TEST_OBJECTS; i++){
+		objects[i] = slabAlloc(slab);
+		ASSERT_TEST(objects[i] != NULL);
+		ASSERT_TEST(!isOneOf(objects[i], objects, i));
+	}
+	for(int round = 0; round < 10; round++){
+		for(int i = 0; i < SLAB_TEST_OBJECTS; i++){
+			slabFree(slab, objects[i]);
+		}
+		/* Every object of the next round is one that was freed. */
+		void* again[SLAB_TEST_OBJECTS];
+		for(int i = 0; i < SLAB_TEST_OBJECTS; i++){
+			again[i] = slabAlloc(slab);
+			ASSERT_TEST(isOneOf(again[i], objects, SLAB_TEST_OBJECTS));
+			ASSERT_TEST(!isOneOf(again[i], again, i));
+		}
+		for(int i = 0; i < SLAB_TEST_OBJECTS; i++){
+			objects[i] = again[i];
+		}
+	}
+	slabDestroy(slab);
+	return true;
+}
+
+static bool slabAlignsObjectsTest(){
+	Slab slab = slabCreate(3);
+	ASSERT_TEST(slab != NULL);
+	for(int i = 0; i < SLAB_TEST_OBJECTS; i++){
+		void* object = slabAlloc(slab);
+		ASSERT_TEST(object != NULL);
+		ASSERT_TEST((uintptr_t)object % sizeof(long long) == 0);
+	}
+	slabDestroy(slab);
+	return true;
+}
+
+static bool slabArgumentsTest(){
+	ASSERT_TEST(slabCreate(0) == NULL);
+	ASSERT_TEST(slabAlloc(NULL) == NULL);
+	slabDestroy(NULL);
+	return true;
+}
+
+int main(){
+	RUN_TEST(slabReusesFreedObjectsTest);
+	RUN_TEST(slabAlignsObjectsTest);
+	RUN_TEST(slabArgumentsTest);
+	return 0;
+}
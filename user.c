@@ -1,4 +1,5 @@
 #include <malloc.h>
+#include <stdlib.h>
 #include <assert.h>
 #include <string.h>
 #include "user.h"
@@ -9,25 +10,44 @@
 //                USER: STATIC FUNCTIONS DECLARATIONS                    //
 //-----------------------------------------------------------------------//
 
-static void userRemoveFromList(List list,char *name);
+static UserResult userAddFriendsNames(User user, IdIndex users_by_id,
+                                      List names);
 
-static MtmFlixResult addNameToAList(List list, char *name);
+static UserResult userAddFavoriteSeriesNames(User user, List names);
 
-static bool friendLikedTheSeries(Set users_set, char *friend_name,
-                                 char *series_name);
+static int userCompareNames(const void* name1, const void* name2);
+
+static void userCountFriendLikes(User user, User friend);
+
+static void userUncountFriendLikes(User user, User friend);
+
+static void userStopBeingHot(User user);
 
-static bool checkIfUserLikedSeries (List favorite_series_list,
-                                    char* series_name);
 
 //-----------------------------------------------------------------------//
 //                        USER: STRUCT                                   //
 //-----------------------------------------------------------------------//
 
 struct user_t{
+    Slab slab; // The slab the user was allocated from.
     char* username;
     int age;
-    List user_friends_list;
-    List user_favorite_series;
+    unsigned int id; // Unique in the mtmflix, never reused.
+    IdArray friend_ids; // Ids of the friends, sorted.
+    IdArray friended_by; // Ids of the users that have him as a friend.
+    OrderedArray favorite_series; // Series sorted by name, not owned.
+    NameIndex favorite_series_index; // Their names, for O(1) lookup.
+    /* Statistics of the favorite series, kept up to date by
+     * userAddFavoriteSeries and userRemoveFavoriteSeries. */
+    int genre_count[NUMBER_OF_GENRES];
+    int favorites_duration_sum;
+    int favorites_count;
+    /* Changed whenever his recommendations may change: when his favorite
+     * series or his friends change, or when a friend's favorites change. */
+    unsigned int recommendations_version;
+    /* Only for hot users: how many friends love each series, kept up to
+     * date as friends and their favorites change. NULL otherwise. */
+    LikeCounts friend_likes;
 };
 
 
@@ -35,57 +55,70 @@ struct user_t{
 //                       USER: FUNCTIONS                                 //
 //-----------------------------------------------------------------------//
 
-/** Rows: 25
+/** Rows: 37
  ***** Function: userCreate *****
  * Description: Creates a new user.
  *
- * @param username - String with the user's name.
+ * @param slab - Slab of users to allocate the user from.
+ * @param username - String with the user's name. Must be interned in the
+ * string pool of the mtmflix, the user takes its own reference to it.
  * @param age - Age of the user.
+ * @param id - Id of the user. Must be unique in the mtmflix.
  *
  * @return
  * A pointer to a new user or NULL in case of memory error or illegal age.
  */
-User userCreate(const char* username, int age){
-    User new_user = malloc(sizeof(*new_user));
+User userCreate(Slab slab, char* username, int age, unsigned int id){
+    User new_user = slabAlloc(slab);
     if(!new_user){
         /* User memory allocation failed */
         return NULL;
     }
-    char* username_copy=malloc(strlen(username)+1);
-    if(!username_copy){
-        /* Username memory allocation failed */
-        userDestroy(new_user);
-        return NULL;
-    }
-    strcpy(username_copy,username);
-    List friend_list=listCreate(copyFriendUsername,destroyFriendUsername);
-    if(!friend_list){
-        /* Friend list creation failed */
-        free(username_copy);
-        userDestroy(new_user);
+    IdArray friend_ids=idArrayCreate();
+    IdArray friended_by=idArrayCreate();
+    if(!friend_ids || !friended_by){
+        /* Friend ids creation failed */
+        idArrayDestroy(friend_ids);
+        idArrayDestroy(friended_by);
+        slabFree(slab,new_user);
         return NULL;
     }
-    List favorite_series_list = listCreate(copyFavoriteSeriesName,
-                                           destroyFavoriteSeriesName);
-    if(!favorite_series_list){
-        /* User favorite series list creation failed */
-        free(username_copy);
-        listDestroy(friend_list);
-        userDestroy(new_user);
+    OrderedArray favorite_series = orderedArrayCreate(
+            seriesCompareNamesOrderedArrayElements);
+    NameIndex favorite_series_index=nameIndexCreate(
+            favoriteSeriesGetNameIndexKey,
+            favoriteSeriesDestroyNameIndexElement);
+    if(!favorite_series || !favorite_series_index){
+        /* User favorite series creation failed */
+        orderedArrayDestroy(favorite_series);
+        nameIndexDestroy(favorite_series_index);
+        idArrayDestroy(friend_ids);
+        idArrayDestroy(friended_by);
+        slabFree(slab,new_user);
         return NULL;
     }
-    new_user->username=username_copy;
+    new_user->slab=slab;
+    new_user->username=stringPoolRetain(username);
     new_user->age=age;
-    new_user->user_friends_list=friend_list;
-    new_user->user_favorite_series=favorite_series_list;
-
+    new_user->id=id;
+    new_user->friend_ids=friend_ids;
+    new_user->friended_by=friended_by;
+    new_user->favorite_series=favorite_series;
+    new_user->favorite_series_index=favorite_series_index;
+    for(int genre=0;genre<NUMBER_OF_GENRES;genre++){
+        new_user->genre_count[genre]=0;
+    }
+    new_user->favorites_duration_sum=0;
+    new_user->favorites_count=0;
+    new_user->recommendations_version=0;
+    new_user->friend_likes=NULL;
     return new_user;
 }
 
 
-/** Rows: 15
+/** Rows: 47
  ***** Function: userCopy *****
- * Description: Copies a given user.
+ * Description: Copies a given user from the same slab.
  *
  * @param user - A user to copy.
  *
@@ -94,31 +127,65 @@ User userCreate(const char* username, int age){
  */
 User userCopy (User user){
     assert(user);
-    User new_user=userCreate(user->username,user->age);
+    User new_user=userCreate(user->slab,user->username,user->age,
+                             user->id);
     if(!new_user){
         /* User creation failed */
         return NULL;
     }
-    /* User create has created an extra of the lists.*/
-    listDestroy(new_user->user_favorite_series);
-    listDestroy(new_user->user_friends_list);
-    new_user->user_friends_list=listCopy(user->user_friends_list);
-    if(!new_user->user_friends_list){
-        /* List copying failed */
-        free(new_user->username);
+    /* User create has created empty lists, they are replaced with copies
+     * of the given user's lists. */
+    IdArray friend_ids_copy=idArrayCopy(user->friend_ids);
+    if(!friend_ids_copy){
+        /* Ids copying failed */
+        userDestroy(new_user);
         return NULL;
     }
-    new_user->user_favorite_series=listCopy(user->user_favorite_series);
-    if(!new_user->user_favorite_series){
-        /* List copying failed */
-        free(new_user->username);
-        listDestroy(new_user->user_friends_list);
+    idArrayDestroy(new_user->friend_ids);
+    new_user->friend_ids=friend_ids_copy;
+    IdArray friended_by_copy=idArrayCopy(user->friended_by);
+    if(!friended_by_copy){
+        /* Ids copying failed */
+        userDestroy(new_user);
         return NULL;
     }
+    idArrayDestroy(new_user->friended_by);
+    new_user->friended_by=friended_by_copy;
+    for(int i=0;i<orderedArrayGetSize(user->favorite_series);i++){
+        Series series=orderedArrayGet(user->favorite_series,i);
+        char* name=stringPoolRetain((char*)seriesGetName(series));
+        if(nameIndexInsert(new_user->favorite_series_index,name)!=
+           NAME_INDEX_SUCCESS){
+            /* Index insertion failed */
+            stringPoolRelease(name);
+            userDestroy(new_user);
+            return NULL;
+        }
+        if(orderedArrayInsert(new_user->favorite_series,series)!=
+           ORDERED_ARRAY_SUCCESS){
+            /* Array insertion failed */
+            userDestroy(new_user);
+            return NULL;
+        }
+    }
+    for(int genre=0;genre<NUMBER_OF_GENRES;genre++){
+        new_user->genre_count[genre]=user->genre_count[genre];
+    }
+    new_user->favorites_duration_sum=user->favorites_duration_sum;
+    new_user->favorites_count=user->favorites_count;
+    new_user->recommendations_version=user->recommendations_version;
+    if(user->friend_likes){
+        new_user->friend_likes=likeCountsCopy(user->friend_likes);
+        if(!new_user->friend_likes){
+            /* Counts copying failed */
+            userDestroy(new_user);
+            return NULL;
+        }
+    }
     return new_user;
 }
 
-/** Rows: 6
+/** Rows: 9
  ***** Function: userDestroy *****
  * Description: Deallocates an existing user.
  *
@@ -128,10 +195,13 @@ void userDestroy (User user){
     if(!user){
         return;
     }
-    free((user->username));
-    listDestroy(user->user_friends_list);
-    listDestroy(user->user_favorite_series);
-    free(user);
+    stringPoolRelease(user->username);
+    idArrayDestroy(user->friend_ids);
+    idArrayDestroy(user->friended_by);
+    orderedArrayDestroy(user->favorite_series);
+    nameIndexDestroy(user->favorite_series_index);
+    likeCountsDestroy(user->friend_likes);
+    slabFree(user->slab,user);
 }
 
 /** Rows: 1
@@ -152,105 +222,468 @@ int userCompare (User user1, User user2){
     return strcmp(user1->username,user2->username);
 }
 
-/** Rows: 5
+/** Rows: 2
+ ***** Function: userGetUsername *****
+ * Description: Returns the username of a given user. The name is not
+ * copied, it belongs to the user and should not be freed. The name is
+ * interned, so it can be compared to other interned names by pointer.
+ *
+ * @param user - User to get its name.
+ *
+ * @return
+ * Username of given user.
+ */
+const char* userGetUsername(User user){
+    assert(user);
+    return user->username;
+}
+
+/** Rows: 2
+ ***** Function: userGetId *****
+ * Description: Returns the id of a given user.
+ *
+ * @param user - User to get its id.
+ *
+ * @return
+ * Id of given user.
+ */
+unsigned int userGetId(User user){
+    assert(user);
+    return user->id;
+}
+
+/** Rows: 3
+ ***** Function: userFindByName *****
+ * Description: Returns the user with the given username. The lookup does
+ * not allocate memory.
+ *
+ * @param users_index - Index of all the users in the mtmflix.
+ * @param username - Name of the user we look for.
+ *
+ * @return
+ * The user with the given name or NULL if it doesn't exist.
+ */
+User userFindByName(NameIndex users_index, const char* username){
+    assert(users_index);
+    assert(username);
+    return nameIndexFind(users_index,username);
+}
+
+/** Rows: 2
  ***** Function: usernameCopy *****
- * Description: Copying a friend's name.
+ * Description: Copying a friend's name. The name is interned, so it is not
+ * duplicated, only another reference to it is taken.
  *
- * @param username - A friend's name to copy.
+ * @param username - A friend's interned name to copy.
  *
  * @return
- * A copy of the given friend's name.
+ * The same interned name.
  */
 char* usernameCopy(char* username){
     assert(username);
-    char* username_copy=malloc(strlen(username)+1);
-    if(!username_copy){
-        /* Memory allocation failed */
-        return NULL;
-    }
-    strcpy(username_copy,username);
-    return username_copy;
+    return stringPoolRetain(username);
 }
 
 /** Rows: 1
  ***** Function: destroyUsername *****
- * Description: Deallocates the memory used for a friend's name.
+ * Description: Releases a reference to a friend's interned name.
  *
  * @param user - A friend's name to destroy.
  */
 void destroyUsername (char* friend_username){
-    free(friend_username);
+    stringPoolRelease(friend_username);
 }
 
-/** Rows: 3
- ***** Function: removeFromList *****
- * Description: Removes the given name from the specified list of given
- * user.
+/** Rows: 16
+ ***** Function: userAddFriend *****
+ * Description: Adds a user to the friends of a given user. The friend
+ * also remembers who added him, so removing him later does not need to
+ * go over all the users. Takes O(log n) to find the places of the ids.
+ * If the user is hot, the favorite series of the friend are counted.
+ *
+ * @param user - User we want to add a friend to.
+ * @param friend - The new friend.
+ *
+ * @return
+ * MTMFLIX_SUCCESS - Friend added (or already was a friend).
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ */
+MtmFlixResult userAddFriend(User user, User friend){
+    assert(user);
+    assert(friend);
+    IdArrayResult result=idArrayInsert(user->friend_ids,friend->id);
+    if(result==ID_ARRAY_ALREADY_EXISTS){
+        return MTMFLIX_SUCCESS;
+    }
+    if(result!=ID_ARRAY_SUCCESS){
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    if(idArrayInsert(friend->friended_by,user->id)!=ID_ARRAY_SUCCESS){
+        idArrayRemove(user->friend_ids,friend->id);
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    user->recommendations_version++;
+    userCountFriendLikes(user,friend);
+    return MTMFLIX_SUCCESS;
+}
+
+/** Rows: 7
+ ***** Function: userRemoveFriend *****
+ * Description: Removes a user from the friends of a given user (if he is
+ * there). If the user is hot, the favorite series of the friend are not
+ * counted anymore.
+ *
+ * @param user - User we want to remove a friend from.
+ * @param friend - The friend to remove.
+ */
+void userRemoveFriend(User user, User friend){
+    assert(user);
+    assert(friend);
+    if(idArrayRemove(user->friend_ids,friend->id)==ID_ARRAY_SUCCESS){
+        user->recommendations_version++;
+        userUncountFriendLikes(user,friend);
+    }
+    idArrayRemove(friend->friended_by,user->id);
+}
+
+/** Rows: 16
+ ***** Function: userRemoveAllFriendships *****
+ * Description: Removes a given user from the friends of every user that
+ * has him as a friend, and removes all of his own friends. Only the users
+ * that are connected to him are visited. Used before the user is removed
+ * from the mtmflix.
  *
- * @param user - User we want to remove from one of his list.
- * @param name - Name to remove from list.
- * @param list_type - Which of given user's lists to remove from.
+ * @param user - User that is being removed.
+ * @param users_by_id - Index of all the users in mtmflix by their ids.
  */
-void removeFromList(User user,char* name,UserList list_type){
+void userRemoveAllFriendships(User user, IdIndex users_by_id){
     assert(user);
-    assert(name);
-    if(list_type==FRIENDS_LIST){
-        userRemoveFromList(user->user_friends_list,name);
+    /* Each removal takes the last id out of the array, so no ids are
+     * moved and the array is emptied from its end. */
+    while(idArrayGetSize(user->friended_by)>0){
+        int last=idArrayGetSize(user->friended_by)-1;
+        User follower=idIndexGet(users_by_id,
+                                 idArrayGet(user->friended_by,last));
+        assert(follower);
+        userRemoveFriend(follower,user);
     }
-    else{
-        userRemoveFromList(user->user_favorite_series,name);
+    while(idArrayGetSize(user->friend_ids)>0){
+        int last=idArrayGetSize(user->friend_ids)-1;
+        User friend=idIndexGet(users_by_id,idArrayGet(user->friend_ids,last));
+        assert(friend);
+        userRemoveFriend(user,friend);
     }
 }
 
-/** Rows: 5
- ***** Function: addNameToUsersList *****
- * Description: Adds a given name to a specified list of a given user.
+/** Rows: 2
+ ***** Function: userGetFriendIds *****
+ * Description: Returns the ids of the friends of a given user. The array
+ * belongs to the user and should not be changed or freed.
+ *
+ * @param user - User to get his friends' ids.
+ *
+ * @return
+ * Sorted array of the friends' ids.
+ */
+IdArray userGetFriendIds(User user){
+    assert(user);
+    return user->friend_ids;
+}
+
+/** Rows: 2
+ ***** Function: userGetRecommendationsVersion *****
+ * Description: Returns the version of the recommendations of a given
+ * user. Recommendations that were made in the same version are still
+ * correct.
+ *
+ * @param user - User to get his version.
+ *
+ * @return
+ * Version of the user's recommendations.
+ */
+unsigned int userGetRecommendationsVersion(User user){
+    assert(user);
+    return user->recommendations_version;
+}
+
+/** Rows: 19
+ ***** Function: userUpdateFollowers *****
+ * Description: Updates the users that have the given user as a friend,
+ * after a series was added to or removed from his favorite series: their
+ * recommendations version is changed, since they rank his favorite
+ * series, and the hot ones count the series again. A hot follower whose
+ * counts could not grow stops being hot.
+ *
+ * @param user - User whose favorite series changed.
+ * @param series - The series that was added or removed.
+ * @param liked - True if the series was added, false if it was removed.
+ * @param users_by_id - Index of all the users in mtmflix by their ids.
+ */
+void userUpdateFollowers(User user, Series series, bool liked,
+                         IdIndex users_by_id){
+    assert(user);
+    assert(series);
+    for(int i=0;i<idArrayGetSize(user->friended_by);i++){
+        User follower=idIndexGet(users_by_id,
+                                 idArrayGet(user->friended_by,i));
+        assert(follower);
+        follower->recommendations_version++;
+        if(!follower->friend_likes){
+            continue;
+        }
+        if(!liked){
+            likeCountsDecrease(follower->friend_likes,series);
+        } else if(likeCountsIncrease(follower->friend_likes,series)!=
+                  LIKE_COUNTS_SUCCESS){
+            userStopBeingHot(follower);
+        }
+    }
+}
+
+/** Rows: 22
+ ***** Function: userSetHot *****
+ * Description: Makes a user hot or not. A hot user keeps how many of his
+ * friends love each series, so they are not counted for every
+ * recommendation. Making a user hot counts the favorite series of all of
+ * his friends.
+ *
+ * @param user - User to change.
+ * @param hot - Whether the user should be hot.
+ * @param users_by_id - Index of all the users in mtmflix by their ids.
  *
- * @param user - User we want to add to one of his lists.
- * @param name - Name we want to add to list.
- * @param list_type - Which of given user's lists to add to.
  * @return
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error. The user is not hot.
+ * MTMFLIX_SUCCESS - User changed.
  */
-MtmFlixResult addNameToUsersList(User user,char *name,UserList list_type){
+MtmFlixResult userSetHot(User user, bool hot, IdIndex users_by_id){
     assert(user);
-    assert(name);
-    MtmFlixResult result;
-    if(list_type==FRIENDS_LIST){
-        result= addNameToAList(user->user_friends_list, name);
+    if(!hot){
+        userStopBeingHot(user);
+        return MTMFLIX_SUCCESS;
+    }
+    if(user->friend_likes){
+        /* Already hot, the counts are up to date. */
+        return MTMFLIX_SUCCESS;
+    }
+    user->friend_likes=likeCountsCreate();
+    if(!user->friend_likes){
+        return MTMFLIX_OUT_OF_MEMORY;
     }
-    else{
-        result= addNameToAList(user->user_favorite_series, name);
+    for(int i=0;i<idArrayGetSize(user->friend_ids) && user->friend_likes;
+        i++){
+        User friend=idIndexGet(users_by_id,idArrayGet(user->friend_ids,i));
+        assert(friend);
+        userCountFriendLikes(user,friend);
     }
-    return result;
+    return user->friend_likes ? MTMFLIX_SUCCESS : MTMFLIX_OUT_OF_MEMORY;
 }
 
+/** Rows: 2
+ ***** Function: userGetFriendLikes *****
+ * Description: Returns how many friends of a hot user love each series.
+ * The counts belong to the user and should not be changed or freed.
+ *
+ * @param user - User to get his counts.
+ *
+ * @return
+ * The counts of the series loved by his friends, or NULL if the user is
+ * not hot.
+ */
+LikeCounts userGetFriendLikes(User user){
+    assert(user);
+    return user->friend_likes;
+}
 
-/** Rows: 8
- ***** Function: userPrintDetailsToFile *****
- * Description: Gets a user and prints its details to a given file.
+/** Rows: 2
+ ***** Function: userGetFavoriteSeries *****
+ * Description: Returns the favorite series of a given user. The array
+ * belongs to the user and should not be changed or freed. It has no
+ * internal iterator, so it can be read by many threads at once.
  *
- * @param current_user - The user which his details will be printed to the
- * file.
- * @param outputStream - A file to print to.
+ * @param user - User to get his favorite series.
  *
  * @return
- * USER_OUT_OF_MEMORY - Any memory error.
- * USER_SUCCESS - Successfully printed.
+ * Array of the user's favorite series, sorted by name.
  */
-UserResult userPrintDetailsToFile(User current_user, FILE *outputStream) {
+OrderedArray userGetFavoriteSeries(User user){
+    assert(user);
+    return user->favorite_series;
+}
 
-    const char *user_details = mtmPrintUser(current_user->username,
-                       current_user->age, current_user->user_friends_list
-                                     ,current_user->user_favorite_series);
-    if (!user_details) {
-        return USER_OUT_OF_MEMORY;
+
+/** Rows: 29
+ ***** Function: userAddFavoriteSeries *****
+ * Description: Adds a series to the favorite series list of a given user
+ * and updates the statistics of the list (genres and durations) and the
+ * liked-by ids of the series.
+ *
+ * @param user - User we want to add the series to.
+ * @param series - Series to add.
+ *
+ * @return
+ * MTMFLIX_SUCCESS - Series added (or already was in the list).
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ */
+MtmFlixResult userAddFavoriteSeries(User user, Series series){
+    assert(user);
+    assert(series);
+    char* series_name = (char*)seriesGetName(series);
+    if(isInUsersFavoriteSeriesList(user,series_name)){
+        /* The series is already counted. */
+        return MTMFLIX_SUCCESS;
+    }
+    if(seriesAddLikedBy(series,user->id)!=SERIES_SUCCESS){
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    if(nameIndexInsert(user->favorite_series_index,
+                       stringPoolRetain(series_name))!=NAME_INDEX_SUCCESS){
+        stringPoolRelease(series_name);
+        seriesRemoveLikedBy(series,user->id);
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    if(orderedArrayInsert(user->favorite_series,series)!=
+       ORDERED_ARRAY_SUCCESS){
+        nameIndexRemove(user->favorite_series_index,series_name);
+        seriesRemoveLikedBy(series,user->id);
+        return MTMFLIX_OUT_OF_MEMORY;
+    }
+    user->genre_count[seriesGetGenre(series)]++;
+    user->favorites_duration_sum+=seriesGetEpisodeDuration(series);
+    user->favorites_count++;
+    user->recommendations_version++;
+    return MTMFLIX_SUCCESS;
+}
+
+/** Rows: 12
+ ***** Function: userRemoveFavoriteSeries *****
+ * Description: Removes a series from the favorite series list of a given
+ * user (if it is there) and updates the statistics of the list and the
+ * liked-by ids of the series.
+ *
+ * @param user - User we want to remove the series from.
+ * @param series - Series to remove.
+ */
+void userRemoveFavoriteSeries(User user, Series series){
+    assert(user);
+    assert(series);
+    char* series_name = (char*)seriesGetName(series);
+    if(!isInUsersFavoriteSeriesList(user,series_name)){
+        return;
+    }
+    orderedArrayRemove(user->favorite_series,series);
+    nameIndexRemove(user->favorite_series_index,series_name);
+    seriesRemoveLikedBy(series,user->id);
+    user->genre_count[seriesGetGenre(series)]--;
+    user->favorites_duration_sum-=seriesGetEpisodeDuration(series);
+    user->favorites_count--;
+    user->recommendations_version++;
+}
+
+/** Rows: 14
+ ***** Function: userGetDetails *****
+ * Description: Returns the details of a user, as they are printed in the
+ * users report. The lists of the names are given by the caller, so one
+ * pair of lists is used for all the users of a report.
+ *
+ * Notice: The string belongs to the mtm library, it is only valid until
+ * the details of another user are taken.
+ *
+ * @param current_user - The user to get his details.
+ * @param users_by_id - Index of all the users in mtmflix by their ids.
+ * Used to get the names of the friends.
+ * @param friends_names - Empty list of borrowed names. Emptied again on
+ * return.
+ * @param series_names - Empty list of borrowed names. Emptied again on
+ * return.
+ *
+ * @return
+ * The details of the user or NULL in case of memory error.
+ */
+const char* userGetDetails(User current_user, IdIndex users_by_id,
+                           List friends_names, List series_names){
+    const char* user_details = NULL;
+    if(userGetDetailsNames(current_user,users_by_id,friends_names,
+                           series_names)==USER_SUCCESS){
+        user_details = mtmPrintUser(current_user->username,
+                                    current_user->age,friends_names,
+                                    series_names);
     }
-    if(fprintf(outputStream, "%s", user_details)<0){
+    listClear(friends_names);
+    listClear(series_names);
+    return user_details;
+}
+
+/** Rows: 14
+ ***** Function: userGetDetailsNames *****
+ * Description: Puts the names mtmPrintUser needs for the details of a
+ * user in the given lists: the names of his friends and the names of his
+ * favorite series, both sorted. Only the user and his friends are read,
+ * so different threads may get the names of users with their own lists.
+ *
+ * @param current_user - The user to get the names of.
+ * @param users_by_id - Index of all the users in mtmflix by their ids.
+ * @param friends_names - Empty list of borrowed names, for the friends.
+ * @param series_names - Empty list of borrowed names, for the series.
+ *
+ * @return
+ * USER_OUT_OF_MEMORY - Any memory error. The lists should be cleared.
+ * USER_SUCCESS - Names put in the lists.
+ */
+UserResult userGetDetailsNames(User current_user, IdIndex users_by_id,
+                               List friends_names, List series_names){
+    assert(current_user && friends_names && series_names);
+    /* The friends and the favorite series are not kept in lists, the lists
+     * of their names are only needed for printing. */
+    if(userAddFriendsNames(current_user,users_by_id,friends_names)!=
+       USER_SUCCESS ||
+       listSort(friends_names,genericStrcmp)!=LIST_SUCCESS ||
+       userAddFavoriteSeriesNames(current_user,series_names)!=
+       USER_SUCCESS){
         return USER_OUT_OF_MEMORY;
     }
     return USER_SUCCESS;
 }
 
+/** Rows: 10
+ ***** Function: userGetSortedFriendsNames *****
+ * Description: Puts the names of the friends of a user in an array,
+ * sorted as mtmPrintUser sorts them. Only the user and his friends are
+ * read, so different threads may get the names of users with their own
+ * arrays.
+ *
+ * @param user - The user to get the names of.
+ * @param users_by_id - Index of all the users in mtmflix by their ids.
+ * @param names - Array with room for the names of all the friends. The
+ * names are borrowed from the friends.
+ *
+ * @return
+ * Number of names put in the array.
+ */
+int userGetSortedFriendsNames(User user, IdIndex users_by_id,
+                              const char** names){
+    assert(user && users_by_id && names);
+    int friends_num = idArrayGetSize(user->friend_ids);
+    for(int i=0;i<friends_num;i++){
+        User friend=idIndexGet(users_by_id,idArrayGet(user->friend_ids,i));
+        assert(friend);
+        names[i] = friend->username;
+    }
+    qsort(names,(size_t)friends_num,sizeof(*names),userCompareNames);
+    return friends_num;
+}
+
+/** Rows: 1
+ ***** Function: userGetAllocationSize *****
+ * Description: Returns the size of the memory of a user. Used to create
+ * the slab the users are allocated from.
+ *
+ * @return
+ * Size in bytes of a user.
+ */
+size_t userGetAllocationSize(){
+    return sizeof(struct user_t);
+}
+
 /** Rows: 1
  ***** Function: userGetAge *****
  * Description: Returns the age of given user.
@@ -266,109 +699,81 @@ int userGetAge (User user){
 }
 
 /** Rows: 5
+ ***** Function: userUnlikeAllFavoriteSeries *****
+ * Description: Removes the id of a given user from the liked-by ids of
+ * every series in his favorite series list. Used before the user is
+ * removed from the mtmflix.
+ *
+ * @param user - User that is being removed.
+ */
+void userUnlikeAllFavoriteSeries(User user){
+    assert(user);
+    for(int i=0;i<orderedArrayGetSize(user->favorite_series);i++){
+        Series series=orderedArrayGet(user->favorite_series,i);
+        seriesRemoveLikedBy(series,user->id);
+    }
+}
+
+/** Rows: 1
  ***** Function: howManyFriendsLovedThisSeries *****
- * Description: Returns how many friends of a given user loves a given
- * series.
+ * Description: Returns how many friends of a user loves a given series.
+ * The friends' ids are intersected with the liked-by ids of the series,
+ * so no favorite list is scanned.
  *
- * @param users_set - Set which contains all users in mtmflix.
- * @param user - A user to check with his friends.
- * @param series_name - A series name to search on friends' favorite lists.
+ * @param friend_ids - Sorted ids of the user's friends (as returned by
+ * userGetFriendIds).
+ * @param series - Series to check.
  *
  * @return
  * The number of friends that loved the given series.
  */
-int howManyFriendsLovedThisSeries(Set users_set, User user,
-                                                        char *series_name){
-    int how_many_loved_this_series=0;
-    LIST_FOREACH(ListElement,friend_name,user->user_friends_list){
-        /*Checks each friend series list */
-        if(friendLikedTheSeries(users_set,(char*)friend_name,series_name)){
-            how_many_loved_this_series++;
-        }
-    }
-    return how_many_loved_this_series;
+int howManyFriendsLovedThisSeries(IdArray friend_ids, Series series){
+    return idArrayIntersectionSize(friend_ids,seriesGetLikedBy(series));
 }
 
-/** Rows: 12
+/** Rows: 2
  ***** Function: userHowManySeriesWithGenre *****
  * Description: Returns the number of series in user's favorite-series-list
  * with the same genre as the given genre.
  *
  * @param user - The user we want to check his favorite-series-list.
  * @param genre - The genre we are looking for.
- * @param series_set - Set of all the series in the mtmflix.
  *
  * @return
- * If succeeded - Number of series with same genre in user's
- * favorite-series-list.
- * If fails - Will return ILLEGAL_VALUE.
- */
-int userHowManySeriesWithGenre(Set series_set, User user, Genre genre){
-    Genre current_genre;
-    int count=0;
-    SeriesResult status;
-    LIST_FOREACH(ListElement,current_series_name,
-                 user->user_favorite_series){
-        current_genre = seriesGetGenreByName((char*)current_series_name,
-                                             series_set,&status);
-        if(status != SERIES_SUCCESS){
-            /* There was an error with seriesGetGenreByName. */
-            return ILLEGAL_VALUE;
-        }
-        if(current_genre == genre){
-            /* Current series has the same genre as the given genre. */
-            count++;
-        }
-    }
-    return count;
+ * Number of series with same genre in user's favorite-series-list.
+ */
+int userHowManySeriesWithGenre(User user, Genre genre){
+    assert(user);
+    return user->genre_count[genre];
 }
 
-/** Rows: 16
+/** Rows: 6
  ***** Function: userGetAverageEpisodeDuration *****
- * Description: Gets a user, a status and a set of all the series in the
- * system. The function returns the average duration of episodes of user's
+ * Description: Returns the average duration of episodes of user's
  * favorite series.
  *
  * @param user - The user we want to check his favorite series for
  * the calulation.
- * @param series_set - Set of all the series in the system.
- * @param function_status - Will hold information of success/failure of the
- * function.
  *
  * @return
- * If succeeded - Average episode duration of all series in user's
- * favorite-series-list.
- * If fails - returns ILLEGAL_VALUE.
- */
-double userGetAverageEpisodeDuration(User user, Set series_set,
-                                     MtmFlixResult* function_status){
-    int episode_duration=0;
-    int number_of_series=0;
-    SeriesResult series_status;
-    LIST_FOREACH(ListElement,current_series_name,
-                 user->user_favorite_series){
-        episode_duration+= seriesGetDurationByName(current_series_name,
-                                                   series_set,
-                                                   &series_status);
-        if(series_status != SERIES_SUCCESS){
-            /* Error in seriesGetDurationByName. */
-            *function_status = MTMFLIX_OUT_OF_MEMORY;
-            return ILLEGAL_VALUE; // This value won't be checked.
-        }
-        number_of_series++;
-    }
-    *function_status = MTMFLIX_SUCCESS;
-    if(number_of_series == 0){
+ * Average episode duration of all series in user's favorite-series-list,
+ * or 0 if the list is empty.
+ */
+double userGetAverageEpisodeDuration(User user){
+    assert(user);
+    if(user->favorites_count == 0){
         /* User doesn't have any series in his favorite list. */
         return 0;
     }
-    return ((double)episode_duration)/((double)number_of_series);
+    return ((double)user->favorites_duration_sum)/
+           ((double)user->favorites_count);
 }
 
-/** Rows: 4
+/** Rows: 2
  ***** Function: isInUsersFavoriteSeriesList *****
  * Description: Returns whether or not a given series name is in given
- * user's favorite series list.
+ * user's favorite series list. The names are also kept in a name index,
+ * so this takes O(1) and does not go over the list.
  *
  * @param user - A user to check in his favorite series list.
  * @param series_name - Series name to check for.
@@ -378,13 +783,8 @@ double userGetAverageEpisodeDuration(User user, Set series_set,
  * False - Series name doesn't exist in given user's favorite series list.
  */
 bool isInUsersFavoriteSeriesList(User user,char* series_name){
-    LIST_FOREACH(ListElement,series,user->user_favorite_series){
-        if(strcmp(series,series_name)==0){
-            /* series is found in user's favorite series list*/
-            return true;
-        }
-    }
-    return false;
+    assert(user);
+    return nameIndexContains(user->favorite_series_index,series_name);
 }
 
 
@@ -392,100 +792,118 @@ bool isInUsersFavoriteSeriesList(User user,char* series_name){
 //                       USER: STATIC FUNCTIONS                          //
 //-----------------------------------------------------------------------//
 
-/** Rows: 11
- ***** Static function: addNameToAList *****
- * Description: Add a given name to a given list.
+/** Rows: 10
+ ***** Static function: userAddFriendsNames *****
+ * Description: Adds the names of the friends of a given user to a list,
+ * in the order of their ids.
  *
- * @param list - List to add to.
- * @param name - Name to add to the given list.
+ * @param user - User to get his friends names.
+ * @param users_by_id - Index of all the users in mtmflix by their ids.
+ * @param names - List to add the names to.
  *
  * @return
- * MTMFLIX_SUCCESS - Successfully added.
- * MTMFLIX_OUT_OF_MEMORY - Any memory error.
- *
+ * USER_OUT_OF_MEMORY - Any memory error.
+ * USER_SUCCESS - Names added.
  */
-static MtmFlixResult addNameToAList(List list, char *name){
-    ListResult result;
-    LIST_FOREACH(ListElement,iterator,list) {
-        if (!strcmp((char*) iterator, name)) {
-            /* The name is already in the list */
-            return MTMFLIX_SUCCESS;
+static UserResult userAddFriendsNames(User user, IdIndex users_by_id,
+                                      List names){
+    for(int i=0;i<idArrayGetSize(user->friend_ids);i++){
+        User friend=idIndexGet(users_by_id,idArrayGet(user->friend_ids,i));
+        assert(friend);
+        if(listInsertLast(names,friend->username)!=LIST_SUCCESS){
+            return USER_OUT_OF_MEMORY;
         }
     }
-    /*If we got here we need to add the name to the list */
-    result=listInsertFirst(list,(ListElement)name);
-    if(result!=LIST_SUCCESS){
-        return MTMFLIX_OUT_OF_MEMORY;
-    }
-    result=listSort(list,genericStrcmp);
-    if(result!=LIST_SUCCESS){
-        return MTMFLIX_OUT_OF_MEMORY;
-    }
-    return MTMFLIX_SUCCESS;
+    return USER_SUCCESS;
 }
 
-/** Rows: 4
- ***** Static function: userRemoveFromList *****
- * Description: remove a given name from a given list.
+/** Rows: 9
+ ***** Static function: userAddFavoriteSeriesNames *****
+ * Description: Adds the names of the favorite series of a given user to a
+ * list, sorted by name, as needed by mtmPrintUser.
  *
- * @param list - List to remove from.
- * @param name - Name to remove from list.
+ * @param user - User to get his favorite series names.
+ * @param names - List to add the names to.
+ *
+ * @return
+ * USER_OUT_OF_MEMORY - Any memory error.
+ * USER_SUCCESS - Names added.
  */
-static void userRemoveFromList(List list, char *name){
-    LIST_FOREACH(ListElement,iterator,list){
-        if(!strcmp((char*)iterator,name)){
-            listRemoveCurrent(list);
-            break;
+static UserResult userAddFavoriteSeriesNames(User user, List names){
+    /* The series are already sorted by name. */
+    for(int i=0;i<orderedArrayGetSize(user->favorite_series);i++){
+        Series series=orderedArrayGet(user->favorite_series,i);
+        if(listInsertLast(names,(ListElement)seriesGetName(series))!=
+           LIST_SUCCESS){
+            return USER_OUT_OF_MEMORY;
         }
     }
+    return USER_SUCCESS;
 }
 
-/** Rows: 9
- ***** Function: friendLikedTheSeries *****
- * Description: searches for the friend in the users list and checks
- * if he liked the series.
- * @param users_set - Set which contains all users in mtmflix.
- * @param friend_name - a friend's name to look in the users set.
- * @param series_name - A series name to search on this friend's list.
+/** Rows: 3
+ ***** Static function: userCompareNames *****
+ * Description: Compares names in an array for qsort, with strcmp.
+ *
+ * @param name1 - Pointer to a name to compare.
+ * @param name2 - Pointer to a name to compare.
+ *
  * @return
- * True if the friend liked the series, else false.
- */
-static bool friendLikedTheSeries(Set users_set, char *friend_name,
-                                 char *series_name){
-    User friend=userCreate(friend_name,MTM_MIN_AGE+1);
-    SET_FOREACH(User,current_user,users_set){
-        /*Searching for the friend in users set */
-        if(userCompare(friend,current_user)==0){
-            /*Found the friend in users list */
-            if(checkIfUserLikedSeries(current_user->user_favorite_series,
-                                      series_name)){
-                userDestroy(friend);
-                return true;
-            }
-        }
-    }
-    /*Should get here */
-    userDestroy(friend);
-    return false;
+ * The result of strcmp on the names.
+ */
+static int userCompareNames(const void* name1, const void* name2){
+    return strcmp(*(const char* const*)name1,*(const char* const*)name2);
 }
 
-/** Rows: 4
- ***** Function: checkIfUserLikedSeries *****
- * @param favorite_series_list - Favorite series list of the friend.
- * @param series_name - A series name to search on this friend's list.
- * @return
- * True if the series is found in this friend's favorite series list,
- * else false.
- */
-static bool checkIfUserLikedSeries (List favorite_series_list,char* series_name){
-    /*Checks if the series exists in friend's favorite series list */
-    LIST_FOREACH(ListElement,friend_series,favorite_series_list){
-        if(strcmp(series_name,(char*)friend_series)==0){
-            return true;
+/** Rows: 13
+ ***** Static function: userCountFriendLikes *****
+ * Description: Counts the favorite series of a new friend in the counts
+ * of a hot user. If the counts could not grow the user stops being hot.
+ * Nothing is done if the user is not hot.
+ *
+ * @param user - User that added the friend.
+ * @param friend - The new friend.
+ */
+static void userCountFriendLikes(User user, User friend){
+    if(!user->friend_likes){
+        return;
+    }
+    for(int i=0;i<orderedArrayGetSize(friend->favorite_series);i++){
+        if(likeCountsIncrease(user->friend_likes,
+                              orderedArrayGet(friend->favorite_series,i))!=
+           LIKE_COUNTS_SUCCESS){
+            userStopBeingHot(user);
+            return;
         }
     }
-    return false;
 }
 
+/** Rows: 8
+ ***** Static function: userUncountFriendLikes *****
+ * Description: Takes the favorite series of a removed friend out of the
+ * counts of a hot user. Nothing is done if the user is not hot.
+ *
+ * @param user - User that removed the friend.
+ * @param friend - The removed friend.
+ */
+static void userUncountFriendLikes(User user, User friend){
+    if(!user->friend_likes){
+        return;
+    }
+    for(int i=0;i<orderedArrayGetSize(friend->favorite_series);i++){
+        likeCountsDecrease(user->friend_likes,
+                           orderedArrayGet(friend->favorite_series,i));
+    }
+}
 
-
+/** Rows: 2
+ ***** Static function: userStopBeingHot *****
+ * Description: Drops the counts of a hot user, so he is not hot anymore.
+ * His recommendations are then made by counting the friends again.
+ *
+ * @param user - User to change.
+ */
+static void userStopBeingHot(User user){
+    likeCountsDestroy(user->friend_likes);
+    user->friend_likes=NULL;
+}
@@ -4,6 +4,11 @@
 #include "set.h"
 #include "series.h"
 #include "utilities.h"
+#include "id_array.h"
+#include "id_index.h"
+#include "slab.h"
+#include "ordered_array.h"
+#include "like_counts.h"
 
 //-----------------------------------------------------------------------//
 //                      USER: TYPEDEFS AND DEFINES                       //
@@ -11,11 +16,6 @@
 
 #define ILLEGAL_VALUE -1
 
-typedef enum {
-    FRIENDS_LIST,
-    FAVORITE_SERIES_LIST
-} UserList;
-
 typedef enum {
     USER_SUCCESS,
     USER_OUT_OF_MEMORY,
@@ -34,17 +34,20 @@ typedef struct user_t* User;
  ***** Function: userCreate *****
  * Description: Creates a new user.
  *
- * @param username - String with the user's name.
+ * @param slab - Slab of users to allocate the user from.
+ * @param username - String with the user's name. Must be interned in the
+ * string pool of the mtmflix, the user takes its own reference to it.
  * @param age - Age of the user.
+ * @param id - Id of the user. Must be unique in the mtmflix.
  *
  * @return
  * A pointer to a new user or NULL in case of memory error or illegal age.
  */
-User userCreate(const char* username, int age);
+User userCreate(Slab slab, char* username, int age, unsigned int id);
 
 /**
  ***** Function: userCopy *****
- * Description: Copies a given user.
+ * Description: Copies a given user from the same slab.
  *
  * @param user - A user to copy.
  *
@@ -75,38 +78,132 @@ void userDestroy (User user);
  */
 int userCompare (User user1, User user2);
 
+/**
+ ***** Function: userGetUsername *****
+ * Description: Returns the username of a given user. The name is not
+ * copied, it belongs to the user and should not be freed. The name is
+ * interned, so it can be compared to other interned names by pointer.
+ *
+ * @param user - User to get its name.
+ *
+ * @return
+ * Username of given user.
+ */
+const char* userGetUsername(User user);
+
+/**
+ ***** Function: userGetId *****
+ * Description: Returns the id of a given user.
+ *
+ * @param user - User to get its id.
+ *
+ * @return
+ * Id of given user.
+ */
+unsigned int userGetId(User user);
+
+/**
+ ***** Function: userFindByName *****
+ * Description: Returns the user with the given username. The lookup does
+ * not allocate memory.
+ *
+ * @param users_index - Index of all the users in the mtmflix.
+ * @param username - Name of the user we look for.
+ *
+ * @return
+ * The user with the given name or NULL if it doesn't exist.
+ */
+User userFindByName(NameIndex users_index, const char* username);
+
 /**
  ***** Function: usernameCopy *****
- * Description: Copying a friend's name.
+ * Description: Copying a friend's name. The name is interned, so it is not
+ * duplicated, only another reference to it is taken.
  *
- * @param username - A friend's name to copy.
+ * @param username - A friend's interned name to copy.
  *
  * @return
- * A copy of the given friend's name.
+ * The same interned name.
  */
 char* usernameCopy(char* user);
 
 /**
  ***** Function: destroyUsername *****
- * Description: Deallocates the memory used for a friend's name.
+ * Description: Releases a reference to a friend's interned name.
  *
  * @param user - A friend's name to destroy.
  */
 void destroyUsername (char* friend_username);
 
 /**
- ***** Function: userPrintDetailsToFile *****
- * Description: Gets a user and prints its details to a given file.
+ ***** Function: userGetDetails *****
+ * Description: Returns the details of a user, as they are printed in the
+ * users report. The lists of the names are given by the caller, so one
+ * pair of lists is used for all the users of a report.
+ *
+ * Notice: The string belongs to the mtm library, it is only valid until
+ * the details of another user are taken.
+ *
+ * @param current_user - The user to get his details.
+ * @param users_by_id - Index of all the users in mtmflix by their ids.
+ * Used to get the names of the friends.
+ * @param friends_names - Empty list of borrowed names. Emptied again on
+ * return.
+ * @param series_names - Empty list of borrowed names. Emptied again on
+ * return.
+ *
+ * @return
+ * The details of the user or NULL in case of memory error.
+ */
+const char* userGetDetails(User current_user, IdIndex users_by_id,
+                           List friends_names, List series_names);
+
+/**
+ ***** Function: userGetDetailsNames *****
+ * Description: Puts the names mtmPrintUser needs for the details of a
+ * user in the given lists: the names of his friends and the names of his
+ * favorite series, both sorted. Only the user and his friends are read,
+ * so different threads may get the names of users with their own lists.
  *
- * @param current_user - The user which his details will be printed to the
- * file.
- * @param outputStream - A file to print to.
+ * @param current_user - The user to get the names of.
+ * @param users_by_id - Index of all the users in mtmflix by their ids.
+ * @param friends_names - Empty list of borrowed names, for the friends.
+ * @param series_names - Empty list of borrowed names, for the series.
  *
  * @return
- * USER_OUT_OF_MEMORY - Any memory error.
- * USER_SUCCESS - Successfully printed.
+ * USER_OUT_OF_MEMORY - Any memory error. The lists should be cleared.
+ * USER_SUCCESS - Names put in the lists.
  */
-UserResult userPrintDetailsToFile(User current_user, FILE *outputStream);
+UserResult userGetDetailsNames(User current_user, IdIndex users_by_id,
+                               List friends_names, List series_names);
+
+/**
+ ***** Function: userGetSortedFriendsNames *****
+ * Description: Puts the names of the friends of a user in an array,
+ * sorted as mtmPrintUser sorts them. Only the user and his friends are
+ * read, so different threads may get the names of users with their own
+ * arrays.
+ *
+ * @param user - The user to get the names of.
+ * @param users_by_id - Index of all the users in mtmflix by their ids.
+ * @param names - Array with room for the names of all the friends. The
+ * names are borrowed from the friends.
+ *
+ * @return
+ * Number of names put in the array.
+ */
+int userGetSortedFriendsNames(User user, IdIndex users_by_id,
+                              const char** names);
+
+/**
+ ***** Function: userGetAllocationSize *****
+ * Description: Returns the size of the memory of a user. Used to create
+ * the slab the users are allocated from.
+ *
+ * @return
+ * Size in bytes of a user.
+ */
+size_t userGetAllocationSize();
 
 /**
  ***** Function: userGetAge *****
@@ -119,90 +216,221 @@ UserResult userPrintDetailsToFile(User current_user, FILE *outputStream);
  */
 int userGetAge (User user);
 
+/**
+ ***** Function: userUnlikeAllFavoriteSeries *****
+ * Description: Removes the id of a given user from the liked-by ids of
+ * every series in his favorite series list. Used before the user is
+ * removed from the mtmflix.
+ *
+ * @param user - User that is being removed.
+ */
+void userUnlikeAllFavoriteSeries(User user);
+
+/**
+ ***** Function: userAddFriend *****
+ * Description: Adds a user to the friends of a given user. The friend
+ * also remembers who added him, so removing him later does not need to
+ * go over all the users. Takes O(log n) to find the places of the ids.
+ * If the user is hot, the favorite series of the friend are counted.
+ *
+ * @param user - User we want to add a friend to.
+ * @param friend - The new friend.
+ *
+ * @return
+ * MTMFLIX_SUCCESS - Friend added (or already was a friend).
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ */
+MtmFlixResult userAddFriend(User user, User friend);
+
+/**
+ ***** Function: userRemoveFriend *****
+ * Description: Removes a user from the friends of a given user (if he is
+ * there). If the user is hot, the favorite series of the friend are not
+ * counted anymore.
+ *
+ * @param user - User we want to remove a friend from.
+ * @param friend - The friend to remove.
+ */
+void userRemoveFriend(User user, User friend);
+
+/**
+ ***** Function: userRemoveAllFriendships *****
+ * Description: Removes a given user from the friends of every user that
+ * has him as a friend, and removes all of his own friends. Only the users
+ * that are connected to him are visited. Used before the user is removed
+ * from the mtmflix.
+ *
+ * @param user - User that is being removed.
+ * @param users_by_id - Index of all the users in mtmflix by their ids.
+ */
+void userRemoveAllFriendships(User user, IdIndex users_by_id);
+
+/**
+ ***** Function: userGetFriendIds *****
+ * Description: Returns the ids of the friends of a given user. The array
+ * belongs to the user and should not be changed or freed.
+ *
+ * @param user - User to get his friends' ids.
+ *
+ * @return
+ * Sorted array of the friends' ids.
+ */
+IdArray userGetFriendIds(User user);
+
+/**
+ ***** Function: userGetRecommendationsVersion *****
+ * Description: Returns the version of the recommendations of a given
+ * user. Recommendations that were made in the same version are still
+ * correct.
+ *
+ * @param user - User to get his version.
+ *
+ * @return
+ * Version of the user's recommendations.
+ */
+unsigned int userGetRecommendationsVersion(User user);
+
+/**
+ ***** Function: userUpdateFollowers *****
+ * Description: Updates the users that have the given user as a friend,
+ * after a series was added to or removed from his favorite series: their
+ * recommendations version is changed, since they rank his favorite
+ * series, and the hot ones count the series again. A hot follower whose
+ * counts could not grow stops being hot.
+ *
+ * @param user - User whose favorite series changed.
+ * @param series - The series that was added or removed.
+ * @param liked - True if the series was added, false if it was removed.
+ * @param users_by_id - Index of all the users in mtmflix by their ids.
+ */
+void userUpdateFollowers(User user, Series series, bool liked,
+                         IdIndex users_by_id);
+
+/**
+ ***** Function: userSetHot *****
+ * Description: Makes a user hot or not. A hot user keeps how many of his
+ * friends love each series, so they are not counted for every
+ * recommendation. Making a user hot counts the favorite series of all of
+ * his friends.
+ *
+ * @param user - User to change.
+ * @param hot - Whether the user should be hot.
+ * @param users_by_id - Index of all the users in mtmflix by their ids.
+ *
+ * @return
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error. The user is not hot.
+ * MTMFLIX_SUCCESS - User changed.
+ */
+MtmFlixResult userSetHot(User user, bool hot, IdIndex users_by_id);
+
+/**
+ ***** Function: userGetFriendLikes *****
+ * Description: Returns how many friends of a hot user love each series.
+ * The counts belong to the user and should not be changed or freed.
+ *
+ * @param user - User to get his counts.
+ *
+ * @return
+ * The counts of the series loved by his friends, or NULL if the user is
+ * not hot.
+ */
+LikeCounts userGetFriendLikes(User user);
+
 /**
  ***** Function: howManyFriendsLovedThisSeries *****
- * Description: Returns how many friends of a given user loves a given
- * series.
+ * Description: Returns how many friends of a user loves a given series.
+ * The friends' ids are intersected with the liked-by ids of the series,
+ * so no favorite list is scanned.
  *
- * @param users_set - Set which contains all users in mtmflix.
- * @param user - A user to check with his friends.
- * @param series_name - A series name to search on friends' favorite lists.
+ * @param friend_ids - Sorted ids of the user's friends (as returned by
+ * userGetFriendIds).
+ * @param series - Series to check.
  *
  * @return
  * The number of friends that loved the given series.
  */
-int howManyFriendsLovedThisSeries(Set users_set, User user,
-                                  char *series_name);
+int howManyFriendsLovedThisSeries(IdArray friend_ids, Series series);
 
 /**
  ***** Function: userHowManySeriesWithGenre *****
  * Description: Returns the number of series in user's favorite-series-list
- * with the same genre as the given genre.
+ * with the same genre as the given genre. Takes O(1).
  *
  * @param user - The user we want to check his favorite-series-list.
  * @param genre - The genre we are looking for.
- * @param series_set - Set of all the series in the mtmflix.
  *
  * @return
- * If succeeded - Number of series with same genre in user's
- * favorite-series-list.
- * If fails - Will return ILLEGAL_VALUE.
+ * Number of series with same genre in user's favorite-series-list.
  */
-int userHowManySeriesWithGenre(Set series_set, User user, Genre genre);
+int userHowManySeriesWithGenre(User user, Genre genre);
 
 /**
  ***** Function: userGetAverageEpisodeDuration *****
- * Description: Gets a user, a status and a set of all the series in the
- * system. The function returns the average duration of episodes of user's
- * favorite series.
+ * Description: Returns the average duration of episodes of user's
+ * favorite series. Takes O(1).
  *
  * @param user - The user we want to check his favorite series for
  * the calulation.
- * @param series_set - Set of all the series in the system.
- * @param function_status - Will hold information of success/failure of the
- * function.
  *
  * @return
- * If succeeded - Average episode duration of all series in user's
- * favorite-series-list.
- * If fails - returns ILLEGAL_VALUE.
+ * Average episode duration of all series in user's favorite-series-list,
+ * or 0 if the list is empty.
  */
-double userGetAverageEpisodeDuration(User user, Set series_set,
-                                     MtmFlixResult* function_status);
+double userGetAverageEpisodeDuration(User user);
 
 /**
- ***** Function: isInUsersFavoriteSeriesList *****
- * Description: Returns whether or not a given series name is in given
- * user's favorite series list.
+ ***** Function: userGetFavoriteSeries *****
+ * Description: Returns the favorite series of a given user. The array
+ * belongs to the user and should not be changed or freed. It has no
+ * internal iterator, so it can be read by many threads at once.
  *
- * @param user - A user to check in his favorite series list.
- * @param series_name - Series name to check for.
+ * @param user - User to get his favorite series.
  *
  * @return
- * True - Series name does exist in given user's favorite series list.
- * False - Series name doesn't exist in given user's favorite series list.
+ * Array of the user's favorite series, sorted by name.
  */
-bool isInUsersFavoriteSeriesList(User user,char* series_name);
+OrderedArray userGetFavoriteSeries(User user);
+
+/**
+ ***** Function: userAddFavoriteSeries *****
+ * Description: Adds a series to the favorite series list of a given user
+ * and updates the statistics of the list (genres and durations) and the
+ * liked-by ids of the series.
+ *
+ * @param user - User we want to add the series to.
+ * @param series - Series to add.
+ *
+ * @return
+ * MTMFLIX_SUCCESS - Series added (or already was in the list).
+ * MTMFLIX_OUT_OF_MEMORY - Any memory error.
+ */
+MtmFlixResult userAddFavoriteSeries(User user, Series series);
 
 /**
- ***** Static function: userRemoveFromList *****
- * Description: remove a given name from a given list.
+ ***** Function: userRemoveFavoriteSeries *****
+ * Description: Removes a series from the favorite series list of a given
+ * user (if it is there) and updates the statistics of the list and the
+ * liked-by ids of the series.
  *
- * @param list - List to remove from.
- * @param name - Name to remove from list.
+ * @param user - User we want to remove the series from.
+ * @param series - Series to remove.
  */
-void removeFromList(User user,char* name,UserList list_type);
+void userRemoveFavoriteSeries(User user, Series series);
 
 /**
- ***** Function: addNameToUsersList *****
- * Description: Adds a given name to a specified list of a given user.
+ ***** Function: isInUsersFavoriteSeriesList *****
+ * Description: Returns whether or not a given series name is in given
+ * user's favorite series list. The names are also kept in a name index,
+ * so this takes O(1) and does not go over the list.
+ *
+ * @param user - A user to check in his favorite series list.
+ * @param series_name - Series name to check for.
  *
- * @param user - User we want to add to one of his lists.
- * @param name - Name we want to add to list.
- * @param list_type - Which of given user's lists to add to.
  * @return
+ * True - Series name does exist in given user's favorite series list.
+ * False - Series name doesn't exist in given user's favorite series list.
  */
-MtmFlixResult addNameToUsersList(User user,char *name,UserList list_type);
+bool isInUsersFavoriteSeriesList(User user,char* series_name);
 
 #endif //MTM_EX3_MTMFLIX_USER_H
 
@@ -11,19 +11,29 @@
 
 
 //-----------------------------------------------------------------------//
-//                       SERIES SET FUNCTIONS                            //
+//                    SERIES ORDERED ARRAY FUNCTIONS                     //
 //-----------------------------------------------------------------------//
 
+int seriesCompareOrderedArrayElements(OrderedArrayElement element1,
+                                      OrderedArrayElement element2){
+    return seriesCompare((Series)element1,(Series)element2);
+}
 
-SetElement seriesCopySetElement(SetElement element){
-    return seriesCopy((Series)element);
+int seriesCompareNamesOrderedArrayElements(OrderedArrayElement element1,
+                                           OrderedArrayElement element2){
+    return strcmp(seriesGetName((Series)element1),
+                  seriesGetName((Series)element2));
 }
 
-int seriesCompareSetElements(SetElement element1, SetElement element2){
-    return seriesCompare((Series)element1,(Series)element2);
+//-----------------------------------------------------------------------//
+//                       SERIES NAME INDEX FUNCTIONS                     //
+//-----------------------------------------------------------------------//
+
+const char* seriesGetNameIndexKey(NameIndexElement element){
+    return seriesGetName((Series)element);
 }
 
-void seriesDestroySetElement(SetElement element){
+void seriesDestroyNameIndexElement(NameIndexElement element){
     seriesDestroy((Series)element);
 }
 
@@ -41,37 +51,36 @@ void destroyFavoriteSeriesName(ListElement element){
 }
 
 //-----------------------------------------------------------------------//
-//                       USERS SET FUNCTIONS                             //
+//                  FAVORITE SERIES NAME INDEX FUNCTIONS                 //
 //-----------------------------------------------------------------------//
 
-SetElement userCopySetElement(SetElement element1){
-    return userCopy((User)element1);
+const char* favoriteSeriesGetNameIndexKey(NameIndexElement element){
+    return (const char*)element;
 }
 
-void userDestroySetElememnt (SetElement element1){
-    userDestroy((User)element1);
+void favoriteSeriesDestroyNameIndexElement(NameIndexElement element){
+    seriesDestroyName((char*)element);
 }
 
-int userCompareSetElements(SetElement element1, SetElement element2){
+//-----------------------------------------------------------------------//
+//                    USERS ORDERED ARRAY FUNCTIONS                      //
+//-----------------------------------------------------------------------//
+
+int userCompareOrderedArrayElements(OrderedArrayElement element1,
+                                    OrderedArrayElement element2){
     return userCompare((User)element1,(User)element2);
 }
 
 //-----------------------------------------------------------------------//
-//                     Ranked series SET FUNCTIONS                       //
+//                       USERS NAME INDEX FUNCTIONS                      //
 //-----------------------------------------------------------------------//
 
-SetElement rankedSeriesCopySetElement(SetElement element1){
-    return rankedSeriesCopy((RankedSeries)element1);
+const char* userGetNameIndexKey(NameIndexElement element){
+    return userGetUsername((User)element);
 }
 
-void rankedSeriesDestroySetElement (SetElement element1){
-     rankedSeriesDestroy((RankedSeries)element1);
-}
-
-int rankedSeriesCompareSetElement(SetElement element1,
-                                  SetElement element2){
-    return rankedSeriesCompare((RankedSeries)element1,
-                               (RankedSeries)element2);
+void userDestroyNameIndexElement(NameIndexElement element){
+    userDestroy((User)element);
 }
 
 //-----------------------------------------------------------------------//
@@ -86,10 +95,22 @@ void destroyFriendUsername(ListElement element){
     destroyUsername((char*)element);
 }
 
+//-----------------------------------------------------------------------//
+//                    BORROWED NAMES LIST FUNCTIONS                      //
+//-----------------------------------------------------------------------//
+
+ListElement copyBorrowedName(ListElement element){
+    return element;
+}
+
+void destroyBorrowedName(ListElement element){
+    (void)element;
+}
+
 //-----------------------------------------------------------------------//
 //                       GENERIC FUNCTIONS                               //
 //-----------------------------------------------------------------------//
 
 int genericStrcmp (ListElement element1,ListElement element2){
     return strcmp((char*)element1,(char*)element2);
-}
\ No newline at end of file
+}
@@ -10,6 +10,9 @@
 #include "mtmflix.h"
 #include "mtm_ex3.h"
 #include "ranked_series.h"
+#include "name_index.h"
+#include "ordered_array.h"
+#include "id_marks.h"
 
 //-----------------------------------------------------------------------//
 //                            DESCIPTION                                 //
@@ -22,12 +25,20 @@
 
 
 //-----------------------------------------------------------------------//
-//                       SERIES SET FUNCTIONS                            //
+//                    SERIES ORDERED ARRAY FUNCTIONS                     //
 //-----------------------------------------------------------------------//
 
-SetElement seriesCopySetElement(SetElement element);
-void seriesDestroySetElement(SetElement element);
-int seriesCompareSetElements(SetElement element1, SetElement element2);
+int seriesCompareOrderedArrayElements(OrderedArrayElement element1,
+                                      OrderedArrayElement element2);
+int seriesCompareNamesOrderedArrayElements(OrderedArrayElement element1,
+                                           OrderedArrayElement element2);
+
+//-----------------------------------------------------------------------//
+//                       SERIES NAME INDEX FUNCTIONS                     //
+//-----------------------------------------------------------------------//
+
+const char* seriesGetNameIndexKey(NameIndexElement element);
+void seriesDestroyNameIndexElement(NameIndexElement element);
 
 //-----------------------------------------------------------------------//
 //                       SERIES LIST FUNCTIONS                           //
@@ -37,21 +48,25 @@ ListElement copyFavoriteSeriesName(ListElement element);
 void destroyFavoriteSeriesName(ListElement element);
 
 //-----------------------------------------------------------------------//
-//                       USERS SET FUNCTIONS                             //
+//                  FAVORITE SERIES NAME INDEX FUNCTIONS                 //
 //-----------------------------------------------------------------------//
 
-SetElement userCopySetElement(SetElement element1);
-void userDestroySetElememnt(SetElement element1);
-int userCompareSetElements(SetElement element1, SetElement element2);
+const char* favoriteSeriesGetNameIndexKey(NameIndexElement element);
+void favoriteSeriesDestroyNameIndexElement(NameIndexElement element);
 
 //-----------------------------------------------------------------------//
-//                       Ranked series SET FUNCTIONS                     //
+//                    USERS ORDERED ARRAY FUNCTIONS                      //
 //-----------------------------------------------------------------------//
 
-SetElement rankedSeriesCopySetElement(SetElement element1);
-void rankedSeriesDestroySetElement(SetElement element1);
-int rankedSeriesCompareSetElement(SetElement element1, SetElement element2);
+int userCompareOrderedArrayElements(OrderedArrayElement element1,
+                                    OrderedArrayElement element2);
+
+//-----------------------------------------------------------------------//
+//                       USERS NAME INDEX FUNCTIONS                      //
+//-----------------------------------------------------------------------//
 
+const char* userGetNameIndexKey(NameIndexElement element);
+void userDestroyNameIndexElement(NameIndexElement element);
 
 //-----------------------------------------------------------------------//
 //                       USERS LIST FUNCTIONS                            //
@@ -59,6 +74,17 @@ int rankedSeriesCompareSetElement(SetElement element1, SetElement element2);
 
 ListElement copyFriendUsername (ListElement element);
 void destroyFriendUsername(ListElement element);
+
+//-----------------------------------------------------------------------//
+//                    BORROWED NAMES LIST FUNCTIONS                      //
+//-----------------------------------------------------------------------//
+
+/* For lists of names that live longer than the list, like the names in a
+ * report. The names are not retained, so such lists may be filled by
+ * several threads at once. */
+ListElement copyBorrowedName(ListElement element);
+void destroyBorrowedName(ListElement element);
+
 //-----------------------------------------------------------------------//
 //                       GENERIC FUNCTIONS                               //
 //-----------------------------------------------------------------------//